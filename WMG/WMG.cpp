@@ -6,11 +6,17 @@
 
 
 #include <stdio.h>
-#include <math.h> // cos, sin
+#include <string.h> // memcmp, memcpy
+#include <fcntl.h> // open
+#include <unistd.h> // close
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+#include <math.h> // cos, sin, HUGE_VAL
 
 
 #include "WMG.h"
 #include "footstep.h"
+#include "feet_phase.h"
 
 WMG::WMG (
         const unsigned int N_,
@@ -58,6 +64,22 @@ WMG::WMG (
     bezier_weight_2 = bezier_weight_2_;
     bezier_inclination_1 = bezier_inclination_1_;
     bezier_inclination_2 = bezier_inclination_2_;
+
+    incremental_preview_window = false;
+    window_valid = false;
+    window_par = NULL;
+    window_tail_step = 0;
+    window_tail_time_left = 0;
+
+    footsteps_version = 0;
+    preview_window_time_ms = 0;
+
+    footstep_queue = NULL;
+    retired_footsteps = 0;
+
+    offset_x = 0.0;
+    offset_y = 0.0;
+    offset_start = 0;
 }
 
 
@@ -66,7 +88,7 @@ WMG::~WMG()
 {
     if (T_ms != NULL)
     {
-        delete T_ms;
+        delete [] T_ms;
     }
 }
 
@@ -99,6 +121,184 @@ void WMG::setFootstepParametersMS(
 }
 
 
+void WMG::addFootsteps (
+        const unsigned int num,
+        const footstepQueue::request *steps)
+{
+    unsigned int first_step = 0;
+
+    // the first footstep defines the origin
+    if ((FS.size() == 0) && (num > 0))
+    {
+        setFootstepParametersMS (
+                steps[0].def_time_ms, 
+                steps[0].ds_time_ms, 
+                steps[0].ds_number, 
+                steps[0].use_user_constraints);
+        addFootstep (steps[0].x_relative, steps[0].y_relative, steps[0].angle_relative, steps[0].type);
+        first_step = 1;
+    }
+    if (first_step == num)
+    {
+        return;
+    }
+
+    const int num_steps = num - first_step;
+    const footstepQueue::request *new_steps = &steps[first_step];
+    const unsigned int old_size = FS.size();
+
+    ++footsteps_version;
+
+
+    // types of the steps and their positions in FS
+    std::vector<fs_type> types (num_steps);
+    std::vector<unsigned int> first_ind (num_steps + 1);
+
+    const int prev_ss = getPrevSS(old_size);
+    fs_type prev_ss_type = (prev_ss < 0) ? FS_TYPE_DS : FS[prev_ss].type;
+    first_ind[0] = old_size;
+    for (int k = 0; k < num_steps; ++k)
+    {
+        types[k] = new_steps[k].type;
+        if (types[k] == FS_TYPE_AUTO)
+        {
+            types[k] = (prev_ss_type == FS_TYPE_SS_R) ? FS_TYPE_SS_L : FS_TYPE_SS_R;
+        }
+        if (types[k] != FS_TYPE_DS)
+        {
+            prev_ss_type = types[k];
+        }
+        first_ind[k+1] = first_ind[k] + new_steps[k].ds_number + 1;
+    }
+
+
+    // positions of the steps relative to the last footstep
+    std::vector<double> abs_steps (3*num_steps);
+    scanRelativeSteps (num_steps, new_steps, &abs_steps[0]);
+
+
+    const Transform<double, 3> base_posture = FS.back().getPosture();
+    const double base_angle = FS.back().angle;
+    const Vector3d base_zref = FS.back().ZMPref;
+
+    FS.resize(first_ind[num_steps], FS.back());
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int k = 0; k < num_steps; ++k)
+    {
+        const footstepQueue::request &step = new_steps[k];
+        const double *constraints;
+        const double *constraints_auto_ds;
+
+        getFootstepConstraints (types[k], step.use_user_constraints, constraints, constraints_auto_ds);
+
+
+        Transform<double, 3> posture = base_posture
+            * Translation<double, 3>(abs_steps[k*3], abs_steps[k*3 + 1], 0.0)
+            * AngleAxisd(abs_steps[k*3 + 2], Vector3d::UnitZ());
+        Vector3d zref_offset ((constraints[0] - constraints[2])/2, 0.0, 0.0);
+        Vector3d next_zref = posture * zref_offset;
+
+
+        // the previous step
+        Transform<double, 3> ds_posture = base_posture;
+        double ds_angle = base_angle;
+        Vector3d ds_zref = base_zref;
+        if (k > 0)
+        {
+            const double *prev_constraints;
+            const double *prev_constraints_auto_ds;
+
+            getFootstepConstraints (
+                    types[k-1], new_steps[k-1].use_user_constraints, 
+                    prev_constraints, prev_constraints_auto_ds);
+
+            ds_posture = base_posture
+                * Translation<double, 3>(abs_steps[(k-1)*3], abs_steps[(k-1)*3 + 1], 0.0)
+                * AngleAxisd(abs_steps[(k-1)*3 + 2], Vector3d::UnitZ());
+            ds_angle = base_angle + abs_steps[(k-1)*3 + 2];
+            ds_zref = ds_posture * Vector3d((prev_constraints[0] - prev_constraints[2])/2, 0.0, 0.0);
+        }
+
+
+        // double supports, see addFootstep()
+        double theta = (double) 1/(step.ds_number + 1);
+        double angle_shift = step.angle_relative * theta;
+        Transform<double, 3> ds_shift = Translation<double, 3>(theta*step.x_relative, theta*step.y_relative, 0.0)
+            * AngleAxisd(angle_shift, Vector3d::UnitZ());
+        for (unsigned int i = 0; i < step.ds_number; i++)
+        {
+            ds_posture = ds_posture * ds_shift;
+            ds_angle += angle_shift;
+
+            if (i == step.ds_number / 2)
+            {
+                ds_zref = next_zref;
+            }
+
+            FS[first_ind[k] + i] = 
+                footstep(
+                    ds_angle,
+                    ds_posture,
+                    ds_zref,
+                    step.ds_time_ms, 
+                    FS_TYPE_DS,
+                    constraints_auto_ds);
+        }
+
+
+        FS[first_ind[k+1] - 1] = 
+            footstep(
+                base_angle + abs_steps[k*3 + 2], 
+                posture, 
+                next_zref,
+                step.def_time_ms, 
+                types[k],
+                constraints);
+    }
+
+
+    const footstepQueue::request &last_step = new_steps[num_steps - 1];
+    setFootstepParametersMS (
+            last_step.def_time_ms, 
+            last_step.ds_time_ms, 
+            last_step.ds_number, 
+            last_step.use_user_constraints);
+
+    // see addFootstep()
+    if (offset_start == SS_index.size())
+    {
+        offset_start = FS.size();
+    }
+
+    for (unsigned int i = SS_index.size(); i < FS.size(); ++i)
+    {
+        indexFootstep(i);
+    }
+}
+
+
+void WMG::reserveFootsteps (const unsigned int num_steps)
+{
+    FS.reserve(num_steps);
+    SS_index.reserve(num_steps);
+}
+
+
+unsigned int WMG::getNumFootsteps () const
+{
+    return (FS.size());
+}
+
+
+fs_type WMG::getCurrentSupportType () const
+{
+    return (FS[first_preview_step].type);
+}
+
+
 void WMG::addFootstep(
         const double x_relative, 
         const double y_relative, 
@@ -108,6 +308,8 @@ void WMG::addFootstep(
     const double *constraints;
     const double *constraints_auto_ds;
 
+    ++footsteps_version;
+
     // determine type of the step
     if (type == FS_TYPE_AUTO)
     {
@@ -131,28 +333,7 @@ void WMG::addFootstep(
         }
     }
 
-    if (use_user_constraints)
-    {
-        constraints = user_constraints;
-        constraints_auto_ds = user_constraints_auto_ds;
-    }
-    else
-    {
-        constraints_auto_ds = def_constraints.auto_ds;
-        switch (type)
-        {
-            case FS_TYPE_SS_R:
-                constraints = def_constraints.ss_right;
-                break;
-            case FS_TYPE_SS_L:
-                constraints = def_constraints.ss_left;
-                break;
-            case FS_TYPE_DS:
-            default:
-                constraints = def_constraints.ds;
-                break;
-        }
-    }
+    getFootstepConstraints (type, use_user_constraints, constraints, constraints_auto_ds);
 
 
     Transform<double, 3>    posture (Translation<double, 3>(x_relative, y_relative, 0.0));
@@ -177,7 +358,7 @@ void WMG::addFootstep(
     else
     {
         // Position of the next step
-        posture = (*FS.back().posture) * posture * AngleAxisd(angle_relative, Vector3d::UnitZ());
+        posture = FS.back().getPosture() * posture * AngleAxisd(angle_relative, Vector3d::UnitZ());
 
         double prev_a = FS.back().angle;
         double next_a = prev_a + angle_relative;
@@ -190,23 +371,24 @@ void WMG::addFootstep(
         double angle_shift = angle_relative * theta;
         double x_shift = theta*x_relative;
         double y_shift = theta*y_relative;
-        Vector3d *ds_zref = &FS.back().ZMPref;
+        // copied, since the storage may be reallocated by push_back()
+        Vector3d ds_zref = FS.back().ZMPref;
         for (unsigned int i = 0; i < ds_num; i++)
         {
-            Transform<double, 3> ds_posture = (*FS.back().posture) 
+            Transform<double, 3> ds_posture = FS.back().getPosture() 
                        * Translation<double, 3>(x_shift, y_shift, 0.0)
                        * AngleAxisd(angle_shift, Vector3d::UnitZ());
 
             if (i == ds_num / 2)
             {
-                ds_zref = &next_zref;
+                ds_zref = next_zref;
             }
 
             FS.push_back(
                     footstep(
                         FS.back().angle + angle_shift,
                         ds_posture,
-                        *ds_zref,
+                        ds_zref,
                         ds_time_ms, 
                         FS_TYPE_DS,
                         constraints_auto_ds));
@@ -223,6 +405,18 @@ void WMG::addFootstep(
                     type,
                     constraints));
     }    
+
+    // the new footsteps are positioned relative to the last footstep, so
+    // they need the offset only if it is needed by the last footstep.
+    if (offset_start == SS_index.size())
+    {
+        offset_start = FS.size();
+    }
+
+    for (unsigned int i = SS_index.size(); i < FS.size(); ++i)
+    {
+        indexFootstep(i);
+    }
 }
 
 
@@ -232,40 +426,106 @@ void WMG::getFeetPositions (
         double *left_foot_pos,
         double *right_foot_pos)
 {
-    unsigned int support_number = first_preview_step;
-    // formPreviewWindow() have already decremented the time
-    unsigned int step_time_left = FS[support_number].time_left + last_time_decrement;
-    unsigned int shift_ms = shift_from_current_ms;
+    getFeetPositions (1, &shift_from_current_ms, left_foot_pos, right_foot_pos);
+}
+
+
+
+void WMG::getFeetPositions (
+        const unsigned int num,
+        const unsigned int *shift_from_current_ms,
+        double *left_foot_pos,
+        double *right_foot_pos,
+        const bool compact)
+{
+    const unsigned int stride = compact ? 4 : 16;
+    feetPhase phase;
+    phase.support_number = -1;
+
+    unsigned int support_number = 0;
+    unsigned int support_start_ms = 0;
 
+    // samples in the same support, which are evaluated together
+    double theta[FEET_PHASE_BLOCK_SIZE];
+    unsigned int first_sample = 0;
+    unsigned int num_samples = 0;
 
-    while (shift_ms > step_time_left)
+
+    for (unsigned int i = 0; i < num; ++i)
     {
-        shift_ms -= step_time_left;
-        ++support_number;
-        if (support_number >= FS.size())
+        const unsigned int time_ms = preview_window_time_ms + shift_from_current_ms[i];
+        if (!findSupport (time_ms, i == 0, support_number, support_start_ms))
+        {
+            break;
+        }
+
+
+        if ((num_samples > 0) 
+                && ((phase.support_number != (int) support_number) 
+                    || (num_samples == FEET_PHASE_BLOCK_SIZE)))
         {
-            return;
+            phase.evaluate (
+                    num_samples, theta, 
+                    &left_foot_pos[first_sample*stride], 
+                    &right_foot_pos[first_sample*stride], 
+                    compact);
+            num_samples = 0;
         }
-        step_time_left = FS[support_number].time_left;
+
+        if (phase.support_number != (int) support_number)
+        {
+            prepareFeetPhase (support_number, phase);
+        }
+
+        if (num_samples == 0)
+        {
+            first_sample = i;
+        }
+        theta[num_samples] = getSupportPhase (time_ms, support_number, support_start_ms);
+        ++num_samples;
     }
 
 
-    if (FS[support_number].type == FS_TYPE_DS)
+    if (num_samples > 0)
     {
-        getDSFeetPositions (support_number, left_foot_pos, right_foot_pos);
+        phase.evaluate (
+                num_samples, theta, 
+                &left_foot_pos[first_sample*stride], 
+                &right_foot_pos[first_sample*stride], 
+                compact);
     }
-    else
+}
+
+
+
+void WMG::getFeetPositions (
+        feetCursor &cursor,
+        const unsigned int shift_from_current_ms,
+        double *left_foot_pos,
+        double *right_foot_pos,
+        const bool compact)
+{
+    const unsigned int time_ms = preview_window_time_ms + shift_from_current_ms;
+    const bool reset = (cursor.footsteps_version != footsteps_version);
+
+    if (reset)
+    {
+        cursor.footsteps_version = footsteps_version;
+        cursor.phase->support_number = -1;
+    }
+
+    if (!findSupport (time_ms, reset, cursor.support_number, cursor.support_start_ms))
     {
-        double theta = (double) 
-            ((FS[support_number].time_period - step_time_left) + shift_ms) 
-            / FS[support_number].time_period;
+        return;
+    }
 
-        getSSFeetPositionsBezier (
-                support_number,
-                theta,
-                left_foot_pos, 
-                right_foot_pos);
+    if (cursor.phase->support_number != (int) cursor.support_number)
+    {
+        prepareFeetPhase (cursor.support_number, *cursor.phase);
     }
+
+    const double theta = getSupportPhase (time_ms, cursor.support_number, cursor.support_start_ms);
+    cursor.phase->evaluate (1, &theta, left_foot_pos, right_foot_pos, compact);
 }
 
 
@@ -282,7 +542,7 @@ bool WMG::isSupportSwitchNeeded ()
     else // single support
     {
         if (// if we are not in the initial support
-            (current_step_number != 0) &&
+            (current_step_number + retired_footsteps != 0) &&
             // this is the first iteration in SS
             (FS[current_step_number].time_period == FS[current_step_number].time_left) &&
             // the previous SS was different
@@ -299,7 +559,13 @@ bool WMG::isSupportSwitchNeeded ()
 
 void WMG::changeNextSSPosition (const double* posture, const bool zero_z_coordinate)
 {
-    FS[getNextSS(first_preview_step)].changePosture(posture, zero_z_coordinate);
+    window_valid = false;
+    ++footsteps_version;
+
+    const int next_ss = getNextSS(first_preview_step);
+    // the new posture is absolute
+    applyOffset (next_ss + 1);
+    FS[next_ss].changePosture(posture, zero_z_coordinate);
 }
 
 
@@ -308,6 +574,8 @@ void WMG::repositionFootsteps (const double diff_x, const double diff_y)
     int ind = 0;
     fs_type fixed_fs_type;
     
+    window_valid = false;
+    ++footsteps_version;
 
     ind = first_preview_step;
     if (FS[first_preview_step].type == FS_TYPE_DS)
@@ -318,90 +586,76 @@ void WMG::repositionFootsteps (const double diff_x, const double diff_y)
 
     for (; (ind < (int) FS.size()) && (FS[ind].type != fixed_fs_type); ++ind);
 
-    Translation<double, 3>  diff(diff_x, diff_y, 0.0);
-   
-    for (; ind < (int) FS.size(); ++ind)
+    // the preceding footsteps get only the old offset
+    applyOffset (ind);
+
+    // the footsteps, which have already been used, are translated now, the
+    // others later.
+    for (; ind < (int) offset_start; ++ind)
     {
-        *FS[ind].posture = diff * (*FS[ind].posture);
-        FS[ind].rotate_translate(FS[ind].ca, FS[ind].sa, FS[ind].x(), FS[ind].y());
+        FS[ind].translate(diff_x, diff_y);
+    }
+    if (offset_start < FS.size())
+    {
+        offset_x += diff_x;
+        offset_y += diff_y;
     }
 }
 
 
 WMGret WMG::formPreviewWindow(smpc_parameters & par)
 {
-    WMGret retval = WMG_OK;
-    unsigned int win_step_num = current_step_number;
-    unsigned int step_time_left = FS[win_step_num].time_left;
+    WMGret retval;
+    const unsigned int previous_time_decrement = last_time_decrement;
 
+    if (footstep_queue != NULL)
+    {
+        pullFootsteps();
+    }
 
-    for (unsigned int i = 0; i < N;)
+    if (incremental_preview_window && window_valid && (window_par == &par))
     {
-        if (step_time_left > 0)
+        retval = shiftPreviewWindow (par);
+    }
+    else
+    {
+        if (incremental_preview_window)
         {
-            par.angle[i] = FS[win_step_num].angle;
-
-            par.fp_x[i] = FS[win_step_num].x();
-            par.fp_y[i] = FS[win_step_num].y();
-
-
-            // ZMP reference coordinates
-            par.zref_x[i] = FS[win_step_num].ZMPref.x();
-            par.zref_y[i] = FS[win_step_num].ZMPref.y();
-
-
-            par.lb[i*2] = -FS[win_step_num].d[2];
-            par.ub[i*2] = FS[win_step_num].d[0];
+            par.resetWindow();
+        }
 
-            par.lb[i*2 + 1] = -FS[win_step_num].d[3];
-            par.ub[i*2 + 1] = FS[win_step_num].d[1];
+        retval = formPreviewWindow (
+                par, -1, NULL, 
+                last_time_decrement, window_tail_step, window_tail_time_left);
 
+        window_valid = false;
+        if (incremental_preview_window && (retval == WMG_OK))
+        {
+            par.mirrorWindow(0);
+            window_par = &par;
 
-            unsigned int step_len_ms;
-            if (T_ms[i] == 0)
+            window_valid = true;
+            for (unsigned int i = 0; i < N; ++i)
             {
-                if (sampling_period > step_time_left) 
+                if (T_ms[i] != 0)
                 {
-                    step_len_ms = step_time_left;
-                }
-                else
-                {
-                    step_len_ms = sampling_period;
-                }
-            }
-            else
-            {
-                if (T_ms[i] > step_time_left) 
-                {
-                    retval = WMG_HALT;
+                    window_valid = false;
                     break;
                 }
-                step_len_ms = T_ms[i];
-            }
-            par.T[i] = (double) step_len_ms / 1000;
-            step_time_left -= step_len_ms;
-
-            if (i == 0)
-            {
-                last_time_decrement = step_len_ms;
-            }
-            i++;
-        }
-        else
-        {
-            win_step_num++;
-            if (win_step_num == FS.size())
-            {
-                retval = WMG_HALT;
-                break;
             }
-            step_time_left = FS[win_step_num].time_left;
         }
     }
 
+    if (retval != WMG_OK)
+    {
+        window_valid = false;
+    }
 
     if (retval == WMG_OK)
     {
+        preview_window_time_ms += previous_time_decrement;
+        applyOffset (window_tail_step + 1);
+
         while (FS[current_step_number].time_left == 0)
         {
             current_step_number++;
@@ -413,6 +667,11 @@ WMGret WMG::formPreviewWindow(smpc_parameters & par)
         {
             current_step_number++;
         }
+
+        if (footstep_queue != NULL)
+        {
+            retireFootsteps();
+        }
     }
 
     return (retval);
@@ -420,8 +679,70 @@ WMGret WMG::formPreviewWindow(smpc_parameters & par)
 
 
 
+WMGret WMG::evaluateNextSSCandidates (
+        nextSSCandidates &candidates,
+        smpc::solver **solvers,
+        const double *postures,
+        const bool zero_z_coordinate,
+        const smpc::state_com &init_state) const
+{
+    const int next_ss = getNextSS(first_preview_step);
+    const int num = candidates.num;
+    int num_halted = 0;
+
+
+    if (num == 0)
+    {
+        return (WMG_OK);
+    }
+    if (next_ss >= (int) FS.size())
+    {
+        for (int i = 0; i < num; ++i)
+        {
+            candidates.objective[i] = HUGE_VAL;
+        }
+        return (WMG_HALT);
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(+:num_halted)
+#endif
+    for (int i = 0; i < num; ++i)
+    {
+        smpc_parameters &par = *candidates.par[i];
+        unsigned int candidate_time_decrement = 0;
+        unsigned int candidate_tail_step = 0;
+        unsigned int candidate_tail_time_left = 0;
+
+        *candidates.candidate_fs[i] = FS[next_ss];
+        candidates.candidate_fs[i]->changePosture(&postures[i*16], zero_z_coordinate);
+        if (formPreviewWindow (
+                    par, next_ss, candidates.candidate_fs[i], 
+                    candidate_time_decrement, candidate_tail_step, candidate_tail_time_left) == WMG_HALT)
+        {
+            candidates.objective[i] = HUGE_VAL;
+            ++num_halted;
+            continue;
+        }
+
+        solvers[i]->set_parameters (par.T, par.h, par.h0, par.angle, par.zref_x, par.zref_y, par.lb, par.ub);
+        solvers[i]->form_init_fp (par.fp_x, par.fp_y, init_state, par.X);
+        solvers[i]->solve();
+
+        candidates.objective[i] = solvers[i]->get_objective();
+        solvers[i]->get_first_controls (candidates.first_controls[i]);
+    }
+
+    // the lengths of sampling intervals do not depend on the positions of
+    // footsteps, hence the window is either formed for all candidates or
+    // for none of them.
+    return ((num_halted == 0) ? WMG_OK : WMG_HALT);
+}
+
+
+
 void WMG::FS2file(const std::string filename, const bool plot_ds)
 {
+    applyOffset (FS.size());
     
     FILE *file_op = fopen(filename.c_str(), "w");
     
@@ -451,12 +772,14 @@ void WMG::FS2file(const std::string filename, const bool plot_ds)
                          FS[i].D[2], FS[i].D[6],
                          FS[i].D[3], FS[i].D[7]); 
 
+            double vert[4*2];
+            FS[i].Constraints2Vert(vert);
             fprintf(file_op, "FS(%i).v = [%f %f; %f %f; %f %f; %f %f; %f %f];\n", 
-                    i+1, FS[i].vert(0,0), FS[i].vert(0,1), 
-                         FS[i].vert(1,0), FS[i].vert(1,1), 
-                         FS[i].vert(2,0), FS[i].vert(2,1), 
-                         FS[i].vert(3,0), FS[i].vert(3,1), 
-                         FS[i].vert(0,0), FS[i].vert(0,1));
+                    i+1, vert[0], vert[1], 
+                         vert[2], vert[3], 
+                         vert[4], vert[5], 
+                         vert[6], vert[7], 
+                         vert[0], vert[1]);
 
             if (FS[i].type == FS_TYPE_DS)
             {
@@ -500,3 +823,108 @@ void WMG::getFootsteps(
         }
     }
 }
+
+
+
+bool WMG::savePlan (const std::string filename) const
+{
+    FILE *file_op = fopen(filename.c_str(), "wb");
+
+    if(!file_op)
+    {
+        fprintf(stderr, "Cannot open file (for writing)\n");
+        return (false);
+    }
+
+    planHeader header;
+    memcpy (header.magic, "WMGP", 4);
+    header.version = WMG_PLAN_VERSION;
+    header.record_size = sizeof(footstepRecord);
+    header.num_footsteps = FS.size();
+
+    bool result = (fwrite (&header, sizeof(header), 1, file_op) == 1);
+    for (unsigned int i = 0; result && (i < FS.size()); ++i)
+    {
+        footstepRecord record;
+        if (i < offset_start)
+        {
+            FS[i].toRecord(record);
+        }
+        else
+        {
+            footstep translated_fs (FS[i]);
+            translated_fs.translate(offset_x, offset_y);
+            translated_fs.toRecord(record);
+        }
+        result = (fwrite (&record, sizeof(record), 1, file_op) == 1);
+    }
+
+    if (fclose(file_op) != 0)
+    {
+        result = false;
+    }
+    return (result);
+}
+
+
+
+bool WMG::loadPlan (const std::string filename)
+{
+    int fd = open (filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        fprintf(stderr, "Cannot open file (for reading)\n");
+        return (false);
+    }
+
+    struct stat file_stat;
+    if ((fstat (fd, &file_stat) != 0) || (file_stat.st_size < (off_t) sizeof(planHeader)))
+    {
+        close (fd);
+        return (false);
+    }
+
+    void *data = mmap (NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (data == MAP_FAILED)
+    {
+        return (false);
+    }
+
+
+    const planHeader *header = (const planHeader *) data;
+    const footstepRecord *records = (const footstepRecord *) (header + 1);
+    const bool valid = 
+        (memcmp (header->magic, "WMGP", 4) == 0)
+        && (header->version == WMG_PLAN_VERSION)
+        && (header->record_size == sizeof(footstepRecord))
+        && ((size_t) file_stat.st_size == sizeof(planHeader) + header->num_footsteps * sizeof(footstepRecord));
+
+    if (valid)
+    {
+        FS.clear();
+        SS_index.clear();
+        FS.reserve(header->num_footsteps);
+        SS_index.reserve(header->num_footsteps);
+        for (unsigned int i = 0; i < header->num_footsteps; ++i)
+        {
+            FS.push_back (footstep (records[i]));
+            indexFootstep(i);
+        }
+
+        current_step_number = 0;
+        first_preview_step = 0;
+        last_time_decrement = 0;
+        preview_window_time_ms = 0;
+        retired_footsteps = 0;
+        offset_x = 0.0;
+        offset_y = 0.0;
+        offset_start = FS.size();
+        window_valid = false;
+        ++footsteps_version;
+        footstep_queue = NULL;
+    }
+
+    munmap (data, file_stat.st_size);
+    return (valid);
+}
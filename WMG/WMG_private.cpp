@@ -3,10 +3,11 @@
  * @author Alexander Sherikov
  */
 
-#include <cmath> // sqrt
+#include <cmath> // sqrt, sin, cos
 
 #include "WMG.h"
 #include "footstep.h"
+#include "feet_phase.h"
 
 
 
@@ -20,24 +21,15 @@
  *
  * @return index of the next SS.
  */
-int WMG::getNextSS(const int start_ind, const fs_type type)
+int WMG::getNextSS(const int start_ind, const fs_type type) const
 {
     int index = start_ind + 1;
-    for (; index < (int) FS.size(); index++) 
+    if ((index >= 0) && (index < (int) FS.size()))
     {
-        if (FS[index].type != FS_TYPE_DS)
+        index = SS_index[index].next[type];
+        if (index < 0)
         {
-            if (type == FS_TYPE_AUTO)
-            {
-                break;
-            }
-            else
-            {
-                if (FS[index].type == type)
-                {
-                    break;
-                }
-            }
+            index = FS.size();
         }
     }
     return (index);
@@ -55,58 +47,520 @@ int WMG::getNextSS(const int start_ind, const fs_type type)
  *
  * @return index of the previous SS.
  */
-int WMG::getPrevSS(const int start_ind, const fs_type type)
+int WMG::getPrevSS(const int start_ind, const fs_type type) const
 {
     int index = start_ind - 1;
-    for (; index >= 0; index--)
+    if ((index >= 0) && (index < (int) FS.size()))
+    {
+        index = SS_index[index].prev[type];
+    }
+    return (index);
+}
+
+
+
+/**
+ * @brief Adds a footstep to the index of single supports, which is used
+ * by #getNextSS and #getPrevSS. The footsteps must be indexed in the order
+ * of their addition, the total cost of indexing is linear in the number of
+ * footsteps.
+ *
+ * @param[in] ind index of the footstep in #FS, must be equal to the number
+ *  of already indexed footsteps.
+ */
+void WMG::indexFootstep(const unsigned int ind)
+{
+    support_index entry;
+    for (int t = FS_TYPE_AUTO; t <= FS_TYPE_SS_R; ++t)
+    {
+        entry.next[t] = -1;
+        entry.prev[t] = (ind > 0) ? SS_index[ind-1].prev[t] : -1;
+    }
+    SS_index.push_back(entry);
+
+    if (FS[ind].type != FS_TYPE_DS)
     {
-        if (FS[index].type != FS_TYPE_DS)
+        const int types[2] = {FS_TYPE_AUTO, FS[ind].type};
+        for (int k = 0; k < 2; ++k)
         {
-            if (type == FS_TYPE_AUTO)
+            const int t = types[k];
+            SS_index[ind].prev[t] = ind;
+            for (int j = ind; (j >= 0) && (SS_index[j].next[t] < 0); --j)
             {
+                SS_index[j].next[t] = ind;
+            }
+        }
+    }
+}
+
+
+
+/**
+ * @brief Selects the constraints for a footstep.
+ *
+ * @param[in] type type of the footstep (not FS_TYPE_AUTO)
+ * @param[in] use_user_constraints_ use #user_constraints and 
+ *  #user_constraints_auto_ds instead of the default constraints.
+ * @param[out] constraints constraints for the footstep
+ * @param[out] constraints_auto_ds constraints for the automatically 
+ *  generated DS, which precede the footstep.
+ */
+void WMG::getFootstepConstraints(
+        const fs_type type,
+        const bool use_user_constraints_,
+        const double *& constraints,
+        const double *& constraints_auto_ds) const
+{
+    if (use_user_constraints_)
+    {
+        constraints = user_constraints;
+        constraints_auto_ds = user_constraints_auto_ds;
+    }
+    else
+    {
+        constraints_auto_ds = def_constraints.auto_ds;
+        switch (type)
+        {
+            case FS_TYPE_SS_R:
+                constraints = def_constraints.ss_right;
+                break;
+            case FS_TYPE_SS_L:
+                constraints = def_constraints.ss_left;
                 break;
+            case FS_TYPE_DS:
+            default:
+                constraints = def_constraints.ds;
+                break;
+        }
+    }
+}
+
+
+
+/**
+ * @brief Computes positions and orientations of the steps relative to 
+ * the position and orientation preceding the first step. This is an 
+ * inclusive prefix scan of the displacements in SE(2): the steps are 
+ * split into blocks of WMG_SCAN_BLOCK_SIZE steps, the blocks are scanned
+ * independently and then shifted by the totals of the preceding blocks.
+ *
+ * @param[in] num number of steps
+ * @param[in] steps the steps
+ * @param[out] abs_steps [num x 3] array of x, y, angle stored row-wise.
+ */
+void WMG::scanRelativeSteps(
+        const unsigned int num,
+        const footstepQueue::request *steps,
+        double *abs_steps) const
+{
+    const int num_blocks = (num + WMG_SCAN_BLOCK_SIZE - 1) / WMG_SCAN_BLOCK_SIZE;
+
+
+    // scan of each block
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int b = 0; b < num_blocks; ++b)
+    {
+        const unsigned int start = b * WMG_SCAN_BLOCK_SIZE;
+        const unsigned int end = (start + WMG_SCAN_BLOCK_SIZE < num) ? start + WMG_SCAN_BLOCK_SIZE : num;
+
+        double x = 0.0;
+        double y = 0.0;
+        double a = 0.0;
+        for (unsigned int i = start; i < end; ++i)
+        {
+            const double ca = cos(a);
+            const double sa = sin(a);
+
+            x += ca*steps[i].x_relative - sa*steps[i].y_relative;
+            y += sa*steps[i].x_relative + ca*steps[i].y_relative;
+            a += steps[i].angle_relative;
+
+            abs_steps[i*3] = x;
+            abs_steps[i*3 + 1] = y;
+            abs_steps[i*3 + 2] = a;
+        }
+    }
+
+
+    // the first block does not need a shift, the totals of the blocks
+    // are combined sequentially.
+    std::vector<double> shifts (3*num_blocks, 0.0);
+    for (int b = 1; b < num_blocks; ++b)
+    {
+        const double *prev = &shifts[(b-1)*3];
+        const double *total = &abs_steps[(b*WMG_SCAN_BLOCK_SIZE - 1)*3];
+        const double ca = cos(prev[2]);
+        const double sa = sin(prev[2]);
+
+        shifts[b*3]     = prev[0] + ca*total[0] - sa*total[1];
+        shifts[b*3 + 1] = prev[1] + sa*total[0] + ca*total[1];
+        shifts[b*3 + 2] = prev[2] + total[2];
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (int b = 1; b < num_blocks; ++b)
+    {
+        const unsigned int start = b * WMG_SCAN_BLOCK_SIZE;
+        const unsigned int end = (start + WMG_SCAN_BLOCK_SIZE < num) ? start + WMG_SCAN_BLOCK_SIZE : num;
+        const double *shift = &shifts[b*3];
+        const double ca = cos(shift[2]);
+        const double sa = sin(shift[2]);
+
+        for (unsigned int i = start; i < end; ++i)
+        {
+            double *step = &abs_steps[i*3];
+            const double x = step[0];
+
+            step[0] = shift[0] + ca*x - sa*step[1];
+            step[1] = shift[1] + sa*x + ca*step[1];
+            step[2] += shift[2];
+        }
+    }
+}
+
+
+
+/**
+ * @brief Takes footsteps from #footstep_queue until the footsteps (except
+ * the last one) cover the next preview window.
+ */
+void WMG::pullFootsteps()
+{
+    unsigned int window_ms = 0;
+    for (unsigned int i = 0; i < N; ++i)
+    {
+        window_ms += (T_ms[i] == 0) ? sampling_period : T_ms[i];
+    }
+
+    // the last footstep is not counted, since it is needed to determine
+    // positions of the feet in the preceding supports.
+    unsigned int covered_ms = 0;
+    for (unsigned int i = current_step_number; i + 1 < FS.size(); ++i)
+    {
+        covered_ms += FS[i].time_left;
+    }
+
+
+    footstepQueue::request req;
+    while (covered_ms <= window_ms)
+    {
+        if (!footstep_queue->pop(req))
+        {
+            break;
+        }
+
+        const unsigned int first_new = (FS.size() > 0) ? FS.size() - 1 : 0;
+
+        setFootstepParametersMS (
+                req.def_time_ms, 
+                req.ds_time_ms, 
+                req.ds_number, 
+                req.use_user_constraints);
+        addFootstep (req.x_relative, req.y_relative, req.angle_relative, req.type);
+
+        for (unsigned int i = first_new; i + 1 < FS.size(); ++i)
+        {
+            if (i >= (unsigned int) current_step_number)
+            {
+                covered_ms += FS[i].time_left;
+            }
+        }
+    }
+}
+
+
+
+/**
+ * @brief Removes the footsteps, which cannot be referenced any more, from
+ * the beginning of #FS. The previous single supports of both feet are kept
+ * for interpolation of feet positions. The footsteps are removed, when 
+ * they occupy at least a half of #FS, so that the cost of removal is
+ * constant per footstep.
+ */
+void WMG::retireFootsteps()
+{
+    int num_retired = first_preview_step;
+
+    const fs_type ss_types[2] = {FS_TYPE_SS_L, FS_TYPE_SS_R};
+    for (int i = 0; i < 2; ++i)
+    {
+        const int prev_ss = getPrevSS (first_preview_step, ss_types[i]);
+        if ((prev_ss >= 0) && (prev_ss < num_retired))
+        {
+            num_retired = prev_ss;
+        }
+    }
+
+    if ((num_retired == 0) || (2 * num_retired < (int) FS.size()))
+    {
+        return;
+    }
+
+
+    FS.erase (FS.begin(), FS.begin() + num_retired);
+    SS_index.erase (SS_index.begin(), SS_index.begin() + num_retired);
+    for (unsigned int i = 0; i < SS_index.size(); ++i)
+    {
+        for (int t = FS_TYPE_AUTO; t <= FS_TYPE_SS_R; ++t)
+        {
+            if (SS_index[i].next[t] >= 0)
+            {
+                SS_index[i].next[t] -= num_retired;
+            }
+            if (SS_index[i].prev[t] >= num_retired)
+            {
+                SS_index[i].prev[t] -= num_retired;
             }
             else
             {
-                if (FS[index].type == type)
-                {
-                    break;
-                }
+                SS_index[i].prev[t] = -1;
             }
         }
     }
-    return (index);
+
+    current_step_number -= num_retired;
+    first_preview_step -= num_retired;
+    offset_start = (offset_start > (unsigned int) num_retired) ? offset_start - num_retired : 0;
+    if (window_valid)
+    {
+        window_tail_step -= num_retired;
+    }
+    retired_footsteps += num_retired;
+    ++footsteps_version;
 }
 
 
 
 /**
- * @brief Determine position and orientation of feet in DS
+ * @brief Applies the offset of footsteps (see #repositionFootsteps) to the
+ * footsteps preceding the given one.
+ *
+ * @param[in] end_ind index of the first footstep, which is not changed.
+ */
+void WMG::applyOffset(const unsigned int end_ind)
+{
+    const unsigned int end = (end_ind < FS.size()) ? end_ind : FS.size();
+
+    for (; offset_start < end; ++offset_start)
+    {
+        FS[offset_start].translate(offset_x, offset_y);
+    }
+    if (offset_start == FS.size())
+    {
+        offset_x = 0.0;
+        offset_y = 0.0;
+    }
+}
+
+
+
+/**
+ * @brief Applies the offset of footsteps to the footsteps, which are used
+ * in a support, and precomputes parameters of the feet trajectories.
  *
  * @param[in] support_number number of the support
- * @param[out] left_foot_pos 4x4 homogeneous matrix, which represents position and orientation
- * @param[out] right_foot_pos 4x4 homogeneous matrix, which represents position and orientation
+ * @param[out] phase parameters of the trajectories
  */
-void WMG::getDSFeetPositions (
+void WMG::prepareFeetPhase (
         const int support_number,
-        double *left_foot_pos,
-        double *right_foot_pos)
+        feetPhase &phase)
 {
-    int left_ind, right_ind;
+    int last_ind = getNextSS (support_number);
+    const fs_type ss_types[2] = {FS_TYPE_SS_L, FS_TYPE_SS_R};
+    for (int i = 0; i < 2; ++i)
+    {
+        const int next_ss = getNextSS (support_number, ss_types[i]);
+        if (next_ss > last_ind)
+        {
+            last_ind = next_ss;
+        }
+    }
+    applyOffset (last_ind + 1);
 
-    left_ind = getNextSS (support_number);
-    if (FS[left_ind].type == FS_TYPE_SS_L)
+    formFeetPhase (support_number, phase);
+}
+
+
+
+/**
+ * @brief Finds the support, which contains the given moment of time. 
+ *
+ * @param[in] time_ms time (ms.) from the beginning of the first footstep
+ * @param[in] reset if true, the search is started from the current support,
+ *  otherwise from the support given by the other parameters (if it is not
+ *  later than time_ms).
+ * @param[in,out] support_number number of the support
+ * @param[in,out] support_start_ms time (ms.) of the beginning of the support
+ *  from the beginning of the first footstep.
+ *
+ * @return false if the time lies beyond the last footstep.
+ *
+ * @note Supports are switched when the time exceeds the end of a 
+ * support, i.e. the end of a support is still a part of it.
+ */
+bool WMG::findSupport (
+        const unsigned int time_ms,
+        const bool reset,
+        unsigned int &support_number,
+        unsigned int &support_start_ms) const
+{
+    if (reset || (time_ms < support_start_ms))
     {
-        right_ind = getPrevSS (support_number);
+        support_number = first_preview_step;
+        // formPreviewWindow() have already decremented the time
+        support_start_ms = preview_window_time_ms 
+            + FS[support_number].time_left + last_time_decrement
+            - FS[support_number].time_period;
+    }
+
+    if (support_number >= FS.size())
+    {
+        return (false);
+    }
+
+    while (time_ms - support_start_ms > FS[support_number].time_period)
+    {
+        support_start_ms += FS[support_number].time_period;
+        ++support_number;
+        if (support_number >= FS.size())
+        {
+            return (false);
+        }
+    }
+
+    return (true);
+}
+
+
+
+/**
+ * @brief Returns a fraction of support time that have passed.
+ *
+ * @param[in] time_ms time (ms.) from the beginning of the first footstep
+ * @param[in] support_number number of the support, see #findSupport
+ * @param[in] support_start_ms time (ms.) of the beginning of the support
+ *
+ * @return a number between 0 and 1 (0 for DS).
+ */
+double WMG::getSupportPhase (
+        const unsigned int time_ms,
+        const unsigned int support_number,
+        const unsigned int support_start_ms) const
+{
+    if (FS[support_number].type == FS_TYPE_DS)
+    {
+        return (0.0);
     }
     else
     {
-        right_ind = left_ind;
-        left_ind = getPrevSS (support_number);
+        return ((double) (time_ms - support_start_ms) / FS[support_number].time_period);
+    }
+}
+
+
+
+/**
+ * @brief Precomputes parameters of the feet trajectories in a support.
+ * The swing foot follows a cubic Bezier curve.
+ *
+ * @param[in] support_number number of the support
+ * @param[out] phase parameters of the trajectories
+ */
+void WMG::formFeetPhase (
+        const int support_number,
+        feetPhase &phase) const
+{
+    const footstep& current_step = FS[support_number];
+    phase.support_number = support_number;
+    phase.type = current_step.type;
+
+
+    if (current_step.type == FS_TYPE_DS)
+    {
+        int left_ind, right_ind;
+
+        left_ind = getNextSS (support_number);
+        if (FS[left_ind].type == FS_TYPE_SS_L)
+        {
+            right_ind = getPrevSS (support_number);
+        }
+        else
+        {
+            right_ind = left_ind;
+            left_ind = getPrevSS (support_number);
+        }
+
+        Matrix4d::Map(phase.left_posture) = Matrix4d::Map(FS[left_ind].posture);
+        Matrix4d::Map(phase.right_posture) = Matrix4d::Map(FS[right_ind].posture);
+        phase.left_yaw = FS[left_ind].angle;
+        phase.right_yaw = FS[right_ind].angle;
+        return;
     }
 
-    Matrix4d::Map(left_foot_pos) = FS[left_ind].posture->matrix();
-    Matrix4d::Map(right_foot_pos) = FS[right_ind].posture->matrix();
+
+    int next_swing_ind, prev_swing_ind;
+    int inclination_sign = 0;
+
+    if (current_step.type == FS_TYPE_SS_L)
+    {
+        inclination_sign = -1;
+
+        Matrix4d::Map(phase.left_posture) = Matrix4d::Map(current_step.posture);
+        phase.left_yaw = current_step.angle;
+
+        prev_swing_ind = getPrevSS (support_number, FS_TYPE_SS_R);
+        next_swing_ind = getNextSS (support_number, FS_TYPE_SS_R);
+    }
+    else
+    {
+        inclination_sign = 1;
+
+        Matrix4d::Map(phase.right_posture) = Matrix4d::Map(current_step.posture);
+        phase.right_yaw = current_step.angle;
+
+        prev_swing_ind = getPrevSS (support_number, FS_TYPE_SS_L);
+        next_swing_ind = getNextSS (support_number, FS_TYPE_SS_L);
+    }
+
+
+    const Transform<double, 3> prev_posture = FS[prev_swing_ind].getPosture();
+    const Transform<double, 3> next_posture = FS[next_swing_ind].getPosture();
+    Map<Matrix<double, 3, 6> > control_points (phase.control_points);
+
+    control_points.col(0) = Vector3d::Map(&FS[prev_swing_ind].posture[12]);
+    control_points.col(3) = Vector3d::Map(&FS[next_swing_ind].posture[12]); 
+
+    // In order to reach step_height on z axis in the middle of trajectory, 
+    // z coordinates for the second and the third points are derived as follows:
+    // 
+    // S = sum of weighted binomial coefficients
+    // 0.5^3 * w0*z0  +  3*0.5^3 * w1*z1  +  3*0.5^3 * w2*z2  +  0.5^3 * w3*z3 = step_height * S
+    //           =0                                                      =0 
+    // 3*0.5^3 * (w1*z1 + w2*z2) = step_height * S
+    //
+    // lets take z1=z2=z, then:
+    //
+    // z = step_height * S / (3*0.5^3 * (w1+w2))
+    //
+    // S depends on time, hence the points are split into constant parts
+    // and offsets along z axes of the frames of the steps.
+    const double z_coef = step_height / (3*0.5*0.5*0.5 * (bezier_weight_1 + bezier_weight_2));
+
+    // control points in the world frame
+    control_points.col(1) = prev_posture * Vector3d(0.0, inclination_sign * bezier_inclination_1, 0.0);
+    control_points.col(2) = next_posture * Vector3d(0.0, inclination_sign * bezier_inclination_2, 0.0);
+    control_points.col(4) = z_coef * prev_posture.matrix().block(0,2,3,1);
+    control_points.col(5) = z_coef * next_posture.matrix().block(0,2,3,1);
+
+    phase.weight_1 = bezier_weight_1;
+    phase.weight_2 = bezier_weight_2;
+
+    phase.swing_yaw_start = FS[prev_swing_ind].angle;
+    phase.swing_yaw_end = FS[next_swing_ind].angle;
 }
 
 
@@ -147,7 +601,7 @@ void WMG::getSSFeetPositions (
         next_swing_ind = getNextSS (support_number, FS_TYPE_SS_L);
     }
 
-    Matrix4d::Map(ref_foot_pos) = current_step.posture->matrix();
+    Matrix4d::Map(ref_foot_pos) = Matrix4d::Map(current_step.posture);
 
 
     double dx = FS[next_swing_ind].x() - FS[prev_swing_ind].x();
@@ -165,7 +619,7 @@ void WMG::getSSFeetPositions (
     double dl = /*(1-theta)*x[0] +*/ theta * l;
 
     Matrix4d::Map(swing_foot_pos) = (
-            (*FS[prev_swing_ind].posture)
+            FS[prev_swing_ind].getPosture()
           * Translation<double, 3>(theta * dx, theta * dy, a*dl*dl + b*dl)
           * AngleAxisd(FS[next_swing_ind].angle - FS[prev_swing_ind].angle, Vector3d::UnitZ())
             ).matrix();
@@ -174,96 +628,207 @@ void WMG::getSSFeetPositions (
 
 
 /**
- * @brief Determine position and orientation of feet (using cubic Bezier curves)
+ * @brief Forms a preview window without changing the state of the WMG.
  *
- * @param[in] support_number number of the support
- * @param[in] theta a number between 0 and 1, a fraction of support time that have passed 
- * @param[out] left_foot_pos 4x4 homogeneous matrix, which represents position and orientation
- * @param[out] right_foot_pos 4x4 homogeneous matrix, which represents position and orientation
+ * @param[out] par parameters of the preview window
+ * @param[in] override_ind index of a footstep to be replaced, ignored if -1.
+ * @param[in] override_fs a footstep, which is used instead of FS[override_ind].
+ * @param[out] time_decrement the amount of time spent in the first
+ *  sampling interval of the preview window.
+ * @param[out] tail_step index of the footstep, which contains the end of
+ *  the preview window.
+ * @param[out] tail_time_left the amount of time left in this footstep after
+ *  the end of the preview window.
+ *
+ * @return WMG_OK or WMG_HALT (simulation must be stopped)
  */
-void WMG::getSSFeetPositionsBezier (
-        const int support_number,
-        const double theta,
-        double *left_foot_pos,
-        double *right_foot_pos)
+WMGret WMG::formPreviewWindow(
+        smpc_parameters & par,
+        const int override_ind,
+        const footstep *override_fs,
+        unsigned int & time_decrement,
+        unsigned int & tail_step,
+        unsigned int & tail_time_left) const
 {
-    double *swing_foot_pos, *ref_foot_pos;
-    int next_swing_ind, prev_swing_ind;
-    int inclination_sign = 0;
-    footstep& current_step = FS[support_number];
+    WMGret retval = WMG_OK;
+    unsigned int win_step_num = current_step_number;
+    unsigned int step_time_left = FS[win_step_num].time_left;
 
 
-    if (current_step.type == FS_TYPE_SS_L)
+    for (unsigned int i = 0; i < N;)
     {
-        inclination_sign = -1;
+        if (step_time_left > 0)
+        {
+            unsigned int step_len_ms;
+            if (T_ms[i] == 0)
+            {
+                if (sampling_period > step_time_left) 
+                {
+                    step_len_ms = step_time_left;
+                }
+                else
+                {
+                    step_len_ms = sampling_period;
+                }
+            }
+            else
+            {
+                if (T_ms[i] > step_time_left) 
+                {
+                    retval = WMG_HALT;
+                    break;
+                }
+                step_len_ms = T_ms[i];
+            }
+            if ((int) win_step_num == override_ind)
+            {
+                setPreviewWindowElement (par, i, *override_fs, step_len_ms, false);
+            }
+            else
+            {
+                setPreviewWindowElement (
+                        par, i, FS[win_step_num], step_len_ms, 
+                        win_step_num >= offset_start);
+            }
+            step_time_left -= step_len_ms;
 
-        ref_foot_pos = left_foot_pos;
-        swing_foot_pos = right_foot_pos;
+            if (i == 0)
+            {
+                time_decrement = step_len_ms;
+            }
+            i++;
+        }
+        else
+        {
+            win_step_num++;
+            if (win_step_num == FS.size())
+            {
+                retval = WMG_HALT;
+                break;
+            }
+            step_time_left = FS[win_step_num].time_left;
+        }
+    }
 
-        prev_swing_ind = getPrevSS (support_number, FS_TYPE_SS_R);
-        next_swing_ind = getNextSS (support_number, FS_TYPE_SS_R);
+    tail_step = win_step_num;
+    tail_time_left = step_time_left;
+
+    return (retval);
+}
+
+
+
+/**
+ * @brief Moves the preview window by one sampling interval: the first 
+ * element is dropped and a new one is appended.
+ *
+ * @param[in,out] par parameters of the preview window, which were formed
+ *  on the previous call of #formPreviewWindow.
+ *
+ * @return WMG_OK or WMG_HALT (simulation must be stopped)
+ */
+WMGret WMG::shiftPreviewWindow(smpc_parameters & par)
+{
+    // the first interval of the new window
+    unsigned int first_step = current_step_number;
+    while (FS[first_step].time_left == 0)
+    {
+        ++first_step;
+    }
+    if (sampling_period > FS[first_step].time_left)
+    {
+        last_time_decrement = FS[first_step].time_left;
     }
     else
     {
-        inclination_sign = 1;
+        last_time_decrement = sampling_period;
+    }
 
-        ref_foot_pos = right_foot_pos;
-        swing_foot_pos = left_foot_pos;
 
-        prev_swing_ind = getPrevSS (support_number, FS_TYPE_SS_L);
-        next_swing_ind = getNextSS (support_number, FS_TYPE_SS_L);
+    // the last interval of the new window
+    while (window_tail_time_left == 0)
+    {
+        ++window_tail_step;
+        if (window_tail_step == FS.size())
+        {
+            return (WMG_HALT);
+        }
+        window_tail_time_left = FS[window_tail_step].time_left;
     }
 
-    Matrix4d::Map(ref_foot_pos) = current_step.posture->matrix();
+    unsigned int step_len_ms;
+    if (sampling_period > window_tail_time_left) 
+    {
+        step_len_ms = window_tail_time_left;
+    }
+    else
+    {
+        step_len_ms = sampling_period;
+    }
+    window_tail_time_left -= step_len_ms;
 
+    par.shiftWindow();
+    setPreviewWindowElement (
+            par, N-1, FS[window_tail_step], step_len_ms, 
+            window_tail_step >= offset_start);
+    par.mirrorWindow(N-1);
 
+    return (WMG_OK);
+}
 
-    Vector4d weighted_binomial_coef;
-    // first number is the weight
-    weighted_binomial_coef(0) = 1               * (1-theta)*(1-theta)*(1-theta);
-    weighted_binomial_coef(1) = bezier_weight_1 * 3*(1-theta)*(1-theta)*theta;
-    weighted_binomial_coef(2) = bezier_weight_2 * 3*(1-theta)*theta*theta;
-    weighted_binomial_coef(3) = 1               * theta*theta*theta;
 
 
-    Matrix<double, 3, 4> control_points;
-    control_points.col(0) = FS[prev_swing_ind].posture->translation();
-    control_points.col(3) = FS[next_swing_ind].posture->translation(); 
+/**
+ * @brief Sets an element of the preview window.
+ *
+ * @param[out] par parameters of the preview window
+ * @param[in] i index of the element
+ * @param[in] step the footstep corresponding to the element
+ * @param[in] step_len_ms length of the sampling interval
+ * @param[in] apply_offset translate the footstep by the offset, see
+ *  #repositionFootsteps.
+ */
+void WMG::setPreviewWindowElement (
+        smpc_parameters & par,
+        const unsigned int i,
+        const footstep &step,
+        const unsigned int step_len_ms,
+        const bool apply_offset) const
+{
+    double x = step.x();
+    double y = step.y();
+    const double *d = step.d;
+    double translated_d[4];
 
-    // In order to reach step_height on z axis in the middle of trajectory, 
-    // z coordinates for these  two points are derived as follows:
-    // 
-    // S = sum of weighted binomial coefficients
-    // 0.5^3 * w0*z0  +  3*0.5^3 * w1*z1  +  3*0.5^3 * w2*z2  +  0.5^3 * w3*z3 = step_height * S
-    //           =0                                                      =0 
-    // 3*0.5^3 * (w1*z1 + w2*z2) = step_height * S
-    //
-    // lets take z1=z2=z, then:
-    //
-    // z = step_height * S / (3*0.5^3 * (w1+w2))
+    if (apply_offset)
+    {
+        // see RectangularConstraint_ZMP#rotate_translate
+        x += offset_x;
+        y += offset_y;
+        for (int j = 0; j < 4; ++j)
+        {
+            translated_d[j] = step.d_orig[j] + step.D[j]*x + step.D[j+4]*y;
+        }
+        d = translated_d;
+    }
 
-    // control points in a frame fixed in the reference points of the steps 
-    control_points.col(1).x() = 0.0;
-    control_points.col(1).y() = inclination_sign * bezier_inclination_1;
-    control_points.col(1).z() = step_height*weighted_binomial_coef.sum() 
-                               / (3*0.5*0.5*0.5 * (bezier_weight_1 + bezier_weight_2));
-    control_points.col(2).x() = 0.0;
-    control_points.col(2).y() = inclination_sign * bezier_inclination_2;
-    control_points.col(2).z() = control_points.col(1).z();
 
-    // control points in the world frame
-    control_points.col(1)     = (*FS[prev_swing_ind].posture) * control_points.col(1);
-    control_points.col(2)     = (*FS[next_swing_ind].posture) * control_points.col(2);
+    par.angle[i] = step.angle;
+
+    par.fp_x[i] = x;
+    par.fp_y[i] = y;
+
+
+    // ZMP reference coordinates
+    par.zref_x[i] = step.ZMPref.x();
+    par.zref_y[i] = step.ZMPref.y();
 
 
+    par.lb[i*2] = -d[2];
+    par.ub[i*2] = d[0];
 
-    Transform<double, 3> swing_posture =
-        Translation<double,3>(
-                control_points * weighted_binomial_coef / weighted_binomial_coef.sum())
-        *
-        Quaterniond (AngleAxisd (FS[prev_swing_ind].angle,Vector3d::UnitZ())).slerp (
-                theta,
-                Quaterniond (AngleAxisd (FS[next_swing_ind].angle,Vector3d::UnitZ())));
+    par.lb[i*2 + 1] = -d[3];
+    par.ub[i*2 + 1] = d[1];
 
-    Matrix4d::Map(swing_foot_pos) = swing_posture.matrix();
+    par.T[i] = (double) step_len_ms / 1000;
 }
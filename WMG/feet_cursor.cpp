@@ -0,0 +1,28 @@
+/** 
+ * @file
+ * @author agent
+ */
+
+#include "WMG.h"
+#include "feet_phase.h"
+
+
+feetCursor::feetCursor()
+{
+    support_number = 0;
+    support_start_ms = 0;
+    phase = new feetPhase;
+    phase->support_number = -1;
+    // WMG starts with version 0, the cursor must be reset on the first query
+    footsteps_version = (unsigned int) -1;
+}
+
+
+
+feetCursor::~feetCursor()
+{
+    if (phase != NULL)
+    {
+        delete phase;
+    }
+}
@@ -0,0 +1,152 @@
+/**
+ * @file
+ * @author agent
+ */
+
+
+/****************************************
+ * INCLUDES
+ ****************************************/
+
+#include <cmath> // sin, cos, atan2
+
+#include "feet_phase.h"
+#include "footstep.h"
+
+
+/****************************************
+ * FUNCTIONS
+ ****************************************/
+
+/**
+ * @brief Determine positions and orientations of feet for several moments
+ * of time within the support.
+ *
+ * @param[in] num number of samples
+ * @param[in] theta num numbers between 0 and 1, fractions of support time
+ *  that have passed
+ * @param[out] left_foot_pos num 4x4 homogeneous matrices or num (x, y, z, yaw)
+ *  vectors (see compact)
+ * @param[out] right_foot_pos num 4x4 homogeneous matrices or num (x, y, z, yaw)
+ *  vectors (see compact)
+ * @param[in] compact if true, (x, y, z, yaw) vectors are written instead
+ *  of matrices.
+ */
+void feetPhase::evaluate (
+        const unsigned int num,
+        const double *theta,
+        double *left_foot_pos,
+        double *right_foot_pos,
+        const bool compact) const
+{
+    const unsigned int stride = compact ? 4 : 16;
+    double *swing_foot_pos = NULL;
+
+
+    // fixed feet
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        if (type != FS_TYPE_SS_R)
+        {
+            double *pos = &left_foot_pos[i*stride];
+            if (compact)
+            {
+                pos[0] = left_posture[12];
+                pos[1] = left_posture[13];
+                pos[2] = left_posture[14];
+                pos[3] = left_yaw;
+            }
+            else
+            {
+                Matrix4d::Map(pos) = Matrix4d::Map(left_posture);
+            }
+        }
+
+        if (type != FS_TYPE_SS_L)
+        {
+            double *pos = &right_foot_pos[i*stride];
+            if (compact)
+            {
+                pos[0] = right_posture[12];
+                pos[1] = right_posture[13];
+                pos[2] = right_posture[14];
+                pos[3] = right_yaw;
+            }
+            else
+            {
+                Matrix4d::Map(pos) = Matrix4d::Map(right_posture);
+            }
+        }
+    }
+
+    switch (type)
+    {
+        case FS_TYPE_SS_L:
+            swing_foot_pos = right_foot_pos;
+            break;
+        case FS_TYPE_SS_R:
+            swing_foot_pos = left_foot_pos;
+            break;
+        case FS_TYPE_DS:
+        default:
+            return;
+    }
+
+
+    // swing foot
+    const Matrix<double, 3, 6> points = Matrix<double, 3, 6>::Map(control_points);
+    const Quaterniond orientation_start (AngleAxisd (swing_yaw_start, Vector3d::UnitZ()));
+    const Quaterniond orientation_end (AngleAxisd (swing_yaw_end, Vector3d::UnitZ()));
+    // the shortest rotation, as in slerp
+    const double yaw_diff = atan2 (
+            sin (swing_yaw_end - swing_yaw_start),
+            cos (swing_yaw_end - swing_yaw_start));
+
+    for (unsigned int first = 0; first < num; first += FEET_PHASE_BLOCK_SIZE)
+    {
+        Matrix<double, 6, FEET_PHASE_BLOCK_SIZE> coef;
+        double coef_sum[FEET_PHASE_BLOCK_SIZE];
+
+        for (unsigned int j = 0; j < FEET_PHASE_BLOCK_SIZE; ++j)
+        {
+            // the unused columns are filled with valid values
+            const double t = (first + j < num) ? theta[first + j] : 0.0;
+
+            // weighted binomial coefficients
+            coef(0,j) = 1        * (1-t)*(1-t)*(1-t);
+            coef(1,j) = weight_1 * 3*(1-t)*(1-t)*t;
+            coef(2,j) = weight_2 * 3*(1-t)*t*t;
+            coef(3,j) = 1        * t*t*t;
+            coef_sum[j] = coef(0,j) + coef(1,j) + coef(2,j) + coef(3,j);
+
+            // vertical offsets of the second and the third control points
+            coef(4,j) = coef_sum[j] * coef(1,j);
+            coef(5,j) = coef_sum[j] * coef(2,j);
+        }
+
+        const Matrix<double, 3, FEET_PHASE_BLOCK_SIZE> position = points * coef;
+
+        for (unsigned int j = 0; (j < FEET_PHASE_BLOCK_SIZE) && (first + j < num); ++j)
+        {
+            double *pos = &swing_foot_pos[(first + j)*stride];
+            const Vector3d swing_position = position.col(j) / coef_sum[j];
+
+            if (compact)
+            {
+                pos[0] = swing_position.x();
+                pos[1] = swing_position.y();
+                pos[2] = swing_position.z();
+                pos[3] = swing_yaw_start + theta[first + j] * yaw_diff;
+            }
+            else
+            {
+                Transform<double, 3> swing_posture =
+                    Translation<double,3>(swing_position)
+                    *
+                    orientation_start.slerp (theta[first + j], orientation_end);
+
+                Matrix4d::Map(pos) = swing_posture.matrix();
+            }
+        }
+    }
+}
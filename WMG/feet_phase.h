@@ -0,0 +1,91 @@
+/**
+ * @file
+ * @author agent
+ */
+
+
+#ifndef FEET_PHASE_H
+#define FEET_PHASE_H
+
+/****************************************
+ * INCLUDES
+ ****************************************/
+
+#include "WMG.h"
+
+
+
+/****************************************
+ * DEFINES
+ ****************************************/
+
+/// Number of samples, which are evaluated simultaneously.
+#define FEET_PHASE_BLOCK_SIZE 4
+
+
+
+/****************************************
+ * TYPEDEFS
+ ****************************************/
+
+
+/// @addtogroup gWMG_INTERNALS
+/// @{
+
+/**
+ * @brief Precomputed parameters of the feet trajectories in one support,
+ * see WMG#formFeetPhase.
+ */
+class feetPhase
+{
+    public:
+        void evaluate (
+                const unsigned int,
+                const double *,
+                double *,
+                double *,
+                const bool) const;
+
+
+        /// Index of the support in WMG#FS, -1 if the phase is not formed.
+        int support_number;
+
+        /// Type of the support, the swing foot does not move in DS.
+        fs_type type;
+
+
+        ///@{
+        /// Postures (4x4 homogeneous matrices) and yaw angles of the feet,
+        /// the posture of the swing foot is not used.
+        double left_posture[16];
+        double right_posture[16];
+        double left_yaw;
+        double right_yaw;
+        ///@}
+
+
+        /**
+         * Matrix [3 x 6] of the coefficients of the Bezier curve of the
+         * swing foot stored column-wise: the first and the last control
+         * points, the second and the third control points without the
+         * vertical offsets, and directions of the vertical offsets. The
+         * offsets are proportional to the sum of the weighted binomial
+         * coefficients.
+         */
+        double control_points[3*6];
+
+        ///@{
+        /// Weights of the second and the third control points.
+        double weight_1;
+        double weight_2;
+        ///@}
+
+        ///@{
+        /// Orientation of the swing foot at the beginning and at the end of SS.
+        double swing_yaw_start;
+        double swing_yaw_end;
+        ///@}
+};
+
+///@}
+#endif /*FEET_PHASE_H*/
@@ -39,7 +39,7 @@ footstep::footstep(
     RectangularConstraint_ZMP(d_),
     ZMPref(ZMPref_)
 {
-    posture = new Transform<double, 3>(posture_);
+    Matrix4d::Map(posture) = posture_.matrix();
     type = type_;
     angle = angle_; 
     ca = cos(angle); 
@@ -50,49 +50,90 @@ footstep::footstep(
 
 
 /**
- * @brief A copy constructor.
+ * @brief Restores a footstep from a record of a plan file.
  *
- * @param[in] copy_from original class instance
+ * @param[in] record the record
  */
-footstep::footstep (const footstep& copy_from) : 
-    RectangularConstraint_ZMP(copy_from),
-    ZMPref(copy_from.ZMPref)
+footstep::footstep(const footstepRecord &record) : 
+    RectangularConstraint_ZMP(record.d_orig),
+    ZMPref(Vector3d::Map(record.ZMPref))
 {
-    posture = new Transform<double, 3>(*copy_from.posture);
-    type = copy_from.type;
-    angle = copy_from.angle; 
-    ca = copy_from.ca; 
-    sa = copy_from.sa;
-    time_left = copy_from.time_left;
-    time_period = copy_from.time_period;
+    angle = record.angle;
+    ca = record.ca;
+    sa = record.sa;
+    for (int i = 0; i < 16; ++i)
+    {
+        posture[i] = record.posture[i];
+    }
+    for (int i = 0; i < 8; ++i)
+    {
+        D[i] = record.D[i];
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        d[i] = record.d[i];
+    }
+
+    time_left = time_period = record.time_period;
+    type = (fs_type) record.type;
 }
 
 
+/**
+ * @brief Stores the footstep in a record of a plan file.
+ *
+ * @param[out] record the record
+ */
+void footstep::toRecord(footstepRecord &record) const
+{
+    record.angle = angle;
+    record.ca = ca;
+    record.sa = sa;
+    for (int i = 0; i < 16; ++i)
+    {
+        record.posture[i] = posture[i];
+    }
+    Vector3d::Map(record.ZMPref) = ZMPref;
+    for (int i = 0; i < 8; ++i)
+    {
+        record.D[i] = D[i];
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        record.d[i] = d[i];
+        record.d_orig[i] = d_orig[i];
+    }
+    record.time_period = time_period;
+    record.type = type;
+}
+
 
 /**
- * @brief Destructor
+ * @return position and orientation of the footstep.
  */
-footstep::~footstep()
+Transform<double, 3> footstep::getPosture() const
 {
-    delete posture;
+    Transform<double, 3> posture_;
+    posture_.matrix() = Matrix4d::Map(posture);
+    return (posture_);
 }
 
 
 /**
  * @return x coordinate
  */
-double footstep::x()
+double footstep::x() const
 {
-    return (posture->translation()[0]);
+    return (posture[12]);
 }
 
 
 /**
  * @return y coordinate
  */
-double footstep::y()
+double footstep::y() const
 {
-    return (posture->translation()[1]);
+    return (posture[13]);
 }
 
 
@@ -105,14 +146,32 @@ double footstep::y()
  */
 void footstep::changePosture (const double * new_posture, const bool zero_z_coordinate)
 {
-    posture->matrix() = Matrix4d::Map(new_posture);
+    for (int i = 0; i < 16; ++i)
+    {
+        posture[i] = new_posture[i];
+    }
     if (zero_z_coordinate)
     {
-        posture->translation()[2] = 0.0;
+        posture[14] = 0.0;
     }
-    Matrix3d rotation = posture->matrix().corner(TopLeft,3,3);
+    Matrix3d rotation = Matrix4d::Map(posture).corner(TopLeft,3,3);
     angle = rotation.eulerAngles(0,1,2)[2];
     ca = cos(angle);
     sa = sin(angle);
     rotate_translate(ca, sa, x(), y());
 }
+
+
+
+/**
+ * @brief Translate the footstep in the horizontal plane.
+ *
+ * @param[in] diff_x change in position along x axis
+ * @param[in] diff_y change in position along y axis
+ */
+void footstep::translate (const double diff_x, const double diff_y)
+{
+    posture[12] += diff_x;
+    posture[13] += diff_y;
+    rotate_translate(ca, sa, x(), y());
+}
@@ -17,6 +17,18 @@
 
 
 
+/****************************************
+ * DEFINES
+ ****************************************/
+
+/// Version of the format of binary plan files.
+#define WMG_PLAN_VERSION 2
+
+/// Number of steps in a block of the prefix scan, see WMG#addFootsteps.
+#define WMG_SCAN_BLOCK_SIZE 1024
+
+
+
 /****************************************
  * TYPEDEFS 
  ****************************************/
@@ -25,6 +37,41 @@
 /// @addtogroup gWMG_INTERNALS
 /// @{
 
+/**
+ * @brief A footstep in a binary plan file, see WMG#savePlan. The layout 
+ * must not be changed without incrementing WMG_PLAN_VERSION.
+ */
+struct footstepRecord
+{
+    double angle;
+    double ca;
+    double sa;
+    double posture[16];
+    double ZMPref[3];
+    double D[4*2];
+    double d[4];
+    double d_orig[4];
+    /// The progress of walking is not stored, see WMG#savePlan.
+    unsigned int time_period;
+    int type;
+};
+
+
+/**
+ * @brief Header of a binary plan file, it is followed by 
+ * footstepRecord structures. Numbers are stored in the native byte order.
+ */
+struct planHeader
+{
+    /// "WMGP"
+    char magic[4];
+    unsigned int version;
+    /// sizeof(footstepRecord)
+    unsigned int record_size;
+    unsigned int num_footsteps;
+};
+
+
 /** \brief Defines a footstep. */
 class footstep : public RectangularConstraint_ZMP
 {
@@ -36,12 +83,14 @@ class footstep : public RectangularConstraint_ZMP
                 const unsigned int, 
                 const fs_type, 
                 const double *);
-        footstep (const footstep&);
-        ~footstep();
+        footstep (const footstepRecord &);
 
+        void toRecord (footstepRecord &) const;
         void changePosture(const double *, const bool);
-        double x();
-        double y();
+        void translate(const double, const double);
+        Transform<double, 3> getPosture() const;
+        double x() const;
+        double y() const;
 
 
 
@@ -66,8 +115,12 @@ class footstep : public RectangularConstraint_ZMP
         /// Reference ZMP point
         Vector3d ZMPref;
 
-
-        Transform<double, 3>* posture;
+        /**
+         * Position and orientation of the footstep: 4x4 homogeneous matrix
+         * stored column-wise. The matrix is kept inline, so that footsteps
+         * are copied without memory allocation.
+         */
+        double posture[16];
 };
 ///@}
 #endif /*FOOTSTEP_H*/
@@ -0,0 +1,63 @@
+/** 
+ * @file
+ * @author agent
+ */
+
+#include "WMG.h"
+
+
+footstepQueue::footstepQueue(const unsigned int capacity_)
+{
+    buffer_size = capacity_ + 1;
+    buffer = new request[buffer_size];
+    head = 0;
+    tail = 0;
+}
+
+
+
+footstepQueue::~footstepQueue()
+{
+    if (buffer != NULL)
+    {
+        delete [] buffer;
+    }
+}
+
+
+
+bool footstepQueue::push (const request &req)
+{
+    const unsigned int next_tail = (tail + 1) % buffer_size;
+
+    if (next_tail == head)
+    {
+        return (false);
+    }
+
+    buffer[tail] = req;
+    // the request must be written before it becomes visible to the consumer
+    __sync_synchronize();
+    tail = next_tail;
+
+    return (true);
+}
+
+
+
+bool footstepQueue::pop (request &req)
+{
+    if (head == tail)
+    {
+        return (false);
+    }
+
+    // the request must be read after the tail
+    __sync_synchronize();
+    req = buffer[head];
+    // the request must be read before the element is released
+    __sync_synchronize();
+    head = (head + 1) % buffer_size;
+
+    return (true);
+}
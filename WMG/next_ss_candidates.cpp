@@ -0,0 +1,49 @@
+/** 
+ * @file
+ * @author agent
+ */
+
+#include "WMG.h"
+#include "footstep.h"
+
+
+nextSSCandidates::nextSSCandidates(
+        const unsigned int num_,
+        const unsigned int N,
+        const double hCoM,
+        const double gravity) :
+    objective(num_, 0.0),
+    first_controls(num_)
+{
+    num = num_;
+
+    // dummy footsteps, they are overwritten by WMG::evaluateNextSSCandidates()
+    const double d[4] = {1.0, 1.0, 1.0, 1.0};
+    Transform<double, 3> posture (Translation<double, 3>(0.0, 0.0, 0.0));
+
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        par.push_back (new smpc_parameters (N, hCoM, gravity));
+        candidate_fs.push_back (new footstep (0.0, posture, Vector3d::Zero(), 0, FS_TYPE_DS, d));
+    }
+}
+
+
+
+nextSSCandidates::~nextSSCandidates()
+{
+    for (unsigned int i = 0; i < par.size(); ++i)
+    {
+        if (par[i] != NULL)
+        {
+            delete par[i];
+        }
+    }
+    for (unsigned int i = 0; i < candidate_fs.size(); ++i)
+    {
+        if (candidate_fs[i] != NULL)
+        {
+            delete candidate_fs[i];
+        }
+    }
+}
@@ -34,7 +34,7 @@
     \endverbatim
     At creation p is assumed to be [0;0] and rotation angle = 0.
  */
-RectangularConstraint_ZMP::RectangularConstraint_ZMP(const double *d_) : vert(4,2)
+RectangularConstraint_ZMP::RectangularConstraint_ZMP(const double *d_)
 {
     D[0] =  1.0; D[4] =  0.0;
     D[1] =  0.0; D[5] =  1.0;
@@ -50,8 +50,6 @@ RectangularConstraint_ZMP::RectangularConstraint_ZMP(const double *d_) : vert(4,
     d_orig[1] = d[1];
     d_orig[2] = d[2];
     d_orig[3] = d[3];
-
-    Constraints2Vert(); // determine coordinates of vertices
 }
 
 
@@ -80,8 +78,6 @@ void RectangularConstraint_ZMP::rotate_translate(const double ca, const double s
     d[1] = d_orig[1] + D[1]*x + D[5]*y;
     d[2] = d_orig[2] + D[2]*x + D[6]*y;
     d[3] = d_orig[3] + D[3]*x + D[7]*y;
-
-    Constraints2Vert(); // determine coordinates of vertices
 }
 
 
@@ -95,8 +91,14 @@ void RectangularConstraint_ZMP::rotate_translate(const double ca, const double s
     |         |
     4---------1
     \endverbatim
+
+    \param[out] vert absolute coordinates of the vertices, [4 x 2] matrix
+    stored row-wise.
+
+    \note The vertices are not used in the control loop and, therefore, are
+    not stored, this function is called only when they are needed.
 */
-void RectangularConstraint_ZMP::Constraints2Vert()
+void RectangularConstraint_ZMP::Constraints2Vert(double *vert) const
 {
     double det;
     
@@ -110,25 +112,25 @@ void RectangularConstraint_ZMP::Constraints2Vert()
     // |0 4|   0    1/det * | 7 -4|
     // |3 7|   3            |-3  0|
     det = D[0]*D[7] - D[3]*D[4];
-    vert(0,0) =  D[7]/det*d[0] - D[4]/det*d[3];
-    vert(0,1) = -D[3]/det*d[0] + D[0]/det*d[3]; 
+    vert[0] =  D[7]/det*d[0] - D[4]/det*d[3];
+    vert[1] = -D[3]/det*d[0] + D[0]/det*d[3]; 
     
     // |0 4|   0     | 5 -4|
     // |1 5|   1     |-1  0|
     det = D[0]*D[5] - D[4]*D[1]; 
-    vert(1,0) =  D[5]/det*d[0] - D[4]/det*d[1];
-    vert(1,1) = -D[1]/det*d[0] + D[0]/det*d[1]; 
+    vert[2] =  D[5]/det*d[0] - D[4]/det*d[1];
+    vert[3] = -D[1]/det*d[0] + D[0]/det*d[1]; 
     
     // |1 5|   1     | 6 -5|
     // |2 6|   2     |-2  1|
     det = D[1]*D[6] - D[5]*D[2]; 
-    vert(2,0) =  D[6]/det*d[1] - D[5]/det*d[2];
-    vert(2,1) = -D[2]/det*d[1] + D[1]/det*d[2]; 
+    vert[4] =  D[6]/det*d[1] - D[5]/det*d[2];
+    vert[5] = -D[2]/det*d[1] + D[1]/det*d[2]; 
     
     // |2 6|   2     | 7 -6|
     // |3 7|   3     |-3  2|
     det = D[2]*D[7] - D[3]*D[6]; 
-    vert(3,0) =  D[7]/det*d[2] - D[6]/det*d[3];
-    vert(3,1) = -D[3]/det*d[2] + D[2]/det*d[3]; 
+    vert[6] =  D[7]/det*d[2] - D[6]/det*d[3];
+    vert[7] = -D[3]/det*d[2] + D[2]/det*d[3]; 
 }
 
@@ -32,7 +32,7 @@ class RectangularConstraint_ZMP
     public:
         RectangularConstraint_ZMP(const double *);
         void rotate_translate(const double, const double, const double, const double);
-        void Constraints2Vert();
+        void Constraints2Vert(double *) const;
 
 
 
@@ -63,9 +63,6 @@ class RectangularConstraint_ZMP
 
         /// Size of the support polygon for a single support (no rotation / translation).
         double d_orig[4];
-
-        /// Absolute coordinates of vertices.
-        MatrixXd vert;
 };
 
 ///@}
@@ -8,16 +8,16 @@
 
 
 smpc_parameters::smpc_parameters(
-        const unsigned int N,
+        const unsigned int N_,
         const double hCoM_,
         const double gravity_)
 {
+    N = N_;
     hCoM = hCoM_;
     gravity = gravity_;
 
     X = new double[SMPC_NUM_VAR*N];
 
-    T = new double[N];
     h = new double[N];
 
     h0 = hCoM/gravity;
@@ -26,13 +26,10 @@ smpc_parameters::smpc_parameters(
         h[i] = h0;
     }
 
-    angle = new double[N];
-    zref_x = new double[N];
-    zref_y = new double[N];
-    fp_x = new double[N];
-    fp_y = new double[N];
-    lb = new double[2*N];
-    ub = new double[2*N];
+    // each array is stored twice, so that the preview window is always
+    // contiguous, when it is moved along the ring buffers.
+    window_mem = new double[6*2*N + 2*4*N];
+    resetWindow();
 }
 
 
@@ -45,41 +42,73 @@ smpc_parameters::~smpc_parameters()
         X = NULL;
     }
 
-    if (T != NULL)
-    {
-        delete T;
-    }
     if (h != NULL)
     {
-        delete h;
-    }
-
-    if (angle != NULL)
-    {
-        delete angle;
-    }
-    if (zref_x != NULL)
-    {
-        delete zref_x;
+        delete [] h;
     }
-    if (zref_y != NULL)
+    if (window_mem != NULL)
     {
-        delete zref_y;
+        delete [] window_mem;
     }
-    if (fp_x != NULL)
-    {
-        delete fp_x;
-    }
-    if (fp_y != NULL)
+}
+
+
+void smpc_parameters::resetWindow ()
+{
+    window_offset = 0;
+
+    T      = &window_mem[0];
+    angle  = &window_mem[2*N];
+    fp_x   = &window_mem[4*N];
+    fp_y   = &window_mem[6*N];
+    zref_x = &window_mem[8*N];
+    zref_y = &window_mem[10*N];
+    lb     = &window_mem[12*N];
+    ub     = &window_mem[16*N];
+}
+
+
+
+void smpc_parameters::shiftWindow ()
+{
+    if (window_offset == N-1)
     {
-        delete fp_y;
+        resetWindow();
     }
-    if (lb != NULL)
+    else
     {
-        delete lb;
+        ++window_offset;
+
+        ++T;
+        ++angle;
+        ++fp_x;
+        ++fp_y;
+        ++zref_x;
+        ++zref_y;
+        lb += 2;
+        ub += 2;
     }
-    if (ub != NULL)
+}
+
+
+
+void smpc_parameters::mirrorWindow (const unsigned int first_ind)
+{
+    for (int i = first_ind; i < (int) N; ++i)
     {
-        delete ub;
+        // the second copy is located either before or after the window.
+        const int shift = (window_offset + i < N) ? (int) N : -((int) N);
+
+        T[i + shift]      = T[i];
+        angle[i + shift]  = angle[i];
+        fp_x[i + shift]   = fp_x[i];
+        fp_y[i + shift]   = fp_y[i];
+        zref_x[i + shift] = zref_x[i];
+        zref_y[i + shift] = zref_y[i];
+
+        lb[2*i + 2*shift]     = lb[2*i];
+        lb[2*i + 1 + 2*shift] = lb[2*i + 1];
+        ub[2*i + 2*shift]     = ub[2*i];
+        ub[2*i + 1 + 2*shift] = ub[2*i + 1];
     }
 }
@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @author agent
+ * @brief Counting of heap allocations: the global operators new are
+ *  replaced, hence this file must be included in one translation unit of a
+ *  program.
+ */
+
+
+#ifndef BENCH_ALLOC_H
+#define BENCH_ALLOC_H
+
+#include <cstdlib> // malloc, free
+#include <new> // bad_alloc
+
+///@addtogroup gBENCH
+///@{
+
+/// The number of calls of the operators new, not thread-safe.
+unsigned long bench_allocations = 0;
+
+
+// GCC reports a mismatch of new and free, if they are inlined
+#ifdef __GNUC__
+#define BENCH_NOINLINE __attribute__ ((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+#if __cplusplus < 201103L
+#define BENCH_THROW_BAD_ALLOC throw (std::bad_alloc)
+#define BENCH_NOTHROW throw ()
+#else
+#define BENCH_THROW_BAD_ALLOC
+#define BENCH_NOTHROW noexcept
+#endif
+
+
+/**
+ * @brief Allocates memory and counts the call.
+ *
+ * @param[in] size the number of bytes.
+ *
+ * @return memory.
+ */
+inline void * bench_allocate (std::size_t size)
+{
+    ++bench_allocations;
+
+    void *ptr = malloc ((size > 0) ? size : 1);
+    if (ptr == NULL)
+    {
+        throw std::bad_alloc();
+    }
+    return (ptr);
+}
+
+
+BENCH_NOINLINE void * operator new (std::size_t size) BENCH_THROW_BAD_ALLOC
+{
+    return (bench_allocate (size));
+}
+
+BENCH_NOINLINE void * operator new[] (std::size_t size) BENCH_THROW_BAD_ALLOC
+{
+    return (bench_allocate (size));
+}
+
+BENCH_NOINLINE void operator delete (void *ptr) BENCH_NOTHROW
+{
+    free (ptr);
+}
+
+BENCH_NOINLINE void operator delete[] (void *ptr) BENCH_NOTHROW
+{
+    free (ptr);
+}
+
+#undef BENCH_NOINLINE
+#undef BENCH_THROW_BAD_ALLOC
+#undef BENCH_NOTHROW
+
+///@}
+#endif /*BENCH_ALLOC_H*/
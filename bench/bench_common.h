@@ -0,0 +1,743 @@
+/**
+ * @file
+ * @author agent
+ * @brief Common functions of the benchmarks: time measurements, statistics,
+ *  capturing of problems from walking scenarios and output of the results.
+ */
+
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <time.h> // clock_gettime
+#include <vector>
+#include <string>
+#include <algorithm> // sort
+#include <utility> // pair
+
+#include "tests_common.h"
+#include "bench_counters.h"
+
+///@addtogroup gBENCH
+///@{
+
+
+/****************************************
+ * Time
+ ****************************************/
+
+/**
+ * @return monotonic time in nanoseconds.
+ */
+inline double bench_time_ns ()
+{
+    struct timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return ((double) ts.tv_sec * 1e9 + (double) ts.tv_nsec);
+}
+
+
+
+/****************************************
+ * Statistics
+ ****************************************/
+
+/**
+ * @brief Robust statistics of a set of samples.
+ */
+class bench_stats
+{
+    public:
+        bench_stats ()
+        {
+            median = mad = min = max = mean = 0.0;
+            samples = 0;
+        }
+
+
+        /**
+         * @brief Computes the statistics.
+         *
+         * @param[in] values the samples (a copy is sorted).
+         */
+        explicit bench_stats (vector<double> values)
+        {
+            median = mad = min = max = mean = 0.0;
+            samples = values.size();
+            if (samples == 0)
+            {
+                return;
+            }
+
+            sort (values.begin(), values.end());
+            min = values.front();
+            max = values.back();
+            median = get_median (values);
+
+            for (unsigned int i = 0; i < samples; ++i)
+            {
+                mean += values[i];
+                values[i] = fabs(values[i] - median);
+            }
+            mean /= samples;
+
+            sort (values.begin(), values.end());
+            mad = get_median (values);
+        }
+
+
+        /// Median.
+        double median;
+        /// Median absolute deviation from the median.
+        double mad;
+        ///@{
+        /// Minimal, maximal and mean values.
+        double min;
+        double max;
+        double mean;
+        ///@}
+        /// Number of samples.
+        unsigned int samples;
+
+
+    private:
+        static double get_median (const vector<double> &sorted)
+        {
+            const unsigned int size = sorted.size();
+            if (size % 2 == 0)
+            {
+                return ((sorted[size/2 - 1] + sorted[size/2]) / 2);
+            }
+            else
+            {
+                return (sorted[size/2]);
+            }
+        }
+};
+
+
+
+/**
+ * @brief A histogram with logarithmic buckets of the same relative width
+ * (similar to HdrHistogram): each power of two is split into
+ * 2^#precision_bits linear sub-buckets, hence the percentiles are accurate
+ * up to 2^-#precision_bits relative error, and the memory does not depend
+ * on the number or range of the values.
+ */
+class bench_histogram
+{
+    public:
+        /**
+         * @param[in] precision_bits_ defines the relative width of the
+         * buckets, the default corresponds to < 1%.
+         */
+        explicit bench_histogram (const unsigned int precision_bits_ = 7)
+        {
+            precision_bits = precision_bits_;
+            // values up to 2^64
+            counts.resize (64 << precision_bits, 0);
+            num = 0;
+            min = max = 0.0;
+        }
+
+
+        /**
+         * @brief Adds a value.
+         *
+         * @param[in] value a value, values below 1 are counted as 1.
+         */
+        void add (const double value)
+        {
+            counts[get_index (value)] += 1;
+            if ((num == 0) || (value < min))
+            {
+                min = value;
+            }
+            if ((num == 0) || (value > max))
+            {
+                max = value;
+            }
+            ++num;
+        }
+
+
+        /**
+         * @brief Returns a percentile: the upper bound of the bucket, which
+         * contains the value, but not more than the maximal value.
+         *
+         * @param[in] percentile a number from 0 to 100
+         *
+         * @return the value, 0 if the histogram is empty.
+         */
+        double get_percentile (const double percentile) const
+        {
+            if (num == 0)
+            {
+                return (0.0);
+            }
+
+            double rank = percentile / 100.0 * num;
+            if (rank < 1.0)
+            {
+                rank = 1.0;
+            }
+
+            double cumulative = 0.0;
+            for (unsigned int i = 0; i < counts.size(); ++i)
+            {
+                cumulative += counts[i];
+                if (!(cumulative < rank))
+                {
+                    const double upper = get_upper_bound (i);
+                    return ((upper < max) ? upper : max);
+                }
+            }
+            return (max);
+        }
+
+
+        /// Number of values.
+        unsigned int num;
+        ///@{
+        /// Minimal and maximal values.
+        double min;
+        double max;
+        ///@}
+
+
+    private:
+        unsigned int get_index (const double value) const
+        {
+            if (value < 1.0)
+            {
+                return (0);
+            }
+
+            // value = mantissa * 2^exponent, 0.5 <= mantissa < 1
+            int exponent;
+            const double mantissa = frexp (value, &exponent);
+            const unsigned int sub_buckets = 1 << precision_bits;
+            const unsigned int index = (exponent - 1) * sub_buckets
+                + (unsigned int) ((2.0 * mantissa - 1.0) * sub_buckets);
+
+            return ((index < counts.size()) ? index : counts.size() - 1);
+        }
+
+
+        double get_upper_bound (const unsigned int index) const
+        {
+            const unsigned int sub_buckets = 1 << precision_bits;
+            const int exponent = index / sub_buckets;
+            const double sub_bucket = index % sub_buckets;
+
+            return (ldexp (1.0 + (sub_bucket + 1.0) / sub_buckets, exponent));
+        }
+
+
+        unsigned int precision_bits;
+        vector<unsigned int> counts;
+};
+
+
+
+/**
+ * @brief Collects durations of repeated calls of a piece of code, the
+ * first calls are discarded (warmup). Usage:
+ * \verbatim
+    bench_sampler sampler (warmup, repetitions);
+    while (sampler.next())
+    {
+        // preparation, not measured
+        sampler.start();
+        // measured code
+        sampler.stop();
+    }
+   \endverbatim
+ * The overhead of the time measurement is subtracted. If the hardware
+ * counters are given, they are read outside of the timed interval.
+ */
+class bench_sampler
+{
+    public:
+        /**
+         * @param[in] warmup_ number of discarded samples
+         * @param[in] repetitions_ number of samples
+         * @param[in] counters_ hardware counters, may be NULL
+         */
+        bench_sampler (
+                const unsigned int warmup_,
+                const unsigned int repetitions_,
+                bench_counters *counters_ = NULL)
+        {
+            warmup = warmup_;
+            repetitions = repetitions_;
+            counters = counters_;
+            counter = 0;
+            start_time = 0.0;
+            samples.reserve (repetitions);
+        }
+
+
+        /**
+         * @return false, when all samples are collected.
+         */
+        bool next ()
+        {
+            return (counter < warmup + repetitions);
+        }
+
+
+        /// Starts a measurement.
+        void start ()
+        {
+            if (counters != NULL)
+            {
+                counters->start();
+            }
+            start_time = bench_time_ns();
+        }
+
+
+        /// Stops a measurement.
+        void stop ()
+        {
+            const double duration = bench_time_ns() - start_time - get_overhead();
+            if (counter >= warmup)
+            {
+                samples.push_back ((duration > 0.0) ? duration : 0.0);
+                if (counters != NULL)
+                {
+                    counters->stop (counts);
+                }
+            }
+            ++counter;
+        }
+
+
+        /**
+         * @return statistics of the samples [ns].
+         */
+        bench_stats stats () const
+        {
+            return (bench_stats (samples));
+        }
+
+
+        /**
+         * @return median duration of an empty measurement [ns].
+         */
+        static double get_overhead ()
+        {
+            static double overhead = -1.0;
+
+            if (overhead < 0.0)
+            {
+                vector<double> empty (1000);
+                for (unsigned int i = 0; i < empty.size(); ++i)
+                {
+                    const double start_ns = bench_time_ns();
+                    empty[i] = bench_time_ns() - start_ns;
+                }
+                overhead = bench_stats (empty).median;
+            }
+            return (overhead);
+        }
+
+
+        /// Durations of the calls [ns].
+        vector<double> samples;
+
+        /// Hardware counters of the calls.
+        bench_counts counts;
+
+    private:
+        unsigned int warmup;
+        unsigned int repetitions;
+        unsigned int counter;
+        double start_time;
+        bench_counters *counters;
+};
+
+
+
+/**
+ * @brief Measurements of a function collected by several samplers.
+ */
+class bench_samples
+{
+    public:
+        /**
+         * @brief Appends the measurements of a sampler.
+         *
+         * @param[in] sampler the sampler.
+         */
+        void append (const bench_sampler &sampler)
+        {
+            time_ns.insert (time_ns.end(), sampler.samples.begin(), sampler.samples.end());
+            counts.add (sampler.counts);
+        }
+
+
+        /// Durations of the calls [ns].
+        vector<double> time_ns;
+
+        /// Hardware counters of the calls.
+        bench_counts counts;
+};
+
+
+
+/****************************************
+ * Scenarios
+ ****************************************/
+
+/**
+ * @brief Straight walk with a preview window of arbitrary length.
+ */
+class init_walk : public test_init_base
+{
+    public:
+        /**
+         * @param[in] N preview window length
+         * @param[in] preview_sampling_time_ms sampling time of the preview window
+         * @param[in] num_steps number of steps
+         */
+        init_walk (
+                const unsigned int N,
+                const unsigned int preview_sampling_time_ms = 40,
+                const unsigned int num_steps = 12) :
+            test_init_base ("", false)
+        {
+            wmg = new WMG (N, preview_sampling_time_ms, 0.02);
+            par = new smpc_parameters (wmg->N, 0.252007);
+            const unsigned int ss_time_ms = 400;
+            const unsigned int ds_time_ms = 40;
+            const unsigned int ds_number = 3;
+
+            double step_x = 0.04;
+            double step_y = wmg->def_constraints.support_distance_y;
+
+
+            wmg->setFootstepParametersMS (0, 0, 0);
+            wmg->addFootstep(0.0, -step_y/2, 0.0, FS_TYPE_SS_R);
+
+            wmg->setFootstepParametersMS (3*ss_time_ms, 0, 0);
+            wmg->addFootstep(0.0, step_y/2, 0.0, FS_TYPE_DS);
+
+            wmg->setFootstepParametersMS (ss_time_ms, 0, 0);
+            wmg->addFootstep(0.0   ,  step_y/2, 0.0);
+            wmg->setFootstepParametersMS (ss_time_ms, ds_time_ms, ds_number);
+            for (unsigned int i = 0; i < num_steps; i++)
+            {
+                wmg->addFootstep(step_x, (i % 2 == 0) ? -step_y : step_y, 0.0);
+            }
+
+            // the last support must cover the preview window
+            unsigned int final_ds_time_ms = N * preview_sampling_time_ms;
+            if (final_ds_time_ms < 5*ss_time_ms)
+            {
+                final_ds_time_ms = 5*ss_time_ms;
+            }
+            wmg->setFootstepParametersMS (final_ds_time_ms, 0, 0);
+            wmg->addFootstep(0.0, (num_steps % 2 == 0) ? -step_y/2 : step_y/2, 0.0, FS_TYPE_DS);
+            wmg->setFootstepParametersMS (0, 0, 0);
+            wmg->addFootstep(0.0, (num_steps % 2 == 0) ? -step_y/2 : step_y/2, 0.0,
+                    (num_steps % 2 == 0) ? FS_TYPE_SS_R : FS_TYPE_SS_L);
+        }
+
+        ~init_walk()
+        {
+            delete wmg;
+            delete par;
+        }
+};
+
+
+
+/**
+ * @brief A copy of the parameters of a problem.
+ */
+class bench_problem
+{
+    public:
+        /**
+         * @brief Copies the parameters.
+         *
+         * @param[in] par parameters of the preview window.
+         */
+        explicit bench_problem (const smpc_parameters &par)
+        {
+            const unsigned int N = par.N;
+
+            T.assign (par.T, par.T + N);
+            h.assign (par.h, par.h + N);
+            h0 = par.h0;
+            angle.assign (par.angle, par.angle + N);
+            zref_x.assign (par.zref_x, par.zref_x + N);
+            zref_y.assign (par.zref_y, par.zref_y + N);
+            fp_x.assign (par.fp_x, par.fp_x + N);
+            fp_y.assign (par.fp_y, par.fp_y + N);
+            lb.assign (par.lb, par.lb + 2*N);
+            ub.assign (par.ub, par.ub + 2*N);
+            init_state = par.init_state;
+        }
+
+
+        /**
+         * @brief Sets the problem in a solver.
+         *
+         * @param[in,out] solver the solver
+         * @param[out] X initial feasible point / solution (N*SMPC_NUM_VAR)
+         */
+        void set (smpc::solver &solver, double *X) const
+        {
+            solver.set_parameters (&T[0], &h[0], h0, &angle[0], &zref_x[0], &zref_y[0], &lb[0], &ub[0]);
+            solver.form_init_fp (&fp_x[0], &fp_y[0], init_state, X);
+        }
+
+
+        ///@{
+        /// Parameters, see smpc_parameters.
+        vector<double> T;
+        vector<double> h;
+        double h0;
+        vector<double> angle;
+        vector<double> zref_x;
+        vector<double> zref_y;
+        vector<double> fp_x;
+        vector<double> fp_y;
+        vector<double> lb;
+        vector<double> ub;
+        smpc::state_com init_state;
+        ///@}
+};
+
+
+
+/**
+ * @brief Simulates walking and captures the problems.
+ *
+ * @param[in,out] scenario the scenario
+ * @param[in] max_num maximal number of captured problems, they are
+ *  evenly distributed over the walk.
+ * @param[out] problems the problems
+ * @param[in] sim_solver the solver used in the simulation, if NULL, the AS
+ *  solver with the default parameters is used.
+ */
+inline void bench_capture_problems (
+        test_init_base &scenario,
+        const unsigned int max_num,
+        vector<bench_problem> &problems,
+        smpc::solver *sim_solver = NULL)
+{
+    vector<bench_problem> all;
+    smpc::solver *solver = sim_solver;
+    if (sim_solver == NULL)
+    {
+        solver = new smpc::solver_as (scenario.wmg->N);
+    }
+
+    while (scenario.wmg->formPreviewWindow(*scenario.par) != WMG_HALT)
+    {
+        all.push_back (bench_problem (*scenario.par));
+
+        all.back().set (*solver, scenario.par->X);
+        solver->solve();
+        solver->get_next_state(scenario.par->init_state);
+    }
+
+    if (sim_solver == NULL)
+    {
+        delete solver;
+    }
+
+    problems.clear();
+    const unsigned int num = (all.size() < max_num) ? all.size() : max_num;
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        problems.push_back (all[i * all.size() / num]);
+    }
+}
+
+
+
+/****************************************
+ * Output
+ ****************************************/
+
+/**
+ * @brief Results of a benchmark.
+ */
+class bench_report
+{
+    public:
+        /**
+         * @param[in] benchmark_ name of the benchmark
+         */
+        explicit bench_report (const string &benchmark_)
+        {
+            benchmark = benchmark_;
+        }
+
+
+        /**
+         * @brief Starts a new record.
+         *
+         * @param[in] name name of the measured entity
+         * @param[in] N length of the preview window
+         */
+        void add_record (const string &name, const unsigned int N)
+        {
+            records.push_back (record());
+            records.back().name = name;
+            records.back().N = N;
+        }
+
+
+        /**
+         * @brief Adds a metric to the last record.
+         *
+         * @param[in] metric name of the metric
+         * @param[in] value value
+         */
+        void add_metric (const string &metric, const double value)
+        {
+            records.back().metrics.push_back (make_pair (metric, value));
+        }
+
+
+        /**
+         * @brief Adds statistics of time measurements to the last record.
+         *
+         * @param[in] stats statistics [ns].
+         */
+        void add_time (const bench_stats &stats)
+        {
+            add_metric ("median_ns", stats.median);
+            add_metric ("mad_ns", stats.mad);
+            add_metric ("min_ns", stats.min);
+            add_metric ("max_ns", stats.max);
+            add_metric ("samples", stats.samples);
+        }
+
+
+        /**
+         * @brief Adds percentiles of the time measurements and the jitter
+         * (the difference between the 99th percentile and the median) to
+         * the last record, see also #add_time.
+         *
+         * @param[in] histogram histogram of the measurements [ns].
+         */
+        void add_percentiles (const bench_histogram &histogram)
+        {
+            add_metric ("p50_ns", histogram.get_percentile (50.0));
+            add_metric ("p90_ns", histogram.get_percentile (90.0));
+            add_metric ("p99_ns", histogram.get_percentile (99.0));
+            add_metric ("p99.9_ns", histogram.get_percentile (99.9));
+            add_metric ("jitter_ns", histogram.get_percentile (99.0) - histogram.get_percentile (50.0));
+        }
+
+
+        /**
+         * @brief Adds the hardware counters per call and the number of
+         * instructions per cycle to the last record, nothing is added if
+         * the counters are not available.
+         *
+         * @param[in] counts the counts
+         * @param[in] counters the counters, which were used, may be NULL
+         */
+        void add_counts (const bench_counts &counts, const bench_counters *counters)
+        {
+            if ((counters == NULL) || (counts.calls == 0))
+            {
+                return;
+            }
+
+            for (int i = 0; i < BENCH_EVENT_NUM; ++i)
+            {
+                const bench_event event = static_cast<bench_event>(i);
+                if (counters->available (event))
+                {
+                    add_metric (bench_counters::get_name (event), counts.values[i] / counts.calls);
+                }
+            }
+            if (counters->available (BENCH_EVENT_CYCLES)
+                    && counters->available (BENCH_EVENT_INSTRUCTIONS)
+                    && (counts.values[BENCH_EVENT_CYCLES] > 0.0))
+            {
+                add_metric ("ipc", counts.values[BENCH_EVENT_INSTRUCTIONS] / counts.values[BENCH_EVENT_CYCLES]);
+            }
+        }
+
+
+        /**
+         * @brief Prints the records as a table.
+         *
+         * @param[in] out output stream
+         */
+        void print (FILE *out) const
+        {
+            for (unsigned int i = 0; i < records.size(); ++i)
+            {
+                fprintf (out, "%-32s N = %4u", records[i].name.c_str(), records[i].N);
+                for (unsigned int j = 0; j < records[i].metrics.size(); ++j)
+                {
+                    fprintf (out, "  %s = %g",
+                            records[i].metrics[j].first.c_str(),
+                            records[i].metrics[j].second);
+                }
+                fprintf (out, "\n");
+            }
+        }
+
+
+        /**
+         * @brief Writes the records in JSON format.
+         *
+         * @param[in] filename name of the file
+         *
+         * @return false on failure.
+         */
+        bool write_json (const string &filename) const
+        {
+            FILE *out = fopen (filename.c_str(), "w");
+            if (out == NULL)
+            {
+                fprintf(stderr, "Cannot open file (for writing): %s\n", filename.c_str());
+                return (false);
+            }
+
+            fprintf (out, "{\n\"benchmark\": \"%s\",\n\"results\": [\n", benchmark.c_str());
+            for (unsigned int i = 0; i < records.size(); ++i)
+            {
+                fprintf (out, "{\"name\": \"%s\", \"N\": %u", records[i].name.c_str(), records[i].N);
+                for (unsigned int j = 0; j < records[i].metrics.size(); ++j)
+                {
+                    fprintf (out, ", \"%s\": %.9g",
+                            records[i].metrics[j].first.c_str(),
+                            records[i].metrics[j].second);
+                }
+                fprintf (out, "}%s\n", (i + 1 < records.size()) ? "," : "");
+            }
+            fprintf (out, "]\n}\n");
+
+            fclose (out);
+            return (true);
+        }
+
+
+    private:
+        class record
+        {
+            public:
+                string name;
+                unsigned int N;
+                vector< pair<string, double> > metrics;
+        };
+
+        string benchmark;
+        vector<record> records;
+};
+
+///@}
+#endif /*BENCH_COMMON_H*/
@@ -0,0 +1,732 @@
+/**
+ * @file
+ * @author agent
+ * @brief Compares the results of the benchmarks (the JSON files written
+ *  with -j) with a baseline, prints a table of the differences and exits
+ *  with status 1 if some metric is worse than the baseline by more than its
+ *  tolerance, or if a result from the baseline is missing.
+ *
+ * The baseline is a JSON file with the merged results of the benchmarks,
+ * relative tolerances of the checked metrics and optional absolute
+ * tolerances, which prevent false alarms due to noise in short measurements:
+ * \verbatim
+    {
+    "tolerances": {"median_ns": 0.5, "mean_added": 0.05, "allocations": 0, ...},
+    "abs_tolerances": {"median_ns": 50},
+    "results": [
+    {"benchmark": "bench_smpc", "name": "scenario_10_as", "N": 40, "median_ns": 12345, ...},
+    ...
+    ]
+    }
+   \endverbatim
+ * A metric is worse if it is greater than baseline + max(tolerance *
+ * baseline, absolute tolerance), i.e. only the metrics, for which smaller
+ * values are better, may be checked.
+ *
+ * The times depend on the machine, hence the baseline is not stored in the
+ * repository and must be generated locally ('make perf-baseline').
+ *
+ * Usage:
+ *  - bench_compare <baseline> <results>... -- compare;
+ *  - bench_compare -w <baseline> <results>... -- write a new baseline, the
+ *    tolerances are kept if the baseline exists;
+ *  - bench_compare -c <baseline> -- check that the baseline exists, this is
+ *    done before the benchmarks are run by 'make perf-check'.
+ */
+
+
+#include <cstring> // strcmp
+#include <cstdlib> // strtod
+#include <cmath> // fabs
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <utility> // pair
+
+using namespace std;
+
+///@addtogroup gBENCH
+///@{
+
+/// A list of named values.
+typedef vector< pair<string, double> > perf_metrics;
+
+
+/**
+ * @brief A result of a benchmark.
+ */
+class perf_record
+{
+    public:
+        perf_record ()
+        {
+            N = 0;
+        }
+
+
+        /**
+         * @param[in] metric name of a metric
+         *
+         * @return pointer to the value or NULL if there is no such metric.
+         */
+        const double * find (const string &metric) const
+        {
+            for (unsigned int i = 0; i < metrics.size(); ++i)
+            {
+                if (metrics[i].first == metric)
+                {
+                    return (&metrics[i].second);
+                }
+            }
+            return (NULL);
+        }
+
+
+        /**
+         * @return true if the records are results of the same measurement.
+         */
+        bool matches (const perf_record &record) const
+        {
+            return ((benchmark == record.benchmark) && (name == record.name) && (N == record.N));
+        }
+
+
+        string benchmark;
+        string name;
+        unsigned int N;
+        perf_metrics metrics;
+};
+
+
+
+/**
+ * @brief A reader of the JSON files written by bench_report and by this
+ * program. It supports only the subset of JSON used by them: nested objects
+ * and arrays, strings without escape sequences and numbers.
+ */
+class perf_json_reader
+{
+    public:
+        /**
+         * @param[in] filename_ name of the file (for error messages)
+         */
+        explicit perf_json_reader (const string &filename_)
+        {
+            filename = filename_;
+            pos = 0;
+        }
+
+
+        /**
+         * @brief Reads the file.
+         *
+         * @return false on failure.
+         */
+        bool load ()
+        {
+            FILE *file = fopen (filename.c_str(), "r");
+            if (file == NULL)
+            {
+                fprintf(stderr, "Cannot open file (for reading): %s\n", filename.c_str());
+                return (false);
+            }
+
+            char buffer[4096];
+            size_t size;
+            while ((size = fread (buffer, 1, sizeof(buffer), file)) > 0)
+            {
+                text.append (buffer, size);
+            }
+            fclose (file);
+            return (true);
+        }
+
+
+        /**
+         * @brief Parses the results and the tolerances.
+         *
+         * @param[in,out] records the records are appended.
+         * @param[out] tolerances the tolerances, if the file contains them.
+         * @param[out] abs_tolerances the absolute tolerances, if the file
+         *  contains them.
+         *
+         * @return false on failure.
+         */
+        bool parse (
+                vector<perf_record> &records,
+                perf_metrics &tolerances,
+                perf_metrics &abs_tolerances)
+        {
+            string benchmark;
+            const unsigned int first = records.size();
+            string key;
+
+            if (!expect ('{'))
+            {
+                return (false);
+            }
+            while (next_key (key))
+            {
+                if (key == "benchmark")
+                {
+                    if (!read_string (benchmark))
+                    {
+                        return (false);
+                    }
+                }
+                else if ((key == "tolerances") || (key == "abs_tolerances"))
+                {
+                    perf_record record;
+                    if (!read_record (record))
+                    {
+                        return (false);
+                    }
+                    if (key == "tolerances")
+                    {
+                        tolerances = record.metrics;
+                    }
+                    else
+                    {
+                        abs_tolerances = record.metrics;
+                    }
+                }
+                else if (key == "results")
+                {
+                    if (!expect ('['))
+                    {
+                        return (false);
+                    }
+                    while (!peek (']'))
+                    {
+                        records.push_back (perf_record());
+                        if (!read_record (records.back()) || (!peek (']') && !expect (',')))
+                        {
+                            return (false);
+                        }
+                    }
+                    expect (']');
+                }
+                else if (!skip_value())
+                {
+                    return (false);
+                }
+            }
+            if (!expect ('}'))
+            {
+                return (false);
+            }
+
+            // the records written by bench_report do not contain the name of
+            // the benchmark
+            for (unsigned int i = first; i < records.size(); ++i)
+            {
+                if (records[i].benchmark.empty())
+                {
+                    records[i].benchmark = benchmark;
+                }
+            }
+            return (true);
+        }
+
+
+    private:
+        /**
+         * @brief Reads an object with string and numeric members.
+         */
+        bool read_record (perf_record &record)
+        {
+            string key;
+
+            if (!expect ('{'))
+            {
+                return (false);
+            }
+            while (next_key (key))
+            {
+                skip_space();
+                if (key == "benchmark")
+                {
+                    if (!read_string (record.benchmark))
+                    {
+                        return (false);
+                    }
+                }
+                else if (key == "name")
+                {
+                    if (!read_string (record.name))
+                    {
+                        return (false);
+                    }
+                }
+                else if ((pos < text.size()) && (text[pos] == '"'))
+                {
+                    string ignored;
+                    if (!read_string (ignored))
+                    {
+                        return (false);
+                    }
+                }
+                else
+                {
+                    double value;
+                    if (!read_number (value))
+                    {
+                        return (false);
+                    }
+                    if (key == "N")
+                    {
+                        record.N = (unsigned int) value;
+                    }
+                    else
+                    {
+                        record.metrics.push_back (make_pair (key, value));
+                    }
+                }
+            }
+            return (expect ('}'));
+        }
+
+
+        /**
+         * @brief Reads the key of the next member of an object.
+         *
+         * @return false at the end of the object.
+         */
+        bool next_key (string &key)
+        {
+            if (peek ('}'))
+            {
+                return (false);
+            }
+            if (peek (','))
+            {
+                ++pos;
+            }
+            return (read_string (key) && expect (':'));
+        }
+
+
+        bool skip_value ()
+        {
+            skip_space();
+            if (pos >= text.size())
+            {
+                return (error());
+            }
+
+            const char c = text[pos];
+            if (c == '"')
+            {
+                string ignored;
+                return (read_string (ignored));
+            }
+            if ((c == '{') || (c == '['))
+            {
+                const char end = (c == '{') ? '}' : ']';
+                ++pos;
+                while (!peek (end))
+                {
+                    if (peek (','))
+                    {
+                        ++pos;
+                    }
+                    if ((c == '{') && !(skip_value() && expect (':')))
+                    {
+                        return (false);
+                    }
+                    if (!skip_value())
+                    {
+                        return (false);
+                    }
+                }
+                return (expect (end));
+            }
+            double ignored;
+            return (read_number (ignored));
+        }
+
+
+        bool read_string (string &value)
+        {
+            if (!expect ('"'))
+            {
+                return (false);
+            }
+            const size_t end = text.find ('"', pos);
+            if (end == string::npos)
+            {
+                return (error());
+            }
+            value = text.substr (pos, end - pos);
+            pos = end + 1;
+            return (true);
+        }
+
+
+        bool read_number (double &value)
+        {
+            skip_space();
+            const char *start = text.c_str() + pos;
+            char *end;
+            value = strtod (start, &end);
+            if (end == start)
+            {
+                return (error());
+            }
+            pos += end - start;
+            return (true);
+        }
+
+
+        void skip_space ()
+        {
+            while ((pos < text.size())
+                    && ((text[pos] == ' ') || (text[pos] == '\n') || (text[pos] == '\r') || (text[pos] == '\t')))
+            {
+                ++pos;
+            }
+        }
+
+
+        bool peek (const char c)
+        {
+            skip_space();
+            return ((pos < text.size()) && (text[pos] == c));
+        }
+
+
+        bool expect (const char c)
+        {
+            if (!peek (c))
+            {
+                return (error());
+            }
+            ++pos;
+            return (true);
+        }
+
+
+        bool error () const
+        {
+            fprintf (stderr, "Cannot parse %s at offset %u\n", filename.c_str(), (unsigned int) pos);
+            return (false);
+        }
+
+
+        string filename;
+        string text;
+        size_t pos;
+};
+
+
+
+/**
+ * @brief Checks that the baseline exists.
+ *
+ * @param[in] filename name of the file
+ *
+ * @return false if the file cannot be opened.
+ */
+bool baseline_exists (const string &filename)
+{
+    FILE *file = fopen (filename.c_str(), "r");
+    if (file == NULL)
+    {
+        return (false);
+    }
+    fclose (file);
+    return (true);
+}
+
+
+
+/**
+ * @brief Loads a JSON file.
+ *
+ * @param[in] filename name of the file
+ * @param[in,out] records the records are appended
+ * @param[out] tolerances the tolerances, if the file contains them
+ * @param[out] abs_tolerances the absolute tolerances, if the file contains them
+ *
+ * @return false on failure.
+ */
+bool load (
+        const string &filename,
+        vector<perf_record> &records,
+        perf_metrics &tolerances,
+        perf_metrics &abs_tolerances)
+{
+    perf_json_reader reader (filename);
+    return (reader.load() && reader.parse (records, tolerances, abs_tolerances));
+}
+
+
+
+/**
+ * @brief Writes named values as a JSON object.
+ *
+ * @param[in] out output file
+ * @param[in] metrics the values
+ */
+void write_metrics (FILE *out, const perf_metrics &metrics)
+{
+    fprintf (out, "{");
+    for (unsigned int i = 0; i < metrics.size(); ++i)
+    {
+        fprintf (out, "%s\"%s\": %g", (i > 0) ? ", " : "", metrics[i].first.c_str(), metrics[i].second);
+    }
+    fprintf (out, "}");
+}
+
+
+
+/**
+ * @param[in] metrics named values
+ * @param[in] name a name
+ *
+ * @return the value or 0 if it is not found.
+ */
+double get_metric (const perf_metrics &metrics, const string &name)
+{
+    for (unsigned int i = 0; i < metrics.size(); ++i)
+    {
+        if (metrics[i].first == name)
+        {
+            return (metrics[i].second);
+        }
+    }
+    return (0.0);
+}
+
+
+
+/**
+ * @brief Writes a baseline.
+ *
+ * @param[in] filename name of the file
+ * @param[in] records the results
+ * @param[in] tolerances the tolerances
+ * @param[in] abs_tolerances the absolute tolerances
+ *
+ * @return false on failure.
+ */
+bool write_baseline (
+        const string &filename,
+        const vector<perf_record> &records,
+        const perf_metrics &tolerances,
+        const perf_metrics &abs_tolerances)
+{
+    FILE *out = fopen (filename.c_str(), "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Cannot open file (for writing): %s\n", filename.c_str());
+        return (false);
+    }
+
+    fprintf (out, "{\n\"tolerances\": ");
+    write_metrics (out, tolerances);
+    fprintf (out, ",\n\"abs_tolerances\": ");
+    write_metrics (out, abs_tolerances);
+    fprintf (out, ",\n\"results\": [\n");
+    for (unsigned int i = 0; i < records.size(); ++i)
+    {
+        fprintf (out, "{\"benchmark\": \"%s\", \"name\": \"%s\", \"N\": %u",
+                records[i].benchmark.c_str(), records[i].name.c_str(), records[i].N);
+        for (unsigned int j = 0; j < records[i].metrics.size(); ++j)
+        {
+            fprintf (out, ", \"%s\": %.9g",
+                    records[i].metrics[j].first.c_str(),
+                    records[i].metrics[j].second);
+        }
+        fprintf (out, "}%s\n", (i + 1 < records.size()) ? "," : "");
+    }
+    fprintf (out, "]\n}\n");
+
+    fclose (out);
+    return (true);
+}
+
+
+
+/**
+ * @brief Compares the results with the baseline and prints the table.
+ *
+ * @param[in] baseline the baseline
+ * @param[in] results the results
+ * @param[in] tolerances the tolerances
+ * @param[in] abs_tolerances the absolute tolerances
+ *
+ * @return false if there are regressions or missing results.
+ */
+bool compare (
+        const vector<perf_record> &baseline,
+        const vector<perf_record> &results,
+        const perf_metrics &tolerances,
+        const perf_metrics &abs_tolerances)
+{
+    unsigned int num_checked = 0;
+    unsigned int num_regressions = 0;
+    unsigned int num_improvements = 0;
+    unsigned int num_missing = 0;
+
+    printf ("%-14s %-40s %5s %-22s %12s %12s %8s %6s  %s\n",
+            "benchmark", "name", "N", "metric", "baseline", "current", "change", "tol", "status");
+
+    for (unsigned int i = 0; i < baseline.size(); ++i)
+    {
+        const perf_record *result = NULL;
+        for (unsigned int j = 0; j < results.size(); ++j)
+        {
+            if (results[j].matches (baseline[i]))
+            {
+                result = &results[j];
+                break;
+            }
+        }
+
+        for (unsigned int j = 0; j < tolerances.size(); ++j)
+        {
+            const string &metric = tolerances[j].first;
+            const double tolerance = tolerances[j].second;
+            const double *base_value = baseline[i].find (metric);
+            if (base_value == NULL)
+            {
+                continue;
+            }
+            double margin = tolerance * fabs(*base_value);
+            if (margin < get_metric (abs_tolerances, metric))
+            {
+                margin = get_metric (abs_tolerances, metric);
+            }
+            const double *value = (result != NULL) ? result->find (metric) : NULL;
+
+            const char *status = "ok";
+            ++num_checked;
+            if (value == NULL)
+            {
+                status = "MISSING";
+                ++num_missing;
+            }
+            else if (*value > *base_value + margin)
+            {
+                status = "REGRESSION";
+                ++num_regressions;
+            }
+            else if (*value < *base_value - margin)
+            {
+                status = "improved";
+                ++num_improvements;
+            }
+
+            printf ("%-14s %-40s %5u %-22s %12.6g ",
+                    baseline[i].benchmark.c_str(), baseline[i].name.c_str(), baseline[i].N,
+                    metric.c_str(), *base_value);
+            if (value == NULL)
+            {
+                printf ("%12s %8s", "-", "-");
+            }
+            else if (fabs(*base_value) > 0.0)
+            {
+                printf ("%12.6g %+7.1f%%", *value, (*value - *base_value) / fabs(*base_value) * 100.0);
+            }
+            else
+            {
+                printf ("%12.6g %8s", *value, "-");
+            }
+            printf (" %5.0f%%  %s\n", tolerance * 100.0, status);
+        }
+    }
+
+    printf ("\nChecked %u metrics: %u regressions, %u improvements, %u missing.\n",
+            num_checked, num_regressions, num_improvements, num_missing);
+    if (num_improvements > 0)
+    {
+        printf ("Update the baseline (make perf-baseline) to keep the improvements.\n");
+    }
+
+    return ((num_regressions == 0) && (num_missing == 0));
+}
+
+
+
+int main(int argc, char **argv)
+{
+    if ((argc == 3) && (strcmp (argv[1], "-c") == 0))
+    {
+        if (!baseline_exists (argv[2]))
+        {
+            fprintf (stderr, "No baseline %s: the times depend on the machine, "
+                    "run 'make perf-baseline' on this machine first.\n", argv[2]);
+            return (1);
+        }
+        return (0);
+    }
+
+    const bool write = (argc > 1) && (strcmp (argv[1], "-w") == 0);
+    const int first_arg = write ? 2 : 1;
+    if (argc < first_arg + 2)
+    {
+        fprintf (stderr,
+                "Usage: %s <baseline> <results>...    compare the results with the baseline\n"
+                "       %s -w <baseline> <results>... write a new baseline\n"
+                "       %s -c <baseline>              check that the baseline exists\n",
+                argv[0], argv[0], argv[0]);
+        return (1);
+    }
+    const string baseline_filename = argv[first_arg];
+
+
+    vector<perf_record> results;
+    perf_metrics ignored;
+    for (int i = first_arg + 1; i < argc; ++i)
+    {
+        if (!load (argv[i], results, ignored, ignored))
+        {
+            return (1);
+        }
+    }
+
+    vector<perf_record> baseline;
+    perf_metrics tolerances;
+    perf_metrics abs_tolerances;
+    if (write)
+    {
+        // keep the tolerances of the existing baseline
+        if (baseline_exists (baseline_filename))
+        {
+            if (!load (baseline_filename, baseline, tolerances, abs_tolerances))
+            {
+                return (1);
+            }
+        }
+        if (tolerances.empty())
+        {
+            tolerances.push_back (make_pair (string("median_ns"), 0.5));
+            tolerances.push_back (make_pair (string("mean_added"), 0.05));
+            tolerances.push_back (make_pair (string("mean_removed"), 0.05));
+            tolerances.push_back (make_pair (string("mean_active_set_size"), 0.05));
+            tolerances.push_back (make_pair (string("mean_ext_iterations"), 0.05));
+            tolerances.push_back (make_pair (string("mean_int_iterations"), 0.05));
+            tolerances.push_back (make_pair (string("mean_bs_iterations"), 0.05));
+            tolerances.push_back (make_pair (string("allocations"), 0.0));
+
+            abs_tolerances.push_back (make_pair (string("median_ns"), 50.0));
+        }
+        return (write_baseline (baseline_filename, results, tolerances, abs_tolerances) ? 0 : 1);
+    }
+
+
+    if (!load (baseline_filename, baseline, tolerances, abs_tolerances))
+    {
+        return (1);
+    }
+    if (tolerances.empty())
+    {
+        fprintf (stderr, "The baseline does not define tolerances: %s\n", baseline_filename.c_str());
+        return (1);
+    }
+
+    return (compare (baseline, results, tolerances, abs_tolerances) ? 0 : 1);
+}
+
+///@}
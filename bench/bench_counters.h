@@ -0,0 +1,325 @@
+/**
+ * @file
+ * @author agent
+ * @brief Hardware performance counters (Linux perf_event_open): cycles,
+ *  instructions, misses of L1 data cache and of the last level cache, branch
+ *  misses.
+ *
+ * The counters are optional: if they are not supported by the system or not
+ * permitted (see /proc/sys/kernel/perf_event_paranoid), the benchmarks report
+ * only the time.
+ */
+
+
+#ifndef BENCH_COUNTERS_H
+#define BENCH_COUNTERS_H
+
+#include <cstdio>
+#include <cstring> // memset, strerror
+#include <cerrno>
+
+#ifdef __linux__
+#include <stdint.h>
+#include <unistd.h> // read, close, syscall
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+///@addtogroup gBENCH
+///@{
+
+/// Measured events.
+enum bench_event
+{
+    BENCH_EVENT_CYCLES = 0,
+    BENCH_EVENT_INSTRUCTIONS = 1,
+    BENCH_EVENT_L1D_MISSES = 2,
+    BENCH_EVENT_LLC_MISSES = 3,
+    BENCH_EVENT_BRANCH_MISSES = 4,
+    BENCH_EVENT_NUM = 5
+};
+
+
+
+/**
+ * @brief Values of the counters accumulated over several measured calls.
+ */
+class bench_counts
+{
+    public:
+        bench_counts ()
+        {
+            for (int i = 0; i < BENCH_EVENT_NUM; ++i)
+            {
+                values[i] = 0.0;
+            }
+            calls = 0;
+        }
+
+
+        /**
+         * @brief Adds the counts of other calls.
+         *
+         * @param[in] counts the counts.
+         */
+        void add (const bench_counts &counts)
+        {
+            for (int i = 0; i < BENCH_EVENT_NUM; ++i)
+            {
+                values[i] += counts.values[i];
+            }
+            calls += counts.calls;
+        }
+
+
+        /// Sums of the counters.
+        double values[BENCH_EVENT_NUM];
+
+        /// The number of measured calls.
+        unsigned int calls;
+};
+
+
+
+/**
+ * @brief A group of hardware counters of the calling thread, user space
+ * only. Usage:
+ * \verbatim
+    bench_counters counters;
+    bench_counts counts;
+
+    counters.start();
+    // measured code
+    counters.stop(counts);
+   \endverbatim
+ * All counters are read using one system call, the counters are scaled if
+ * they were multiplexed.
+ */
+class bench_counters
+{
+    public:
+        /**
+         * @brief Opens the counters, failures are reported to stderr.
+         */
+        bench_counters ()
+        {
+            for (int i = 0; i < BENCH_EVENT_NUM; ++i)
+            {
+                fd[i] = -1;
+                start_values[i] = 0.0;
+            }
+            num_open = 0;
+            group_fd = -1;
+
+#ifdef __linux__
+            const uint32_t types[BENCH_EVENT_NUM] = {
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HW_CACHE,
+                PERF_TYPE_HARDWARE,
+                PERF_TYPE_HARDWARE};
+            const uint64_t configs[BENCH_EVENT_NUM] = {
+                PERF_COUNT_HW_CPU_CYCLES,
+                PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_L1D
+                    | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                PERF_COUNT_HW_CACHE_MISSES,
+                PERF_COUNT_HW_BRANCH_MISSES};
+
+            for (int i = 0; i < BENCH_EVENT_NUM; ++i)
+            {
+                perf_event_attr attr;
+                memset (&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = types[i];
+                attr.config = configs[i];
+                attr.disabled = (group_fd == -1) ? 1 : 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP
+                    | PERF_FORMAT_TOTAL_TIME_ENABLED
+                    | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+                fd[i] = syscall (__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+                if (fd[i] == -1)
+                {
+                    fprintf (stderr, "Performance counter '%s' is not available: %s\n",
+                            get_name (static_cast<bench_event>(i)), strerror (errno));
+                    if (group_fd == -1)
+                    {
+                        // the others would fail for the same reason
+                        break;
+                    }
+                }
+                else
+                {
+                    if (group_fd == -1)
+                    {
+                        group_fd = fd[i];
+                    }
+                    ++num_open;
+                }
+            }
+
+            if (group_fd != -1)
+            {
+                ioctl (group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl (group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+#else
+            fprintf (stderr, "Performance counters are supported only on Linux.\n");
+#endif
+        }
+
+
+        ~bench_counters ()
+        {
+#ifdef __linux__
+            for (int i = 0; i < BENCH_EVENT_NUM; ++i)
+            {
+                if (fd[i] != -1)
+                {
+                    close (fd[i]);
+                }
+            }
+#endif
+        }
+
+
+        /**
+         * @return true if at least one counter is available.
+         */
+        bool available () const
+        {
+            return (num_open > 0);
+        }
+
+
+        /**
+         * @param[in] event an event
+         *
+         * @return true if the counter of the event is available.
+         */
+        bool available (const bench_event event) const
+        {
+            return (fd[event] != -1);
+        }
+
+
+        /// Starts a measurement.
+        void start ()
+        {
+            read_values (start_values);
+        }
+
+
+        /**
+         * @brief Stops a measurement.
+         *
+         * @param[in,out] counts the differences are added to these counts.
+         */
+        void stop (bench_counts &counts)
+        {
+            double stop_values[BENCH_EVENT_NUM];
+
+            if (read_values (stop_values))
+            {
+                for (int i = 0; i < BENCH_EVENT_NUM; ++i)
+                {
+                    counts.values[i] += stop_values[i] - start_values[i];
+                }
+                ++counts.calls;
+            }
+        }
+
+
+        /**
+         * @brief Returns the name of an event.
+         *
+         * @param[in] event the event
+         *
+         * @return a static string.
+         */
+        static const char *get_name (const bench_event event)
+        {
+            switch (event)
+            {
+                case BENCH_EVENT_CYCLES:
+                    return ("cycles");
+                case BENCH_EVENT_INSTRUCTIONS:
+                    return ("instructions");
+                case BENCH_EVENT_L1D_MISSES:
+                    return ("l1d_misses");
+                case BENCH_EVENT_LLC_MISSES:
+                    return ("llc_misses");
+                case BENCH_EVENT_BRANCH_MISSES:
+                    return ("branch_misses");
+                default:
+                    return ("unknown");
+            }
+        }
+
+
+    private:
+        /**
+         * @brief Reads the values of the counters.
+         *
+         * @param[out] values the values, zero for unavailable counters.
+         *
+         * @return false on failure.
+         */
+        bool read_values (double *values) const
+        {
+            for (int i = 0; i < BENCH_EVENT_NUM; ++i)
+            {
+                values[i] = 0.0;
+            }
+
+#ifdef __linux__
+            if (group_fd == -1)
+            {
+                return (false);
+            }
+
+            // nr, time_enabled, time_running, values
+            uint64_t buffer[3 + BENCH_EVENT_NUM];
+            const ssize_t size = read (group_fd, buffer, sizeof(buffer));
+            if ((size < (ssize_t) (3 * sizeof(uint64_t))) || (buffer[2] == 0))
+            {
+                return (false);
+            }
+
+            // the counters are multiplexed, if there are not enough of them
+            const double scale = (double) buffer[1] / buffer[2];
+            for (int i = 0, j = 3; (i < BENCH_EVENT_NUM) && (j < (int) (3 + buffer[0])); ++i)
+            {
+                if (fd[i] != -1)
+                {
+                    values[i] = buffer[j] * scale;
+                    ++j;
+                }
+            }
+            return (true);
+#else
+            return (false);
+#endif
+        }
+
+
+        /// File descriptors of the counters, -1 if a counter is not available.
+        int fd[BENCH_EVENT_NUM];
+
+        /// The leader of the group.
+        int group_fd;
+
+        /// The number of open counters.
+        int num_open;
+
+        /// Values at the start of a measurement.
+        double start_values[BENCH_EVENT_NUM];
+};
+
+///@}
+#endif /*BENCH_COUNTERS_H*/
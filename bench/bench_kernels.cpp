@@ -0,0 +1,457 @@
+/**
+ * @file
+ * @author agent
+ * @brief Microbenchmarks of the internal functions of the solvers. The
+ *  problems are captured from a simulated walk for several lengths of the
+ *  preview window.
+ *
+ * Usage: bench_kernels [-N <N>]... [-r <repetitions>] [-w <warmup>]
+ *  [-p <number of problems>] [-j <json file>] [-e]
+ *
+ * -e enables hardware performance counters, see bench_counters.
+ */
+
+
+#include <cstring> // strcmp
+#include <cstdlib> // atoi
+
+#include "bench_common.h"
+#include "kernel_access.h"
+
+///@addtogroup gBENCH
+///@{
+
+/**
+ * @brief Measures the internal functions of the solvers, they are called
+ * through #kernel_access.
+ */
+class kernel_bench
+{
+    public:
+        /**
+         * @param[in] warmup_ number of discarded calls of each function
+         * @param[in] repetitions_ number of measured calls for each problem
+         * @param[in] counters_ hardware counters, may be NULL
+         */
+        kernel_bench (
+                const unsigned int warmup_,
+                const unsigned int repetitions_,
+                bench_counters *counters_)
+        {
+            warmup = warmup_;
+            repetitions = repetitions_;
+            counters = counters_;
+        }
+
+
+        /**
+         * @brief Measures the functions using the given problems.
+         *
+         * @param[in] problems the problems
+         * @param[in,out] report the results
+         */
+        void run (const vector<bench_problem> &problems, bench_report &report)
+        {
+            const unsigned int N = problems[0].T.size();
+
+            bench_samples as_ecL_form;
+            bench_samples as_solve_forward;
+            bench_samples as_solve_backward;
+            bench_samples as_update;
+            bench_samples as_downdate;
+            bench_samples as_check_blocking;
+            bench_samples ip_ecL_form;
+            bench_samples ip_grad_i2hess;
+            bench_samples ip_chol_solve;
+            bench_samples ip_decrement;
+            bench_samples ip_init_alpha;
+            bench_samples ip_bs_alpha_obj_dX;
+            bench_samples ip_phi_X_tmp;
+
+            smpc::solver_as AS_solver (N);
+            smpc::solver_ip IP_solver (N);
+            vector<double> X (N*SMPC_NUM_VAR);
+
+            for (unsigned int i = 0; i < problems.size(); ++i)
+            {
+                run_as (problems[i], AS_solver, &X[0],
+                        as_ecL_form, as_solve_forward, as_solve_backward,
+                        as_update, as_downdate, as_check_blocking);
+                run_ip (problems[i], IP_solver, &X[0],
+                        ip_ecL_form, ip_grad_i2hess, ip_chol_solve,
+                        ip_decrement, ip_init_alpha, ip_bs_alpha_obj_dX, ip_phi_X_tmp);
+            }
+
+            add (report, "AS::matrix_ecL::form", N, as_ecL_form);
+            add (report, "AS::matrix_ecL::solve_forward", N, as_solve_forward);
+            add (report, "AS::matrix_ecL::solve_backward", N, as_solve_backward);
+            add (report, "AS::chol_solve::update", N, as_update);
+            add (report, "AS::chol_solve::downdate", N, as_downdate);
+            add (report, "qp_as::check_blocking_constraints", N, as_check_blocking);
+            add (report, "IP::matrix_ecL::form", N, ip_ecL_form);
+            add (report, "qp_ip::form_grad_i2hess_logbar", N, ip_grad_i2hess);
+            add (report, "IP::chol_solve::solve", N, ip_chol_solve);
+            add (report, "qp_ip::form_decrement", N, ip_decrement);
+            add (report, "qp_ip::init_alpha", N, ip_init_alpha);
+            add (report, "qp_ip::form_bs_alpha_obj_dX", N, ip_bs_alpha_obj_dX);
+            add (report, "qp_ip::form_phi_X_tmp", N, ip_phi_X_tmp);
+        }
+
+
+    private:
+        /**
+         * @brief Adds a record to the report.
+         */
+        void add (
+                bench_report &report,
+                const string &name,
+                const unsigned int N,
+                const bench_samples &samples) const
+        {
+            report.add_record (name, N);
+            report.add_time (bench_stats (samples.time_ns));
+            report.add_counts (samples.counts, counters);
+        }
+
+
+        /**
+         * @brief Measures the functions of the active set method. The
+         * active set of the solution is used for updates and downdates
+         * of the Cholesky factor.
+         */
+        void run_as (
+                const bench_problem &problem,
+                smpc::solver_as &solver,
+                double *X,
+                bench_samples &ecL_form,
+                bench_samples &solve_forward,
+                bench_samples &solve_backward,
+                bench_samples &update,
+                bench_samples &downdate,
+                bench_samples &check_blocking)
+        {
+            qp_as &qp = *solver.qp_sol;
+            const int N = qp.N;
+
+
+            // the active set of the solution
+            problem.set (solver, X);
+            solver.solve();
+            const vector<AS::constraint> active_set = kernel_access::active_set (qp);
+
+
+            // the initial state of the solver, see qp_as::solve()
+            problem.set (solver, X);
+            for (int i = 0; i < N; ++i)
+            {
+                X[i*SMPC_NUM_STATE_VAR]     -= problem.zref_x[i];
+                X[i*SMPC_NUM_STATE_VAR + 3] -= problem.zref_y[i];
+            }
+            kernel_access::chol_solve (qp, X);
+
+
+            // L for equality constraints
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    kernel_access::form_ecL (qp);
+                    sampler.stop();
+                }
+                ecL_form.append (sampler);
+            }
+
+
+            // substitutions
+            {
+                vector<double> orig (X, X + N*SMPC_NUM_STATE_VAR);
+                vector<double> vec (orig.size());
+
+                bench_sampler sampler_fw (warmup, repetitions, counters);
+                while (sampler_fw.next())
+                {
+                    vec = orig;
+                    sampler_fw.start();
+                    kernel_access::solve_forward (qp, &vec[0]);
+                    sampler_fw.stop();
+                }
+                solve_forward.append (sampler_fw);
+
+                bench_sampler sampler_bw (warmup, repetitions, counters);
+                while (sampler_bw.next())
+                {
+                    vec = orig;
+                    sampler_bw.start();
+                    kernel_access::solve_backward (qp, &vec[0]);
+                    sampler_bw.stop();
+                }
+                solve_backward.append (sampler_bw);
+            }
+
+
+            // search of blocking constraints, all constraints are inactive.
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    const int ind = kernel_access::check_blocking_constraints (qp);
+                    sampler.stop();
+
+                    if (ind != -1)
+                    {
+                        kernel_access::remove_added_constraint (qp, ind);
+                    }
+                }
+                check_blocking.append (sampler);
+            }
+
+
+            // update and downdate of L for inequality constraints, the last
+            // update is measured, since it is the most expensive
+            const int nW = active_set.size();
+            if (nW > 0)
+            {
+                bench_sampler sampler_up (warmup, repetitions, counters);
+                while (sampler_up.next())
+                {
+                    for (int i = 0; i < nW - 1; ++i)
+                    {
+                        kernel_access::update (qp, active_set[i], i);
+                    }
+                    sampler_up.start();
+                    kernel_access::update (qp, active_set[nW - 1], nW - 1);
+                    sampler_up.stop();
+                }
+                update.append (sampler_up);
+
+
+                // removal of the first constraint is the most expensive
+                bench_sampler sampler_down (warmup, repetitions, counters);
+                while (sampler_down.next())
+                {
+                    for (int i = 0; i < nW; ++i)
+                    {
+                        kernel_access::update (qp, active_set[i], i);
+                    }
+                    sampler_down.start();
+                    kernel_access::downdate (qp, nW - 1, 0, X);
+                    sampler_down.stop();
+                }
+                downdate.append (sampler_down);
+            }
+        }
+
+
+        /**
+         * @brief Measures the functions of the interior-point method
+         * (one Newton step at the initial point).
+         */
+        void run_ip (
+                const bench_problem &problem,
+                smpc::solver_ip &solver,
+                double *X,
+                bench_samples &ecL_form,
+                bench_samples &grad_i2hess,
+                bench_samples &chol_solve,
+                bench_samples &decrement,
+                bench_samples &init_alpha,
+                bench_samples &bs_alpha_obj_dX,
+                bench_samples &phi_X_tmp)
+        {
+            qp_ip &qp = *solver.qp_sol;
+            const double kappa = 1/kernel_access::get_t (qp);
+
+            problem.set (solver, X);
+
+
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    kernel_access::form_grad_i2hess_logbar (qp, kappa);
+                    sampler.stop();
+                }
+                grad_i2hess.append (sampler);
+            }
+
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    kernel_access::form_ecL (qp);
+                    sampler.stop();
+                }
+                ecL_form.append (sampler);
+            }
+
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    kernel_access::chol_solve (qp);
+                    sampler.stop();
+                }
+                chol_solve.append (sampler);
+            }
+
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    kernel_access::form_decrement (qp);
+                    sampler.stop();
+                }
+                decrement.append (sampler);
+            }
+
+            double alpha = 0.0;
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    alpha = kernel_access::init_alpha (qp);
+                    sampler.stop();
+                }
+                init_alpha.append (sampler);
+            }
+
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    kernel_access::form_bs_alpha_obj_dX (qp);
+                    sampler.stop();
+                }
+                bs_alpha_obj_dX.append (sampler);
+            }
+
+            {
+                bench_sampler sampler (warmup, repetitions, counters);
+                while (sampler.next())
+                {
+                    sampler.start();
+                    kernel_access::form_phi_X_tmp (qp, kappa, alpha);
+                    sampler.stop();
+                }
+                phi_X_tmp.append (sampler);
+            }
+        }
+
+
+        unsigned int warmup;
+        unsigned int repetitions;
+        bench_counters *counters;
+};
+
+
+
+int main(int argc, char **argv)
+{
+    vector<unsigned int> N_list;
+    unsigned int repetitions = 200;
+    unsigned int warmup = 20;
+    unsigned int num_problems = 16;
+    string json_filename;
+    bool use_counters = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp (argv[i], "-N") == 0) && (i + 1 < argc))
+        {
+            N_list.push_back (atoi (argv[++i]));
+        }
+        else if ((strcmp (argv[i], "-r") == 0) && (i + 1 < argc))
+        {
+            repetitions = atoi (argv[++i]);
+        }
+        else if ((strcmp (argv[i], "-w") == 0) && (i + 1 < argc))
+        {
+            warmup = atoi (argv[++i]);
+        }
+        else if ((strcmp (argv[i], "-p") == 0) && (i + 1 < argc))
+        {
+            num_problems = atoi (argv[++i]);
+        }
+        else if ((strcmp (argv[i], "-j") == 0) && (i + 1 < argc))
+        {
+            json_filename = argv[++i];
+        }
+        else if (strcmp (argv[i], "-e") == 0)
+        {
+            use_counters = true;
+        }
+        else
+        {
+            fprintf (stderr, "Usage: %s [-N <N>]... [-r <repetitions>] [-w <warmup>] [-p <problems>] [-j <json file>] [-e]\n", argv[0]);
+            return (1);
+        }
+    }
+    if (N_list.empty())
+    {
+        const unsigned int default_N[] = {15, 40, 80, 160};
+        N_list.assign (default_N, default_N + sizeof(default_N)/sizeof(default_N[0]));
+    }
+    if ((repetitions == 0) || (num_problems == 0))
+    {
+        fprintf (stderr, "The numbers of repetitions and problems must be positive.\n");
+        return (1);
+    }
+
+
+    bench_counters *counters = NULL;
+    if (use_counters)
+    {
+        counters = new bench_counters;
+        if (!counters->available())
+        {
+            fprintf (stderr, "Hardware counters are disabled, only the time is measured.\n");
+            delete counters;
+            counters = NULL;
+        }
+    }
+
+
+    bench_report report ("bench_kernels");
+    kernel_bench bench (warmup, repetitions, counters);
+
+    for (unsigned int i = 0; i < N_list.size(); ++i)
+    {
+        init_walk scenario (N_list[i]);
+        vector<bench_problem> problems;
+
+        bench_capture_problems (scenario, num_problems, problems);
+        if (problems.empty())
+        {
+            fprintf (stderr, "No problems for N = %u\n", N_list[i]);
+            if (counters != NULL)
+            {
+                delete counters;
+            }
+            return (1);
+        }
+        bench.run (problems, report);
+    }
+
+    if (counters != NULL)
+    {
+        delete counters;
+    }
+
+    printf ("Timer overhead (subtracted): %g ns\n", bench_sampler::get_overhead());
+    report.print (stdout);
+    if (!json_filename.empty() && !report.write_json (json_filename))
+    {
+        return (1);
+    }
+
+    return (0);
+}
+///@}
@@ -0,0 +1,371 @@
+/**
+ * @file
+ * @author agent
+ * @brief Replays the problems recorded using smpc::problem_recorder (e.g.
+ *  'bench_smpc -R' or a controller) with a configurable solver: measures the
+ *  time of each problem, counts iterations, saves the solutions and compares
+ *  them with the solutions of another run. The problems are independent and
+ *  are solved in parallel if OpenMP is enabled.
+ *
+ * Run without arguments to get the list of options.
+ */
+
+
+#include <cstdlib> // atoi, atof
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "bench_common.h"
+
+///@addtogroup gBENCH
+///@{
+
+/**
+ * @brief Configuration of a replay.
+ */
+class replay_config
+{
+    public:
+        replay_config()
+        {
+            use_ip = false;
+            repetitions = 10;
+            max_error = 1e-8;
+
+            gains_set = false;
+            gain_position = 2000.0;
+            gain_velocity = 150.0;
+            gain_acceleration = 0.02;
+            gain_jerk = 1.0;
+            tol = -1.0;
+        }
+
+
+        /**
+         * @brief Parses the arguments.
+         *
+         * @return false on failure.
+         */
+        bool parse (int argc, char **argv)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                const string opt = argv[i];
+
+                if ((opt == "-g") && (i + 4 < argc))
+                {
+                    gains_set = true;
+                    gain_position = atof (argv[++i]);
+                    gain_velocity = atof (argv[++i]);
+                    gain_acceleration = atof (argv[++i]);
+                    gain_jerk = atof (argv[++i]);
+                }
+                else if (i + 1 >= argc)
+                {
+                    return (false);
+                }
+                else if (opt == "-l")
+                {
+                    log_filename = argv[++i];
+                }
+                else if (opt == "-S")
+                {
+                    const string solver = argv[++i];
+                    if ((solver != "as") && (solver != "ip"))
+                    {
+                        return (false);
+                    }
+                    use_ip = (solver == "ip");
+                }
+                else if (opt == "-r")
+                {
+                    repetitions = atoi (argv[++i]);
+                }
+                else if (opt == "-o")
+                {
+                    solutions_filename = argv[++i];
+                }
+                else if (opt == "-d")
+                {
+                    reference_filename = argv[++i];
+                }
+                else if (opt == "-j")
+                {
+                    json_filename = argv[++i];
+                }
+                else if (opt == "--tol")
+                {
+                    tol = atof (argv[++i]);
+                }
+                else if (opt == "--max-error")
+                {
+                    max_error = atof (argv[++i]);
+                }
+                else
+                {
+                    return (false);
+                }
+            }
+
+            if (tol < 0.0)
+            {
+                tol = use_ip ? 1e-3 : 1e-7;
+            }
+            if (use_ip && !gains_set)
+            {
+                gain_acceleration = 0.01;
+            }
+
+            return ((repetitions > 0) && !log_filename.empty());
+        }
+
+
+        /**
+         * @brief Creates the solver.
+         *
+         * @param[in] N length of the preview window
+         *
+         * @return the solver.
+         */
+        smpc::solver * make_solver (const int N) const
+        {
+            if (use_ip)
+            {
+                return (new smpc::solver_ip (
+                            N, gain_position, gain_velocity, gain_acceleration, gain_jerk, tol));
+            }
+            else
+            {
+                return (new smpc::solver_as (
+                            N, gain_position, gain_velocity, gain_acceleration, gain_jerk, tol));
+            }
+        }
+
+
+        ///@{
+        /// Options, see #usage.
+        string log_filename;
+        bool use_ip;
+        unsigned int repetitions;
+        string solutions_filename;
+        string reference_filename;
+        string json_filename;
+        double max_error;
+
+        bool gains_set;
+        double gain_position;
+        double gain_velocity;
+        double gain_acceleration;
+        double gain_jerk;
+        double tol;
+        ///@}
+};
+
+
+
+/**
+ * @brief Prints the list of options.
+ */
+void usage (const char *name)
+{
+    fprintf (stderr,
+            "Usage: %s -l <log> [options]\n"
+            "  -l <file>         log of problems, see 'bench_smpc -R'\n"
+            "  -S <as|ip>        solver, default as\n"
+            "  -r <num>          number of repetitions, default 10\n"
+            "  -g <a> <b> <g> <e> gains (position, velocity, acceleration, jerk)\n"
+            "  --tol <tol>       tolerance, default 1e-7 (AS) or 1e-3 (IP)\n"
+            "  -o <file>         save the solutions (binary)\n"
+            "  -d <file>         compare the solutions with the solutions saved using -o,\n"
+            "                    the exit status is 1 if they differ\n"
+            "  --max-error <e>   allowed difference of the solutions, default 1e-8\n"
+            "  -j <file>         output summary in JSON format\n",
+            name);
+}
+
+
+
+/**
+ * @brief Reads or writes the solutions.
+ *
+ * @param[in] filename name of the file
+ * @param[in,out] solutions the solutions
+ * @param[in] write write if true, read otherwise
+ *
+ * @return false on failure.
+ */
+bool exchange_solutions (const string &filename, vector<double> &solutions, const bool write)
+{
+    FILE *file = fopen (filename.c_str(), write ? "wb" : "rb");
+    if (file == NULL)
+    {
+        fprintf(stderr, "Cannot open file (for %s): %s\n", write ? "writing" : "reading", filename.c_str());
+        return (false);
+    }
+
+    const size_t size = write ?
+        fwrite (&solutions[0], sizeof(double), solutions.size(), file) :
+        fread (&solutions[0], sizeof(double), solutions.size(), file);
+    fclose (file);
+
+    if (size != solutions.size())
+    {
+        fprintf(stderr, "Wrong size of the file: %s\n", filename.c_str());
+        return (false);
+    }
+    return (true);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    replay_config config;
+    if ((argc < 2) || !config.parse (argc, argv))
+    {
+        usage (argv[0]);
+        return (1);
+    }
+
+    smpc::problem_log log;
+    if (!log.open (config.log_filename.c_str()))
+    {
+        return (1);
+    }
+    const unsigned int num_problems = log.size;
+    const unsigned int num_var = log.N * SMPC_NUM_VAR;
+    if (num_problems == 0)
+    {
+        fprintf(stderr, "The log is empty: %s\n", config.log_filename.c_str());
+        return (1);
+    }
+
+
+    vector<double> solutions (num_problems * num_var);
+    // all repetitions of a problem are stored together
+    vector<double> time_ns (num_problems * config.repetitions);
+    vector<double> iterations (num_problems * 3);
+    unsigned int num_threads = 1;
+
+    const double start_ns = bench_time_ns();
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+#ifdef _OPENMP
+#pragma omp master
+        num_threads = omp_get_num_threads();
+#endif
+
+        // solvers are not shared by the threads
+        smpc::solver *solver = config.make_solver (log.N);
+
+#ifdef _OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+        for (int i = 0; i < (int) num_problems; ++i)
+        {
+            double *X = &solutions[i * num_var];
+            for (unsigned int rep = 0; rep < config.repetitions; ++rep)
+            {
+                const double problem_start_ns = bench_time_ns();
+                log.replay (i, *solver, X);
+                solver->solve();
+                time_ns[i * config.repetitions + rep] = bench_time_ns() - problem_start_ns;
+            }
+
+            if (config.use_ip)
+            {
+                const smpc::solver_ip *ip = static_cast<smpc::solver_ip *>(solver);
+                iterations[i*3]     = ip->ext_loop_iterations;
+                iterations[i*3 + 1] = ip->int_loop_iterations;
+                iterations[i*3 + 2] = ip->bt_search_iterations;
+            }
+            else
+            {
+                const smpc::solver_as *as = static_cast<smpc::solver_as *>(solver);
+                iterations[i*3]     = as->added_constraints_num;
+                iterations[i*3 + 1] = as->removed_constraints_num;
+                iterations[i*3 + 2] = as->active_set_size;
+            }
+        }
+
+        delete solver;
+    }
+    const double wall_ns = bench_time_ns() - start_ns;
+
+
+    // summary
+    double mean_iterations[3] = {0.0, 0.0, 0.0};
+    for (unsigned int i = 0; i < num_problems; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            mean_iterations[j] += iterations[i*3 + j] / num_problems;
+        }
+    }
+
+    bench_report report ("bench_replay");
+    report.add_record (string("replay") + (config.use_ip ? "_ip" : "_as"), log.N);
+    report.add_time (bench_stats (time_ns));
+    bench_histogram histogram;
+    for (unsigned int i = 0; i < time_ns.size(); ++i)
+    {
+        histogram.add (time_ns[i]);
+    }
+    report.add_percentiles (histogram);
+    report.add_metric ("problems", num_problems);
+    report.add_metric ("threads", num_threads);
+    report.add_metric ("problems_per_s", num_problems * config.repetitions / (wall_ns * 1e-9));
+    report.add_metric (config.use_ip ? "mean_ext_iterations" : "mean_added", mean_iterations[0]);
+    report.add_metric (config.use_ip ? "mean_int_iterations" : "mean_removed", mean_iterations[1]);
+    report.add_metric (config.use_ip ? "mean_bs_iterations" : "mean_active_set_size", mean_iterations[2]);
+
+    bool result = true;
+    if (!config.reference_filename.empty())
+    {
+        vector<double> reference (solutions.size());
+        if (exchange_solutions (config.reference_filename, reference, false))
+        {
+            double max_error = 0.0;
+            unsigned int worst_problem = 0;
+            for (unsigned int i = 0; i < solutions.size(); ++i)
+            {
+                const double err = fabs(solutions[i] - reference[i]);
+                if (err > max_error)
+                {
+                    max_error = err;
+                    worst_problem = i / num_var;
+                }
+            }
+            report.add_metric ("max_error", max_error);
+
+            if (max_error > config.max_error)
+            {
+                fprintf (stderr, "The solutions differ from the reference: error %g in problem %u\n",
+                        max_error, worst_problem);
+                result = false;
+            }
+        }
+        else
+        {
+            result = false;
+        }
+    }
+
+    report.print (stdout);
+    if (!config.solutions_filename.empty() && !exchange_solutions (config.solutions_filename, solutions, true))
+    {
+        result = false;
+    }
+    if (!config.json_filename.empty() && !report.write_json (config.json_filename))
+    {
+        result = false;
+    }
+
+    return (result ? 0 : 1);
+}
+
+///@}
@@ -0,0 +1,616 @@
+/**
+ * @file
+ * @author agent
+ * @brief Scaling of the solvers with the length of the preview window: the
+ *  time of a solution and the memory are measured for a straight walk with
+ *  N from 10 to 2000 and fitted to power laws (c * N^k). The number of
+ *  iterations depends on the problem, hence the time of an iteration (a
+ *  Newton step of the IP solver, a change of the active set of the AS solver)
+ *  is fitted separately, the solver is flagged as super-linear if it grows
+ *  faster than N^k_max. The local exponents between the consecutive values
+ *  of N are reported as well, since they show where the growth changes, e.g.
+ *  when the working set leaves a cache.
+ *
+ * The problems are captured from a simulation with the IP solver, which is
+ * cheaper than the AS solver for long preview windows.
+ *
+ * Run with -h to get the list of options.
+ */
+
+
+#include <cstdlib> // atoi, atof
+#include <unistd.h> // sysconf
+
+#include "bench_common.h"
+
+///@addtogroup gBENCH
+///@{
+
+/// Number of levels of caches, which are taken into account.
+#define BENCH_CACHE_LEVELS 3
+
+
+/**
+ * @brief Least squares fit of a power law y = coefficient * x^exponent in
+ * logarithmic coordinates.
+ */
+class power_law_fit
+{
+    public:
+        /**
+         * @param[in] x arguments (positive)
+         * @param[in] y values (positive)
+         */
+        power_law_fit (const vector<double> &x, const vector<double> &y)
+        {
+            exponent = 0.0;
+            coefficient = 0.0;
+            r2 = 0.0;
+
+            const unsigned int num = x.size();
+            if (num < 2)
+            {
+                return;
+            }
+
+            double mean_x = 0.0;
+            double mean_y = 0.0;
+            for (unsigned int i = 0; i < num; ++i)
+            {
+                mean_x += log(x[i]) / num;
+                mean_y += log(y[i]) / num;
+            }
+
+            double sxx = 0.0;
+            double sxy = 0.0;
+            double syy = 0.0;
+            for (unsigned int i = 0; i < num; ++i)
+            {
+                const double dx = log(x[i]) - mean_x;
+                const double dy = log(y[i]) - mean_y;
+                sxx += dx*dx;
+                sxy += dx*dy;
+                syy += dy*dy;
+            }
+            if (!(sxx > 0.0))
+            {
+                return;
+            }
+
+            exponent = sxy / sxx;
+            coefficient = exp(mean_y - exponent * mean_x);
+            r2 = (syy > 0.0) ? sxy*sxy / (sxx*syy) : 1.0;
+        }
+
+
+        /**
+         * @brief Exponent of the power law between two points.
+         */
+        static double local_exponent (
+                const double x1, const double y1,
+                const double x2, const double y2)
+        {
+            return (log(y2 / y1) / log(x2 / x1));
+        }
+
+
+        double exponent;
+        double coefficient;
+        /// Coefficient of determination in logarithmic coordinates.
+        double r2;
+};
+
+
+
+/**
+ * @brief Sizes of the data caches (sysconf), 0 if unknown.
+ */
+class cache_sizes
+{
+    public:
+        cache_sizes ()
+        {
+            for (int i = 0; i < BENCH_CACHE_LEVELS; ++i)
+            {
+                size[i] = 0;
+            }
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+            size[0] = get (_SC_LEVEL1_DCACHE_SIZE);
+            size[1] = get (_SC_LEVEL2_CACHE_SIZE);
+            size[2] = get (_SC_LEVEL3_CACHE_SIZE);
+#endif
+        }
+
+
+        /**
+         * @param[in] bytes size of a working set
+         *
+         * @return the first level of cache, which can hold the working set,
+         * BENCH_CACHE_LEVELS + 1 stands for the main memory.
+         */
+        int get_level (const double bytes) const
+        {
+            for (int i = 0; i < BENCH_CACHE_LEVELS; ++i)
+            {
+                if ((size[i] > 0) && (bytes <= size[i]))
+                {
+                    return (i + 1);
+                }
+            }
+            return (BENCH_CACHE_LEVELS + 1);
+        }
+
+
+        /**
+         * @param[in] level a level returned by #get_level
+         *
+         * @return a static string.
+         */
+        static const char *get_name (const int level)
+        {
+            const char *names[BENCH_CACHE_LEVELS + 1] = {"L1", "L2", "L3", "RAM"};
+            return (names[level - 1]);
+        }
+
+
+        /// Sizes in bytes.
+        long size[BENCH_CACHE_LEVELS];
+
+
+    private:
+        static long get (const int name)
+        {
+            const long value = sysconf (name);
+            return ((value > 0) ? value : 0);
+        }
+};
+
+
+
+/**
+ * @brief Measurements of a solver for one length of the preview window.
+ */
+class scaling_point
+{
+    public:
+        scaling_point ()
+        {
+            N = 0;
+            memory_bytes = 0.0;
+            working_set_bytes = 0.0;
+            iterations = 0.0;
+            iteration_ns = 0.0;
+            truncated = false;
+        }
+
+
+        unsigned int N;
+        /// Time of a solution (set_parameters, form_init_fp, solve).
+        bench_stats time;
+        /// Memory allocated by the solver (memory_footprint()).
+        double memory_bytes;
+        /**
+         * Estimated working set: the memory without the rows of the
+         * inverted Cholesky factor, which are not used by the AS solver.
+         */
+        double working_set_bytes;
+        /// Mean number of added and removed constraints (AS) or Newton steps (IP).
+        double iterations;
+        /// Mean time of an iteration.
+        double iteration_ns;
+        /// true if the time limit was reached.
+        bool truncated;
+};
+
+
+
+/**
+ * @brief Configuration of the benchmark.
+ */
+class scaling_config
+{
+    public:
+        scaling_config ()
+        {
+            run_as = true;
+            run_ip = true;
+            num_problems = 8;
+            repetitions = 3;
+            max_time_s = 10.0;
+            max_memory_mb = 1024.0;
+            max_exponent = 1.2;
+            check = false;
+        }
+
+
+        /**
+         * @brief Parses the arguments.
+         *
+         * @return false on failure.
+         */
+        bool parse (int argc, char **argv)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                const string opt = argv[i];
+
+                if (opt == "--check")
+                {
+                    check = true;
+                }
+                else if (i + 1 >= argc)
+                {
+                    return (false);
+                }
+                else if (opt == "-N")
+                {
+                    N_list.push_back (atoi (argv[++i]));
+                    if (N_list.back() < 2)
+                    {
+                        return (false);
+                    }
+                }
+                else if (opt == "-S")
+                {
+                    const string solver = argv[++i];
+                    run_as = (solver == "as") || (solver == "both");
+                    run_ip = (solver == "ip") || (solver == "both");
+                    if (!run_as && !run_ip)
+                    {
+                        return (false);
+                    }
+                }
+                else if (opt == "-p")
+                {
+                    num_problems = atoi (argv[++i]);
+                }
+                else if (opt == "-r")
+                {
+                    repetitions = atoi (argv[++i]);
+                }
+                else if (opt == "-t")
+                {
+                    max_time_s = atof (argv[++i]);
+                }
+                else if (opt == "-m")
+                {
+                    max_memory_mb = atof (argv[++i]);
+                }
+                else if (opt == "-k")
+                {
+                    max_exponent = atof (argv[++i]);
+                }
+                else if (opt == "-j")
+                {
+                    json_filename = argv[++i];
+                }
+                else
+                {
+                    return (false);
+                }
+            }
+
+            if (N_list.empty())
+            {
+                const unsigned int default_N[] = {10, 20, 40, 80, 160, 320, 640, 1280, 2000};
+                N_list.assign (default_N, default_N + sizeof(default_N)/sizeof(default_N[0]));
+            }
+            return ((num_problems > 0) && (repetitions > 0));
+        }
+
+
+        ///@{
+        /// Options, see #usage.
+        vector<unsigned int> N_list;
+        bool run_as;
+        bool run_ip;
+        unsigned int num_problems;
+        unsigned int repetitions;
+        double max_time_s;
+        double max_memory_mb;
+        double max_exponent;
+        bool check;
+        string json_filename;
+        ///@}
+};
+
+
+
+/**
+ * @brief Prints the list of options.
+ */
+void usage (const char *name)
+{
+    fprintf (stderr,
+            "Usage: %s [options]\n"
+            "  -N <N>            length of the preview window, may be repeated,\n"
+            "                    default 10 20 40 80 160 320 640 1280 2000\n"
+            "  -S <as|ip|both>   solvers, default both\n"
+            "  -p <num>          number of problems for each N, default 8\n"
+            "  -r <num>          number of measured solutions of each problem, default 3\n"
+            "  -t <s>            time limit for each N, larger N are skipped,\n"
+            "                    when it is reached, default 10\n"
+            "  -m <MB>           memory limit of a solver, default 1024\n"
+            "  -k <k>            the time of an iteration must grow not faster than N^k,\n"
+            "                    default 1.2\n"
+            "  --check           exit with status 1 if it grows faster\n"
+            "  -j <file>         output in JSON format\n",
+            name);
+}
+
+
+
+/**
+ * @brief Measures a solver.
+ *
+ * @param[in] config configuration
+ * @param[in] use_ip selects the solver
+ * @param[in] problems the problems
+ * @param[out] point the results
+ */
+void measure (
+        const scaling_config &config,
+        const bool use_ip,
+        const vector<bench_problem> &problems,
+        scaling_point &point)
+{
+    const unsigned int N = problems[0].T.size();
+    vector<double> X (N*SMPC_NUM_VAR);
+    vector<double> time_ns;
+    double max_active_set_size = 0.0;
+    unsigned int num_solved = 0;
+
+    smpc::solver *solver = NULL;
+    if (use_ip)
+    {
+        solver = new smpc::solver_ip (N);
+    }
+    else
+    {
+        solver = new smpc::solver_as (N);
+    }
+
+    const double start_ns = bench_time_ns();
+    for (unsigned int i = 0; i < problems.size(); ++i)
+    {
+        bench_sampler sampler (1, config.repetitions);
+        while (sampler.next())
+        {
+            sampler.start();
+            problems[i].set (*solver, &X[0]);
+            solver->solve();
+            sampler.stop();
+        }
+        time_ns.insert (time_ns.end(), sampler.samples.begin(), sampler.samples.end());
+
+        if (use_ip)
+        {
+            point.iterations += static_cast<smpc::solver_ip *>(solver)->int_loop_iterations;
+        }
+        else
+        {
+            const smpc::solver_as *as = static_cast<smpc::solver_as *>(solver);
+            const double active_set_size = as->active_set_size;
+            point.iterations += as->added_constraints_num + as->removed_constraints_num;
+            if (active_set_size > max_active_set_size)
+            {
+                max_active_set_size = active_set_size;
+            }
+        }
+        ++num_solved;
+
+        if ((bench_time_ns() - start_ns) * 1e-9 > config.max_time_s)
+        {
+            point.truncated = (i + 1 < problems.size());
+            break;
+        }
+    }
+    delete solver;
+
+    point.N = N;
+    point.time = bench_stats (time_ns);
+    point.iterations /= num_solved;
+    // the initial feasible point is formed even if there are no iterations
+    point.iteration_ns = point.time.median / (point.iterations + 1);
+    if (use_ip)
+    {
+        point.memory_bytes = smpc::solver_ip::memory_footprint (N);
+        point.working_set_bytes = point.memory_bytes;
+    }
+    else
+    {
+        // 2*N rows of the inverted Cholesky factor are allocated, see as_chol_solve
+        point.memory_bytes = smpc::solver_as::memory_footprint (N);
+        point.working_set_bytes = point.memory_bytes
+            - (2*N - max_active_set_size) * SMPC_NUM_VAR * N * sizeof(double);
+    }
+}
+
+
+
+/**
+ * @brief Adds the results of a solver to the report, fits the power laws and
+ * prints the intervals with super-linear growth.
+ *
+ * @param[in] config configuration
+ * @param[in] name name of the solver
+ * @param[in] points the results
+ * @param[in] caches sizes of the caches
+ * @param[in,out] report the report
+ *
+ * @return false if the time of an iteration grows super-linearly.
+ */
+bool analyze (
+        const scaling_config &config,
+        const string &name,
+        const vector<scaling_point> &points,
+        const cache_sizes &caches,
+        bench_report &report)
+{
+    bool result = true;
+    vector<double> N;
+    vector<double> time_ns;
+    vector<double> iteration_ns;
+    vector<double> memory_bytes;
+    vector<double> working_set_bytes;
+
+    for (unsigned int i = 0; i < points.size(); ++i)
+    {
+        const scaling_point &point = points[i];
+        const int level = caches.get_level (point.working_set_bytes);
+
+        report.add_record (name, point.N);
+        report.add_time (point.time);
+        report.add_metric ("memory_bytes", point.memory_bytes);
+        report.add_metric ("working_set_bytes", point.working_set_bytes);
+        report.add_metric ("cache_level", level);
+        report.add_metric ("mean_iterations", point.iterations);
+        report.add_metric ("iteration_ns", point.iteration_ns);
+
+        if (i > 0)
+        {
+            const double exponent = power_law_fit::local_exponent (
+                    points[i-1].N, points[i-1].iteration_ns, point.N, point.iteration_ns);
+            report.add_metric ("local_exponent", exponent);
+            if (exponent > config.max_exponent)
+            {
+                printf ("%s: super-linear interval N %u -> %u, time of an iteration ~ N^%.2f\n",
+                        name.c_str(), points[i-1].N, point.N, exponent);
+            }
+
+            const int prev_level = caches.get_level (points[i-1].working_set_bytes);
+            if (level != prev_level)
+            {
+                printf ("%s: the working set leaves %s at N = %u (%.0f KiB)\n",
+                        name.c_str(), cache_sizes::get_name (prev_level), point.N,
+                        point.working_set_bytes / 1024);
+            }
+        }
+
+        N.push_back (point.N);
+        time_ns.push_back (point.time.median);
+        iteration_ns.push_back (point.iteration_ns);
+        memory_bytes.push_back (point.memory_bytes);
+        working_set_bytes.push_back (point.working_set_bytes);
+    }
+
+    if (points.size() > 1)
+    {
+        const power_law_fit time_fit (N, time_ns);
+        const power_law_fit iteration_fit (N, iteration_ns);
+        const power_law_fit memory_fit (N, memory_bytes);
+        const power_law_fit working_set_fit (N, working_set_bytes);
+
+        report.add_record (name + "_fit", points.back().N);
+        report.add_metric ("time_exponent", time_fit.exponent);
+        report.add_metric ("time_coefficient_ns", time_fit.coefficient);
+        report.add_metric ("time_r2", time_fit.r2);
+        report.add_metric ("iteration_exponent", iteration_fit.exponent);
+        report.add_metric ("iteration_coefficient_ns", iteration_fit.coefficient);
+        report.add_metric ("iteration_r2", iteration_fit.r2);
+        report.add_metric ("memory_exponent", memory_fit.exponent);
+        report.add_metric ("memory_coefficient_bytes", memory_fit.coefficient);
+        report.add_metric ("working_set_exponent", working_set_fit.exponent);
+
+        printf ("%s: time ~ %.3g ns * N^%.2f (r2 = %.3f), iteration ~ %.3g ns * N^%.2f (r2 = %.3f),"
+                " memory ~ %.3g B * N^%.2f, working set ~ N^%.2f\n",
+                name.c_str(),
+                time_fit.coefficient, time_fit.exponent, time_fit.r2,
+                iteration_fit.coefficient, iteration_fit.exponent, iteration_fit.r2,
+                memory_fit.coefficient, memory_fit.exponent,
+                working_set_fit.exponent);
+
+        if (iteration_fit.exponent > config.max_exponent)
+        {
+            printf ("SUPER-LINEAR %s: time of an iteration ~ N^%.2f > N^%.2f\n",
+                    name.c_str(), iteration_fit.exponent, config.max_exponent);
+            result = false;
+        }
+    }
+
+    return (result);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    scaling_config config;
+    if (!config.parse (argc, argv))
+    {
+        usage (argv[0]);
+        return (1);
+    }
+
+    const cache_sizes caches;
+    for (int i = 0; i < BENCH_CACHE_LEVELS; ++i)
+    {
+        printf ("%s: %ld KiB\n", cache_sizes::get_name (i + 1), caches.size[i] / 1024);
+    }
+
+
+    vector<scaling_point> as_points;
+    vector<scaling_point> ip_points;
+    bool as_stopped = !config.run_as;
+    bool ip_stopped = !config.run_ip;
+
+    for (unsigned int i = 0; (i < config.N_list.size()) && !(as_stopped && ip_stopped); ++i)
+    {
+        const unsigned int N = config.N_list[i];
+
+        init_walk scenario (N);
+        vector<bench_problem> problems;
+        smpc::solver_ip sim_solver (N);
+        bench_capture_problems (scenario, config.num_problems, problems, &sim_solver);
+        if (problems.empty())
+        {
+            fprintf (stderr, "No problems for N = %u\n", N);
+            return (1);
+        }
+
+        if (!as_stopped)
+        {
+            if (smpc::solver_as::memory_footprint (N) > config.max_memory_mb * 1024 * 1024)
+            {
+                printf ("as: N >= %u is skipped, memory limit\n", N);
+                as_stopped = true;
+            }
+            else
+            {
+                as_points.push_back (scaling_point());
+                measure (config, false, problems, as_points.back());
+                as_stopped = as_points.back().truncated;
+                if (as_stopped)
+                {
+                    printf ("as: N > %u is skipped, time limit\n", N);
+                }
+            }
+        }
+        if (!ip_stopped)
+        {
+            ip_points.push_back (scaling_point());
+            measure (config, true, problems, ip_points.back());
+            ip_stopped = ip_points.back().truncated;
+            if (ip_stopped)
+            {
+                printf ("ip: N > %u is skipped, time limit\n", N);
+            }
+        }
+    }
+
+
+    bench_report report ("bench_scaling");
+    bool result = true;
+    result = analyze (config, "as", as_points, caches, report) && result;
+    result = analyze (config, "ip", ip_points, caches, report) && result;
+
+    report.print (stdout);
+    if (!config.json_filename.empty() && !report.write_json (config.json_filename))
+    {
+        return (1);
+    }
+
+    return ((result || !config.check) ? 0 : 1);
+}
+
+///@}
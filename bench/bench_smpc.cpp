@@ -0,0 +1,847 @@
+/**
+ * @file
+ * @author agent
+ * @brief Closed-loop simulations of walking scenarios with a configurable
+ *  solver: measures the time of each tick, counts iterations and heap
+ *  allocations, and compares the solutions with reference data.
+ *
+ * Run without arguments to get the list of options.
+ */
+
+
+#include <cstdlib> // atoi, atof
+
+#include "bench_common.h"
+#include "bench_alloc.h"
+
+///@addtogroup gBENCH
+///@{
+
+/**
+ * @brief Configuration of a benchmark.
+ */
+class bench_config
+{
+    public:
+        bench_config()
+        {
+            scenario = "10";
+            use_ip = false;
+            N = 0;
+            control_sampling_time_ms = 0;
+            repetitions = 10;
+            fp_as_zref = false;
+            use_counters = false;
+            worst_ticks = 10;
+
+            gains_set = false;
+            gain_position = 2000.0;
+            gain_velocity = 150.0;
+            gain_acceleration = 0.02;
+            gain_jerk = 1.0;
+            tol = -1.0;
+
+            max_added_constraints_num = 0;
+            constraint_removal_on = true;
+
+            tol_out = 1e-2;
+            t = 100;
+            mu = 15;
+            bs_alpha = 0.01;
+            bs_beta = 0.5;
+            max_iter = 0;
+            bs_type = smpc::SMPC_IP_BS_LOGBAR;
+        }
+
+
+        /**
+         * @brief Parses the arguments.
+         *
+         * @return false on failure.
+         */
+        bool parse (int argc, char **argv)
+        {
+            for (int i = 1; i < argc; ++i)
+            {
+                const string opt = argv[i];
+                const bool has_value = (i + 1 < argc);
+
+                if (opt == "-u")
+                {
+                    fp_as_zref = true;
+                }
+                else if (opt == "-e")
+                {
+                    use_counters = true;
+                }
+                else if (opt == "--no-removal")
+                {
+                    constraint_removal_on = false;
+                }
+                else if ((opt == "-g") && (i + 4 < argc))
+                {
+                    gains_set = true;
+                    gain_position = atof (argv[++i]);
+                    gain_velocity = atof (argv[++i]);
+                    gain_acceleration = atof (argv[++i]);
+                    gain_jerk = atof (argv[++i]);
+                }
+                else if (!has_value)
+                {
+                    return (false);
+                }
+                else if (opt == "-s")
+                {
+                    scenario = argv[++i];
+                }
+                else if (opt == "-S")
+                {
+                    const string solver = argv[++i];
+                    if ((solver != "as") && (solver != "ip"))
+                    {
+                        return (false);
+                    }
+                    use_ip = (solver == "ip");
+                }
+                else if (opt == "-N")
+                {
+                    N = atoi (argv[++i]);
+                }
+                else if (opt == "-c")
+                {
+                    control_sampling_time_ms = atoi (argv[++i]);
+                }
+                else if (opt == "-k")
+                {
+                    worst_ticks = atoi (argv[++i]);
+                }
+                else if (opt == "-r")
+                {
+                    repetitions = atoi (argv[++i]);
+                }
+                else if (opt == "-d")
+                {
+                    reference_filename = argv[++i];
+                }
+                else if (opt == "-t")
+                {
+                    ticks_filename = argv[++i];
+                }
+                else if (opt == "-j")
+                {
+                    json_filename = argv[++i];
+                }
+                else if (opt == "-R")
+                {
+                    record_filename = argv[++i];
+                }
+                else if (opt == "-T")
+                {
+                    trace_filename = argv[++i];
+                }
+                else if (opt == "--tol")
+                {
+                    tol = atof (argv[++i]);
+                }
+                else if (opt == "--max-added")
+                {
+                    max_added_constraints_num = atoi (argv[++i]);
+                }
+                else if (opt == "--tol-out")
+                {
+                    tol_out = atof (argv[++i]);
+                }
+                else if (opt == "--t")
+                {
+                    t = atof (argv[++i]);
+                }
+                else if (opt == "--mu")
+                {
+                    mu = atof (argv[++i]);
+                }
+                else if (opt == "--bs-alpha")
+                {
+                    bs_alpha = atof (argv[++i]);
+                }
+                else if (opt == "--bs-beta")
+                {
+                    bs_beta = atof (argv[++i]);
+                }
+                else if (opt == "--max-iter")
+                {
+                    max_iter = atoi (argv[++i]);
+                }
+                else if (opt == "--bs")
+                {
+                    const string type = argv[++i];
+                    if (type == "none")
+                    {
+                        bs_type = smpc::SMPC_IP_BS_NONE;
+                    }
+                    else if (type == "logbar")
+                    {
+                        bs_type = smpc::SMPC_IP_BS_LOGBAR;
+                    }
+                    else if (type == "original")
+                    {
+                        bs_type = smpc::SMPC_IP_BS_ORIGINAL;
+                    }
+                    else
+                    {
+                        return (false);
+                    }
+                }
+                else
+                {
+                    return (false);
+                }
+            }
+
+            if (tol < 0.0)
+            {
+                tol = use_ip ? 1e-3 : 1e-7;
+            }
+            if (use_ip && !gains_set)
+            {
+                gain_acceleration = 0.01;
+            }
+
+            return (repetitions > 0);
+        }
+
+
+        /**
+         * @brief Creates the scenario.
+         *
+         * @return the scenario or NULL if the name is not known.
+         */
+        test_init_base * make_scenario () const
+        {
+            if (scenario == "walk")
+            {
+                return (new init_walk ((N == 0) ? 40 : N));
+            }
+
+#define BENCH_SCENARIO(id, default_N) \
+            if (scenario == #id) \
+            { \
+                return (new init_##id ("", false, (N == 0) ? default_N : N)); \
+            }
+            BENCH_SCENARIO(01, 15)
+            BENCH_SCENARIO(02, 15)
+            BENCH_SCENARIO(03, 15)
+            BENCH_SCENARIO(04, 15)
+            BENCH_SCENARIO(05, 15)
+            BENCH_SCENARIO(06, 15)
+            BENCH_SCENARIO(07, 40)
+            BENCH_SCENARIO(08, 25)
+            BENCH_SCENARIO(09, 40)
+            BENCH_SCENARIO(10, 40)
+            BENCH_SCENARIO(11, 40)
+#undef BENCH_SCENARIO
+
+            return (NULL);
+        }
+
+
+        /**
+         * @brief Creates the solver.
+         *
+         * @param[in] solver_N length of the preview window
+         *
+         * @return the solver.
+         */
+        smpc::solver * make_solver (const unsigned int solver_N) const
+        {
+            if (use_ip)
+            {
+                return (new smpc::solver_ip (
+                            solver_N,
+                            gain_position, gain_velocity, gain_acceleration, gain_jerk,
+                            tol, tol_out, t, mu, bs_alpha, bs_beta, max_iter, bs_type));
+            }
+            else
+            {
+                return (new smpc::solver_as (
+                            solver_N,
+                            gain_position, gain_velocity, gain_acceleration, gain_jerk,
+                            tol, max_added_constraints_num, constraint_removal_on));
+            }
+        }
+
+
+        /**
+         * @return a short description of the configuration.
+         */
+        string describe () const
+        {
+            return ("scenario_" + scenario + (use_ip ? "_ip" : "_as"));
+        }
+
+
+        ///@{
+        /// Options, see #usage.
+        string scenario;
+        bool use_ip;
+        unsigned int N;
+        unsigned int control_sampling_time_ms;
+        unsigned int repetitions;
+        bool fp_as_zref;
+        bool use_counters;
+        unsigned int worst_ticks;
+        string reference_filename;
+        string ticks_filename;
+        string json_filename;
+        string record_filename;
+        string trace_filename;
+
+        bool gains_set;
+        double gain_position;
+        double gain_velocity;
+        double gain_acceleration;
+        double gain_jerk;
+        double tol;
+
+        unsigned int max_added_constraints_num;
+        bool constraint_removal_on;
+
+        double tol_out;
+        double t;
+        double mu;
+        double bs_alpha;
+        double bs_beta;
+        unsigned int max_iter;
+        smpc::backtrackingSearchType bs_type;
+        ///@}
+};
+
+
+
+/**
+ * @brief Prints the list of options.
+ */
+void usage (const char *name)
+{
+    fprintf (stderr,
+            "Usage: %s [options]\n"
+            "  -s <01..11|walk>  scenario (init_01 ... init_11 or a straight walk), default 10\n"
+            "  -S <as|ip>        solver, default as\n"
+            "  -N <N>            length of the preview window, default depends on the scenario\n"
+            "  -c <ms>           control sampling time, default is the preview sampling time\n"
+            "  -r <num>          number of repetitions of the simulation, default 10\n"
+            "  -g <a> <b> <g> <e> gains (position, velocity, acceleration, jerk)\n"
+            "  -u                use the feasible points as reference ZMP positions\n"
+            "  -e                measure hardware performance counters of the ticks\n"
+            "  -k <num>          number of reported slowest ticks, default 10\n"
+            "  -d <file>         reference solutions, e.g. test/data/as_states_inv_downdate.dat\n"
+            "                    (scenario 01 with -u)\n"
+            "  -t <file.csv|file.json>  output per tick\n"
+            "  -j <file>         output summary in JSON format\n"
+            "  -R <file>         record the problems of the first repetition, see bench_replay\n"
+            "  -T <file>         trace the iterations of the first repetition, the file\n"
+            "                    can be opened in chrome://tracing or Perfetto (USE_TRACE)\n"
+            "  --tol <tol>       tolerance, default 1e-7 (AS) or 1e-3 (IP)\n"
+            "AS:\n"
+            "  --max-added <num> limit the number of added constraints\n"
+            "  --no-removal      disable removal of constraints\n"
+            "IP:\n"
+            "  --tol-out <tol>   tolerance of the outer loop, default 1e-2\n"
+            "  --t <t>           logarithmic barrier parameter, default 100\n"
+            "  --mu <mu>         multiplier of t, default 15\n"
+            "  --bs-alpha <a>    backtracking search parameter alpha, default 0.01\n"
+            "  --bs-beta <b>     backtracking search parameter beta, default 0.5\n"
+            "  --max-iter <num>  maximal number of internal iterations, default 0 (no limit)\n"
+            "  --bs <none|logbar|original> backtracking search, default logbar\n",
+            name);
+}
+
+
+
+/**
+ * @brief Results of a tick.
+ */
+class bench_tick
+{
+    public:
+        /// Durations of the tick in all repetitions [ns].
+        vector<double> time_ns;
+
+        ///@{
+        /// Iterations: added/removed constraints and the size of the active
+        /// set (AS) or external/internal/backtracking iterations (IP).
+        unsigned int iterations[3];
+        ///@}
+
+        /// Maximal absolute difference with the reference solution, -1 if
+        /// there is no reference.
+        double error;
+
+        /// The type of the current support.
+        fs_type support;
+
+        /// The support foot is switched, see WMG::isSupportSwitchNeeded().
+        bool support_switch;
+
+        /// The type of the support changed (DS <-> SS).
+        bool transition;
+
+
+        /**
+         * @return a short name of the current support.
+         */
+        const char *get_support_name () const
+        {
+            switch (support)
+            {
+                case FS_TYPE_SS_L:
+                    return ("SS_L");
+                case FS_TYPE_SS_R:
+                    return ("SS_R");
+                case FS_TYPE_DS:
+                    return ("DS");
+                default:
+                    return ("AUTO");
+            }
+        }
+};
+
+
+
+/**
+ * @brief Compares indices of the ticks by the median durations (descending).
+ */
+class bench_tick_slower
+{
+    public:
+        explicit bench_tick_slower (const vector<double> &median_ns_) : median_ns (median_ns_) {}
+
+        bool operator() (const unsigned int a, const unsigned int b) const
+        {
+            return (median_ns[a] > median_ns[b]);
+        }
+
+    private:
+        const vector<double> &median_ns;
+};
+
+
+
+/**
+ * @brief Prints the slowest ticks together with the events of the gait and
+ * the iteration counts.
+ *
+ * @param[in] out output stream
+ * @param[in] config configuration
+ * @param[in] ticks results
+ */
+void print_worst_ticks (FILE *out, const bench_config &config, const vector<bench_tick> &ticks)
+{
+    vector<unsigned int> order (ticks.size());
+    vector<double> median_ns (ticks.size());
+    for (unsigned int i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+        median_ns[i] = bench_stats (ticks[i].time_ns).median;
+    }
+    const unsigned int num = (config.worst_ticks < order.size()) ? config.worst_ticks : order.size();
+    partial_sort (order.begin(), order.begin() + num, order.end(), bench_tick_slower (median_ns));
+
+    fprintf (out, "\nSlowest ticks:\n%6s %12s %12s %8s %8s %11s %14s\n",
+            "tick", "median_ns", "max_ns", "support", "switch", "transition",
+            config.use_ip ? "ext/int/bs" : "add/rem/act");
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        const bench_tick &tick = ticks[order[i]];
+        const bench_stats stats (tick.time_ns);
+        char iterations[64];
+
+        sprintf (iterations, "%u/%u/%u", tick.iterations[0], tick.iterations[1], tick.iterations[2]);
+
+        fprintf (out, "%6u %12.0f %12.0f %8s %8s %11s %14s\n",
+                order[i], stats.median, stats.max,
+                tick.get_support_name(),
+                tick.support_switch ? "yes" : "",
+                tick.transition ? "yes" : "",
+                iterations);
+    }
+}
+
+
+
+/**
+ * @brief Writes the results of the ticks.
+ *
+ * @param[in] filename name of the file, the format is defined by the extension.
+ * @param[in] config configuration
+ * @param[in] ticks results
+ *
+ * @return false on failure.
+ */
+bool write_ticks (const string &filename, const bench_config &config, const vector<bench_tick> &ticks)
+{
+    const bool json = (filename.size() > 5) && (filename.substr(filename.size() - 5) == ".json");
+    const char *iter_names[2][3] = {
+        {"added", "removed", "active_set_size"},
+        {"ext_iterations", "int_iterations", "bs_iterations"}};
+    const char **names = iter_names[config.use_ip ? 1 : 0];
+
+    FILE *out = fopen (filename.c_str(), "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "Cannot open file (for writing): %s\n", filename.c_str());
+        return (false);
+    }
+
+    if (json)
+    {
+        fprintf (out, "{\n\"configuration\": \"%s\",\n\"ticks\": [\n", config.describe().c_str());
+    }
+    else
+    {
+        fprintf (out, "tick,median_ns,min_ns,max_ns,%s,%s,%s,error,support,support_switch,transition\n", names[0], names[1], names[2]);
+    }
+
+    for (unsigned int i = 0; i < ticks.size(); ++i)
+    {
+        const bench_stats stats (ticks[i].time_ns);
+        if (json)
+        {
+            fprintf (out, "{\"tick\": %u, \"median_ns\": %.9g, \"min_ns\": %.9g, \"max_ns\": %.9g, \"%s\": %u, \"%s\": %u, \"%s\": %u, \"error\": %.9g, "
+                    "\"support\": \"%s\", \"support_switch\": %s, \"transition\": %s}%s\n",
+                    i, stats.median, stats.min, stats.max,
+                    names[0], ticks[i].iterations[0],
+                    names[1], ticks[i].iterations[1],
+                    names[2], ticks[i].iterations[2],
+                    ticks[i].error,
+                    ticks[i].get_support_name(),
+                    ticks[i].support_switch ? "true" : "false",
+                    ticks[i].transition ? "true" : "false",
+                    (i + 1 < ticks.size()) ? "," : "");
+        }
+        else
+        {
+            fprintf (out, "%u,%.9g,%.9g,%.9g,%u,%u,%u,%.9g,%s,%d,%d\n",
+                    i, stats.median, stats.min, stats.max,
+                    ticks[i].iterations[0], ticks[i].iterations[1], ticks[i].iterations[2],
+                    ticks[i].error,
+                    ticks[i].get_support_name(),
+                    ticks[i].support_switch ? 1 : 0,
+                    ticks[i].transition ? 1 : 0);
+        }
+    }
+
+    if (json)
+    {
+        fprintf (out, "]\n}\n");
+    }
+
+    fclose (out);
+    return (true);
+}
+
+
+
+int main(int argc, char **argv)
+{
+    bench_config config;
+    if ((argc < 2) || !config.parse (argc, argv))
+    {
+        usage (argv[0]);
+        return (1);
+    }
+
+
+    vector<bench_tick> ticks;
+    // sums over all ticks and repetitions
+    smpc::solve_stats phases;
+    // heap allocations in the ticks
+    unsigned long allocations = 0;
+    unsigned int N = 0;
+    vector<double> reference;
+    if (!config.reference_filename.empty())
+    {
+        ifstream ref_file (config.reference_filename.c_str());
+        if (!ref_file.is_open())
+        {
+            fprintf(stderr, "Cannot open file (for reading): %s\n", config.reference_filename.c_str());
+            return (1);
+        }
+        double value;
+        while (ref_file >> value)
+        {
+            reference.push_back (value);
+        }
+    }
+
+
+    bench_counters *counters = NULL;
+    bench_counts counts;
+    if (config.use_counters)
+    {
+        counters = new bench_counters;
+        if (!counters->available())
+        {
+            fprintf (stderr, "Hardware counters are disabled, only the time is measured.\n");
+            delete counters;
+            counters = NULL;
+        }
+    }
+
+
+    for (unsigned int rep = 0; rep < config.repetitions; ++rep)
+    {
+        test_init_base *scenario = config.make_scenario();
+        if (scenario == NULL)
+        {
+            usage (argv[0]);
+            if (counters != NULL)
+            {
+                delete counters;
+            }
+            return (1);
+        }
+        WMG &wmg = *scenario->wmg;
+        smpc_parameters &par = *scenario->par;
+
+        if (config.control_sampling_time_ms != 0)
+        {
+            // see test_08
+            wmg.T_ms[0] = config.control_sampling_time_ms;
+            wmg.T_ms[1] = config.control_sampling_time_ms;
+        }
+        N = wmg.N;
+        smpc::solver *solver = config.make_solver (N);
+
+        smpc::problem_recorder *recorder = NULL;
+        if ((rep == 0) && !config.record_filename.empty())
+        {
+            recorder = new smpc::problem_recorder (N);
+            if (!recorder->open (config.record_filename.c_str()))
+            {
+                delete recorder;
+                recorder = NULL;
+            }
+            solver->set_recorder (recorder);
+        }
+
+        smpc::trace_buffer *trace = NULL;
+        if ((rep == 0) && !config.trace_filename.empty())
+        {
+            if (!smpc::tracing_enabled())
+            {
+                fprintf (stderr, "The solver is built without USE_TRACE, the trace is empty.\n");
+            }
+            trace = new smpc::trace_buffer;
+            solver->set_trace (trace);
+        }
+        const double *zref_x = config.fp_as_zref ? par.fp_x : par.zref_x;
+        const double *zref_y = config.fp_as_zref ? par.fp_y : par.zref_y;
+
+
+        for (unsigned int tick = 0; ; ++tick)
+        {
+            // must be checked before the preview window is formed
+            const bool support_switch = wmg.isSupportSwitchNeeded();
+            if (wmg.formPreviewWindow(par) == WMG_HALT)
+            {
+                break;
+            }
+
+            if (counters != NULL)
+            {
+                counters->start();
+            }
+            const unsigned long start_allocations = bench_allocations;
+            const double start_ns = bench_time_ns();
+            solver->set_parameters (par.T, par.h, par.h0, par.angle, zref_x, zref_y, par.lb, par.ub);
+            solver->form_init_fp (par.fp_x, par.fp_y, par.init_state, par.X);
+            solver->solve();
+            const double time_ns = bench_time_ns() - start_ns;
+            allocations += bench_allocations - start_allocations;
+            if (counters != NULL)
+            {
+                counters->stop (counts);
+            }
+
+            solver->get_next_state(par.init_state);
+
+            const smpc::solve_stats &stats = config.use_ip ?
+                static_cast<smpc::solver_ip *>(solver)->stats :
+                static_cast<smpc::solver_as *>(solver)->stats;
+            for (int i = 0; i < smpc::SMPC_PHASE_NUM; ++i)
+            {
+                phases.time_ns[i] += stats.time_ns[i];
+                phases.calls[i] += stats.calls[i];
+            }
+
+
+            if (rep == 0)
+            {
+                ticks.push_back (bench_tick());
+                bench_tick &result = ticks.back();
+
+                result.support = wmg.getCurrentSupportType();
+                result.support_switch = support_switch;
+                result.transition = (tick > 0)
+                    && ((result.support == FS_TYPE_DS) != (ticks[tick - 1].support == FS_TYPE_DS));
+
+                if (config.use_ip)
+                {
+                    const smpc::solver_ip *ip = static_cast<smpc::solver_ip *>(solver);
+                    result.iterations[0] = ip->ext_loop_iterations;
+                    result.iterations[1] = ip->int_loop_iterations;
+                    result.iterations[2] = ip->bt_search_iterations;
+                }
+                else
+                {
+                    const smpc::solver_as *as = static_cast<smpc::solver_as *>(solver);
+                    result.iterations[0] = as->added_constraints_num;
+                    result.iterations[1] = as->removed_constraints_num;
+                    result.iterations[2] = as->active_set_size;
+                }
+
+                result.error = -1.0;
+                const unsigned int num_var = wmg.N*SMPC_NUM_VAR;
+                if (reference.size() >= (tick + 1) * num_var)
+                {
+                    result.error = 0.0;
+                    // the coordinates of ZMP are skipped, see test_01
+                    for (unsigned int i = 1; i < num_var; i += (i%3 == 2) ? 2 : 1)
+                    {
+                        const double err = fabs(par.X[i] - reference[tick * num_var + i]);
+                        if (err > result.error)
+                        {
+                            result.error = err;
+                        }
+                    }
+                }
+            }
+            if (tick < ticks.size())
+            {
+                ticks[tick].time_ns.push_back (time_ns);
+            }
+        }
+
+        delete solver;
+        if (recorder != NULL)
+        {
+            recorder->close();
+            fprintf (stderr, "Recorded %u problems to %s\n", recorder->num_records, config.record_filename.c_str());
+            delete recorder;
+        }
+        if (trace != NULL)
+        {
+            if (trace->write_chrome_json (config.trace_filename.c_str()))
+            {
+                fprintf (stderr, "Traced %u events (%lu added) to %s\n",
+                        trace->size(), trace->num_added, config.trace_filename.c_str());
+            }
+            delete trace;
+        }
+        // init_walk deletes them in the destructor, the tests do not
+        delete scenario->wmg;
+        delete scenario->par;
+        scenario->wmg = NULL;
+        scenario->par = NULL;
+        delete scenario;
+    }
+
+
+    // summary
+    vector<double> all_time_ns;
+    double max_error = -1.0;
+    double iterations[3] = {0.0, 0.0, 0.0};
+    for (unsigned int i = 0; i < ticks.size(); ++i)
+    {
+        all_time_ns.insert (all_time_ns.end(), ticks[i].time_ns.begin(), ticks[i].time_ns.end());
+        for (int j = 0; j < 3; ++j)
+        {
+            iterations[j] += ticks[i].iterations[j];
+        }
+        if (ticks[i].error > max_error)
+        {
+            max_error = ticks[i].error;
+        }
+    }
+
+    bench_report report ("bench_smpc");
+    report.add_record (config.describe(), N);
+    report.add_time (bench_stats (all_time_ns));
+    bench_histogram histogram;
+    for (unsigned int i = 0; i < all_time_ns.size(); ++i)
+    {
+        histogram.add (all_time_ns[i]);
+    }
+    report.add_percentiles (histogram);
+    report.add_counts (counts, counters);
+    report.add_metric ("ticks", ticks.size());
+    if (!all_time_ns.empty())
+    {
+        report.add_metric ("allocations", (double) allocations / all_time_ns.size());
+    }
+    if (!ticks.empty())
+    {
+        report.add_metric (config.use_ip ? "mean_ext_iterations" : "mean_added", iterations[0] / ticks.size());
+        report.add_metric (config.use_ip ? "mean_int_iterations" : "mean_removed", iterations[1] / ticks.size());
+        report.add_metric (config.use_ip ? "mean_bs_iterations" : "mean_active_set_size", iterations[2] / ticks.size());
+    }
+    if (!(max_error < 0.0))
+    {
+        report.add_metric ("max_error", max_error);
+    }
+    // mean durations of the phases per tick, see smpc::solve_stats
+    for (int i = 0; (i < smpc::SMPC_PHASE_NUM) && !all_time_ns.empty(); ++i)
+    {
+        if (phases.calls[i] > 0)
+        {
+            report.add_metric (
+                    string(smpc::solve_stats::get_phase_name (static_cast<smpc::solverPhase>(i))) + "_ns",
+                    phases.time_ns[i] / all_time_ns.size());
+        }
+    }
+    // latency of the ticks with the events of the gait
+    const char *event_names[4] = {"support_switch", "transition", "DS", "SS"};
+    for (int event = 0; event < 4; ++event)
+    {
+        vector<double> event_time_ns;
+        bench_histogram event_histogram;
+        for (unsigned int i = 0; i < ticks.size(); ++i)
+        {
+            const bool is_DS = (ticks[i].support == FS_TYPE_DS);
+            const bool selected[4] = {ticks[i].support_switch, ticks[i].transition, is_DS, !is_DS};
+            if (selected[event])
+            {
+                event_time_ns.insert (event_time_ns.end(), ticks[i].time_ns.begin(), ticks[i].time_ns.end());
+                for (unsigned int j = 0; j < ticks[i].time_ns.size(); ++j)
+                {
+                    event_histogram.add (ticks[i].time_ns[j]);
+                }
+            }
+        }
+        if (!event_time_ns.empty())
+        {
+            report.add_record (config.describe() + "_" + event_names[event], N);
+            report.add_time (bench_stats (event_time_ns));
+            report.add_percentiles (event_histogram);
+        }
+    }
+
+    if (counters != NULL)
+    {
+        delete counters;
+    }
+
+    report.print (stdout);
+    print_worst_ticks (stdout, config, ticks);
+    if (!config.ticks_filename.empty() && !write_ticks (config.ticks_filename, config, ticks))
+    {
+        return (1);
+    }
+    if (!config.json_filename.empty() && !report.write_json (config.json_filename))
+    {
+        return (1);
+    }
+
+    return (0);
+}
+///@}
@@ -2,7 +2,7 @@ CXX_WARN_FLAGS_EIGEN=-Wall -Wfloat-equal -std=c++98
 CXX_WARN_FLAGS=${CXX_WARN_FLAGS_EIGEN} -Wshadow -pedantic
 IFLAGS+=-I../include
 IFLAGS_EIGEN=${IFLAGS} -I/usr/local/include/eigen2/ -I/usr/include/eigen2/
-LDFLAGS+=-L../lib/ -lsmpc_solver -lwmg
+LDFLAGS+=-L../lib/ -lwmg -lsmpc_solver
 
 ifdef DEBUG
 LDFLAGS+=-pg
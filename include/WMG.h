@@ -28,6 +28,7 @@
  * TYPEDEFS 
  ****************************************/
 class footstep;
+class feetPhase;
 
 
 /// @addtogroup gWMG_API
@@ -73,8 +74,31 @@ class smpc_parameters
         ~smpc_parameters();
 
 
+        /**
+         * @brief Moves the preview window in the ring buffers by one 
+         * element, see WMG#incremental_preview_window.
+         */
+        void shiftWindow ();
+
+        /**
+         * @brief Moves the preview window to the beginning of the ring buffers.
+         */
+        void resetWindow ();
+
+        /**
+         * @brief Copies the elements of the preview window to the second half
+         * of the ring buffers.
+         *
+         * @param[in] first_ind index of the first element to be copied.
+         */
+        void mirrorWindow (const unsigned int first_ind);
+
+
 
 // variables
+        /// Preview window length.
+        unsigned int N;
+
         double hCoM;    /// Height of the CoM.
 
         double gravity; /// Norm of the acceleration due to gravity.
@@ -111,6 +135,180 @@ class smpc_parameters
 
         /// A chunk of memory allocated for solution.
         double *X;
+
+
+        /**
+         * @brief Memory for the arrays, which are filled by WMG: #T, #angle,
+         * #fp_x, #fp_y, #zref_x, #zref_y (2*N elements each), #lb and #ub 
+         * (4*N elements each). The arrays point to windows in this memory.
+         */
+        double *window_mem;
+
+        /// Offset of the preview window in the ring buffers.
+        unsigned int window_offset;
+};
+
+
+
+/**
+ * @brief A bounded single-producer single-consumer queue of footsteps,
+ * which is used to feed footsteps to WMG while walking, see 
+ * WMG#footstep_queue. The producer (e.g. a planner running in another 
+ * thread) calls #push, WMG calls #pop.
+ */
+class footstepQueue
+{
+    public:
+        /**
+         * @brief Parameters of a footstep, see WMG#setFootstepParametersMS
+         * and WMG#addFootstep.
+         */
+        struct request
+        {
+            double x_relative;
+            double y_relative;
+            double angle_relative;
+            fs_type type;
+
+            unsigned int def_time_ms;
+            unsigned int ds_time_ms;
+            unsigned int ds_number;
+            bool use_user_constraints;
+        };
+
+
+        /**
+         * @brief Allocate memory.
+         *
+         * @param[in] capacity_ maximal number of requests in the queue.
+         */
+        footstepQueue (const unsigned int capacity_);
+
+        /**
+         * @brief Default destructor
+         */
+        ~footstepQueue();
+
+
+        /**
+         * @brief Adds a request to the queue (producer side).
+         *
+         * @param[in] req request
+         *
+         * @return false if the queue is full.
+         */
+        bool push (const request &req);
+
+        /**
+         * @brief Takes a request from the queue (consumer side).
+         *
+         * @param[out] req request
+         *
+         * @return false if the queue is empty.
+         */
+        bool pop (request &req);
+
+
+    private:
+        // not copyable
+        footstepQueue (const footstepQueue&);
+        footstepQueue& operator= (const footstepQueue&);
+
+        /// capacity + 1 elements, one is always unused.
+        request *buffer;
+        unsigned int buffer_size;
+
+        /// The next request to be taken, modified by the consumer only.
+        volatile unsigned int head;
+        /// The next free element, modified by the producer only.
+        volatile unsigned int tail;
+};
+
+
+
+/**
+ * @brief A cursor for frequent queries of positions of feet, see 
+ * WMG#getFeetPositions. A cursor can be used with one WMG only.
+ */
+class feetCursor
+{
+    public:
+        /**
+         * @brief Allocate memory.
+         */
+        feetCursor ();
+
+        /**
+         * @brief Default destructor
+         */
+        ~feetCursor();
+
+
+// variables
+        /// The support found on the last query.
+        unsigned int support_number;
+
+        /// Time (ms.) of the beginning of the support from the beginning
+        /// of the first footstep.
+        unsigned int support_start_ms;
+
+        /// Version of the footsteps, for which the cursor is valid.
+        unsigned int footsteps_version;
+
+        /// Parameters of trajectories in the support.
+        feetPhase *phase;
+
+
+    private:
+        // not copyable
+        feetCursor (const feetCursor&);
+        feetCursor& operator= (const feetCursor&);
+};
+
+
+
+/**
+ * @brief Preallocated storage for evaluation of candidate positions of the
+ * next single support, see WMG#evaluateNextSSCandidates.
+ */
+class nextSSCandidates
+{
+    public:
+        /**
+         * @brief Allocate memory for the given number of candidates.
+         *
+         * @param[in] num_ number of candidates
+         * @param[in] N preview window length
+         * @param[in] hCoM Height of the Center of Mass [meter]
+         * @param[in] gravity gravity [m/s^2]
+         */
+        nextSSCandidates (
+                const unsigned int num_, 
+                const unsigned int N,
+                const double hCoM,
+                const double gravity = 9.81);
+
+        /**
+         * @brief Default destructor
+         */
+        ~nextSSCandidates();
+
+
+// variables
+        /// Number of candidates.
+        unsigned int num;
+
+        /// Parameters of the preview windows (one for each candidate).
+        std::vector<smpc_parameters *> par;
+
+        /// Values of the objective function (one for each candidate).
+        std::vector<double> objective;
+
+        /// The first controls (one for each candidate).
+        std::vector<smpc::control> first_controls;
+
+        /// Candidate footsteps.
+        std::vector<footstep *> candidate_fs;
 };
 
 
@@ -329,10 +527,59 @@ class WMG
                 fs_type type = FS_TYPE_AUTO);
 
 
+        /**
+         * @brief Adds a sequence of footsteps to FS, the result is the same
+         * as after calling #setFootstepParametersMS and #addFootstep for
+         * each of the steps (up to rounding errors).
+         *
+         * @param[in] num number of steps
+         * @param[in] steps parameters of the steps, the positions and
+         *  angles are relative to the preceding steps.
+         *
+         * @note The absolute positions of the steps are computed using a
+         * prefix scan of the relative displacements, the footsteps are
+         * formed independently. Both stages are performed in parallel if
+         * the library is built with OpenMP support. This is faster than
+         * sequential calls of #addFootstep for long plans.
+         */
+        void addFootsteps (
+                const unsigned int num,
+                const footstepQueue::request *steps);
+
+
+        /**
+         * @brief Reserves memory for footsteps in FS.
+         *
+         * @param[in] num_steps expected total number of footsteps including 
+         *  automatically generated DS, i.e. each call of #addFootstep adds
+         *  up to ds_number + 1 footsteps (see #setFootstepParametersMS).
+         */
+        void reserveFootsteps (const unsigned int num_steps);
+
+
+        /**
+         * @return number of footsteps in FS.
+         */
+        unsigned int getNumFootsteps () const;
+
+
+        /**
+         * @return type of the support at the start of the current preview
+         * window (FS_TYPE_SS_L, FS_TYPE_SS_R or FS_TYPE_DS).
+         *
+         * @attention Must be called after #formPreviewWindow.
+         */
+        fs_type getCurrentSupportType () const;
+
+
         /**
          * @brief Forms a preview window.
          *
          * @return WMG_OK or WMG_HALT (simulation must be stopped)
+         *
+         * @note If #incremental_preview_window is set, the arrays in 
+         * smpc_parameters are moved along ring buffers, i.e. the pointers
+         * change on each call.
          */
         WMGret formPreviewWindow (smpc_parameters &);
 
@@ -360,6 +607,59 @@ class WMG
                 double * right_foot_pos);
 
 
+        /**
+         * @brief Determine positions and orientations of feet for several
+         * shifts in time. The parameters of trajectories are computed once
+         * for each support.
+         *
+         * @param[in] num number of shifts
+         * @param[in] shift_from_current_ms num positive shifts in time (ms.) 
+         *  from the current time, sorted in ascending order (unsorted shifts
+         *  are allowed, but slower).
+         * @param[out] left_foot_pos num 4x4 homogeneous matrices or num 
+         *  (x, y, z, yaw) vectors, which represent position and orientation
+         * @param[out] right_foot_pos num 4x4 homogeneous matrices or num 
+         *  (x, y, z, yaw) vectors, which represent position and orientation
+         * @param[in] compact if true, (x, y, z, yaw) vectors are written 
+         *  instead of matrices.
+         *
+         * @attention The same restrictions as for the single shift version. 
+         * The evaluation is stopped at the first shift that lies beyond
+         * the last footstep.
+         */
+        void getFeetPositions (
+                const unsigned int num,
+                const unsigned int *shift_from_current_ms, 
+                double * left_foot_pos, 
+                double * right_foot_pos,
+                const bool compact = false);
+
+
+        /**
+         * @brief Determine position and orientation of feet using a cursor,
+         * which keeps the support found on the previous call and the 
+         * parameters of trajectories in this support. Consecutive calls are 
+         * fast if the time (current time + shift) does not decrease.
+         *
+         * @param[in,out] cursor cursor
+         * @param[in] shift_from_current_ms a positive shift in time (ms.) from the current time
+         * @param[out] left_foot_pos 4x4 homogeneous matrix or (x, y, z, yaw) vector,
+         *  which represents position and orientation
+         * @param[out] right_foot_pos 4x4 homogeneous matrix or (x, y, z, yaw) vector,
+         *  which represents position and orientation
+         * @param[in] compact if true, (x, y, z, yaw) vectors are written 
+         *  instead of matrices.
+         *
+         * @attention The same restrictions as for the version without cursor.
+         */
+        void getFeetPositions (
+                feetCursor &cursor,
+                const unsigned int shift_from_current_ms, 
+                double * left_foot_pos, 
+                double * right_foot_pos,
+                const bool compact = false);
+
+
         /**
          * @brief Checks if the support foot switch is needed.
          *
@@ -379,8 +679,41 @@ class WMG
         void changeNextSSPosition (const double *posture, const bool zero_z_coordinate);
 
 
+        /**
+         * @brief Evaluates candidate positions of the next SS: for each candidate
+         * the preview window is formed as if #changeNextSSPosition and 
+         * #formPreviewWindow were called, and the respective QP is solved. The 
+         * footsteps are not changed.
+         *
+         * @param[in,out] candidates preallocated storage, the values of the 
+         *  objective function and the first controls are saved here.
+         * @param[in] solvers array of candidates.num solvers (one for each 
+         *  candidate), the solvers must have the same preview window length.
+         * @param[in] postures candidates.num 4x4 homogeneous matrices (stored
+         *  one after another), see #changeNextSSPosition
+         * @param[in] zero_z_coordinate set z coordinate to 0.0
+         * @param[in] init_state the initial state
+         *
+         * @return WMG_OK or WMG_HALT (simulation must be stopped), in the
+         *  latter case the objectives of the candidates are set to HUGE_VAL
+         *  and the first controls are not changed.
+         *
+         * @note If the library is compiled with OpenMP support, the candidates
+         * are evaluated in parallel.
+         */
+        WMGret evaluateNextSSCandidates (
+                nextSSCandidates &candidates,
+                smpc::solver **solvers,
+                const double *postures, 
+                const bool zero_z_coordinate,
+                const smpc::state_com &init_state) const;
+
+
         /**
          * @brief Reposition all subsequent footsteps that are not fixed at the current moment.
+         * Only the footsteps, which have been used in the preview window, are 
+         * changed immediately, the others are translated, when they are 
+         * needed.
          *
          * @param[in] diff_x change in position along x axis
          * @param[in] diff_y change in position along y axis
@@ -399,6 +732,38 @@ class WMG
         void FS2file(const std::string filename, const bool plot_ds = true);
 
 
+        /**
+         * @brief Saves the footsteps in FS to a binary file, which can be
+         * loaded using #loadPlan.
+         *
+         * @note The progress of walking is not saved: if the plan is saved
+         * during a walk, it contains the footsteps currently stored in FS
+         * (the retired footsteps are dropped, see #footstep_queue), and the
+         * walk starts from the first of them after loading.
+         *
+         * @param[in] filename output file name.
+         *
+         * @return false on failure.
+         */
+        bool savePlan (const std::string filename) const;
+
+        /**
+         * @brief Replaces the footsteps with the footsteps from a binary 
+         * file created by #savePlan. The file is mapped to memory, the 
+         * records are copied to FS without parsing. The walk is restarted
+         * from the first footstep, #footstep_queue is detached (set to NULL),
+         * since the queued footsteps belong to the replaced plan.
+         *
+         * @param[in] filename input file name.
+         *
+         * @return false on failure (the footsteps are not changed in this case).
+         *
+         * @note The files are not portable between platforms with different
+         * byte order or size of types.
+         */
+        bool loadPlan (const std::string filename);
+
+
         /**
          * @brief Return coordinates of footstep reference points and rotation 
          * angles of footsteps (only for SS).
@@ -416,7 +781,7 @@ class WMG
 
 
 // variables
-        /// A vector of footsteps. 
+        /// A vector of footsteps, must be extended using #addFootstep only.
         std::vector<footstep> FS; 
 
 
@@ -473,18 +838,124 @@ class WMG
         double bezier_inclination_2;
         //@}
 
+
+        /**
+         * If true, the preview window is updated incrementally: on each call
+         * of #formPreviewWindow the first element is dropped and a new one is
+         * appended. The window is formed from scratch on the first call, when
+         * the existing footsteps are changed using the methods of this class
+         * (adding of footsteps does not count), or when another instance of 
+         * smpc_parameters is passed.
+         *
+         * @attention The variable sampling periods (#T_ms) are not supported
+         * in this mode, the mode is not used if they are set.
+         * @attention The footsteps must not be changed directly in #FS.
+         */
+        bool incremental_preview_window;
+
+
+        /**
+         * If not NULL, footsteps are streamed: #formPreviewWindow takes 
+         * footsteps from the queue, when they are needed to fill the preview
+         * window, and removes the footsteps, which cannot be referenced any
+         * more, from the beginning of #FS. The number of stored footsteps
+         * is bounded in this mode. 
+         *
+         * @attention The indices of footsteps in #FS change on removal.
+         */
+        footstepQueue *footstep_queue;
+
     private:
-        void getDSFeetPositions (const int, double *, double *);
         void getSSFeetPositions (const int, const double, double *, double *);
-        void getSSFeetPositionsBezier (const int, const double, double *, double *);
-        int getNextSS (const int, const fs_type type = FS_TYPE_AUTO);
-        int getPrevSS (const int, const fs_type type = FS_TYPE_AUTO);
+        void formFeetPhase (const int, feetPhase &) const;
+        void prepareFeetPhase (const int, feetPhase &);
+        void applyOffset (const unsigned int);
+        bool findSupport (
+                const unsigned int, 
+                const bool, 
+                unsigned int &, 
+                unsigned int &) const;
+        double getSupportPhase (
+                const unsigned int, 
+                const unsigned int, 
+                const unsigned int) const;
+        int getNextSS (const int, const fs_type type = FS_TYPE_AUTO) const;
+        int getPrevSS (const int, const fs_type type = FS_TYPE_AUTO) const;
+        void indexFootstep (const unsigned int);
+        void getFootstepConstraints (
+                const fs_type, 
+                const bool, 
+                const double *&, 
+                const double *&) const;
+        void scanRelativeSteps (
+                const unsigned int, 
+                const footstepQueue::request *, 
+                double *) const;
+        void pullFootsteps ();
+        void retireFootsteps ();
+        WMGret formPreviewWindow (
+                smpc_parameters &, 
+                const int, 
+                const footstep *, 
+                unsigned int &,
+                unsigned int &,
+                unsigned int &) const;
+        WMGret shiftPreviewWindow (smpc_parameters &);
+        void setPreviewWindowElement (
+                smpc_parameters &, 
+                const unsigned int, 
+                const footstep &, 
+                const unsigned int,
+                const bool) const;
 
         unsigned int def_time_ms;
         unsigned int ds_time_ms;
         unsigned int ds_num;
 
         unsigned int last_time_decrement;
+
+        /// Time from the beginning of the first footstep to the beginning of
+        /// the current preview window.
+        unsigned int preview_window_time_ms;
+
+        /// Incremented on each change of the footsteps, see feetCursor.
+        unsigned int footsteps_version;
+
+        /// Number of footsteps removed from the beginning of #FS, see #footstep_queue.
+        unsigned int retired_footsteps;
+
+        ///@{
+        /// Translation of footsteps starting from #offset_start, which is not
+        /// applied to #FS yet, see #repositionFootsteps.
+        double offset_x;
+        double offset_y;
+        unsigned int offset_start;
+        ///@}
+
+        ///@{
+        /// State of the incrementally updated preview window.
+        bool window_valid;
+        const smpc_parameters *window_par;
+        unsigned int window_tail_step;
+        unsigned int window_tail_time_left;
+        ///@}
+
+
+        /**
+         * @brief Indices of the single supports around a footstep, the
+         * arrays are indexed by FS_TYPE_AUTO (any SS), FS_TYPE_SS_L and
+         * FS_TYPE_SS_R.
+         */
+        struct support_index
+        {
+            /// The first SS with index >= index of the footstep, -1 if unknown yet.
+            int next[FS_TYPE_SS_R + 1];
+            /// The last SS with index <= index of the footstep, -1 if there is none.
+            int prev[FS_TYPE_SS_R + 1];
+        };
+
+        /// Elements correspond to footsteps in #FS, see #indexFootstep.
+        std::vector<support_index> SS_index;
 };
 //@}
 
@@ -11,9 +11,12 @@
 #define SMPC_SOLVER_H
 
 #include <vector>
+#include <cstddef> // size_t, NULL
+#include <cstdio> // FILE
 
 
 class qp_as;
+class qp_as_shared;
 class qp_ip;
 
 
@@ -41,6 +44,34 @@ namespace smpc
     void enable_fexceptions();
 
 
+    /**
+     * @brief Phase timers are compiled in only if the library is built with
+     * USE_PHASE_TIMERS option, otherwise smpc#solve_stats contains zeros.
+     *
+     * @return true if the phase timers are enabled.
+     */
+    bool phase_timers_enabled();
+
+
+    /**
+     * @brief Tracing is compiled in only if the library is built with
+     * USE_TRACE option, otherwise smpc#trace_buffer stays empty.
+     *
+     * @return true if tracing is enabled.
+     */
+    bool tracing_enabled();
+
+
+    /**
+     * @brief Iteration callbacks are compiled in unless the library is built
+     * with USE_ITERATION_CALLBACK option disabled, otherwise the callbacks
+     * are never called, see solver#set_iteration_callback.
+     *
+     * @return true if iteration callbacks are enabled.
+     */
+    bool iteration_callbacks_enabled();
+
+
     // -------------------------------
 
 
@@ -195,17 +226,290 @@ namespace smpc
 
 
 
+    /**
+     * @brief Internal phases of the solvers, which are timed, see
+     * smpc#solve_stats.
+     */
+    enum solverPhase
+    {
+        /// solver#set_parameters
+        SMPC_PHASE_SET_PARAMETERS = 0,
+        /// solver#form_init_fp
+        SMPC_PHASE_FORM_INIT_FP = 1,
+        /// solver#solve, includes all phases below.
+        SMPC_PHASE_SOLVE = 2,
+        /// Formation of the Cholesky factor corresponding to the equality
+        /// constraints, nested in #SMPC_PHASE_INIT_SOLVE or #SMPC_PHASE_NEWTON_STEP.
+        SMPC_PHASE_ECL_FORM = 3,
+        /// AS: computation of the first descent direction.
+        SMPC_PHASE_INIT_SOLVE = 4,
+        /// AS: addition of a constraint and computation of a new direction.
+        SMPC_PHASE_UP_RESOLVE = 5,
+        /// AS: removal of a constraint and computation of a new direction.
+        SMPC_PHASE_DOWN_RESOLVE = 6,
+        /// AS: search of blocking constraints and of constraints for removal.
+        SMPC_PHASE_CHECK_CONSTRAINTS = 7,
+        /// IP: gradient, hessian, Newton step and decrement.
+        SMPC_PHASE_NEWTON_STEP = 8,
+        /// IP: initial step length and backtracking search.
+        SMPC_PHASE_LINE_SEARCH = 9,
+        /// The number of phases.
+        SMPC_PHASE_NUM = 10
+    };
+
+
+    /**
+     * @brief Durations of the phases of the last call of solver#set_parameters,
+     * solver#form_init_fp and solver#solve.
+     *
+     * @note The phases are timed only if #phase_timers_enabled returns true.
+     * The overhead of a measurement is a call of clock_gettime().
+     */
+    class solve_stats
+    {
+        public:
+            solve_stats();
+
+            /**
+             * @brief Sets all durations and numbers of calls to zero.
+             */
+            void reset();
+
+            /**
+             * @brief Returns the name of a phase.
+             *
+             * @param[in] phase the phase.
+             *
+             * @return a static string.
+             */
+            static const char *get_phase_name (const solverPhase phase);
+
+
+            /// Total duration of each phase [nanoseconds].
+            double time_ns[SMPC_PHASE_NUM];
+
+            /// The number of times each phase was executed.
+            unsigned int calls[SMPC_PHASE_NUM];
+    };
+
+
+
+    /// Types of the events of a trace, see smpc#trace_buffer.
+    enum traceEventType
+    {
+        /// A call of solver#solve, index: number of iterations.
+        SMPC_TRACE_SOLVE = 0,
+        /// AS: a constraint is added, index: constraint, value: step length.
+        SMPC_TRACE_ADD_CONSTRAINT = 1,
+        /// AS: a constraint is removed, index: constraint.
+        SMPC_TRACE_REMOVE_CONSTRAINT = 2,
+        /// IP: an external iteration, index: iteration, value: kappa.
+        SMPC_TRACE_IP_OUTER = 3,
+        /// IP: an internal iteration (Newton step), index: iteration,
+        /// value: step length (0 if no step was made).
+        SMPC_TRACE_IP_INNER = 4,
+        /// IP: a backtracking search iteration, index: iteration,
+        /// value: step length.
+        SMPC_TRACE_IP_BS = 5,
+        /// The number of types.
+        SMPC_TRACE_EVENT_NUM = 6
+    };
+
+
+    /**
+     * @brief An event of a trace.
+     */
+    class trace_event
+    {
+        public:
+            /// Start time [nanoseconds, CLOCK_MONOTONIC].
+            double start_ns;
+            /// Duration [nanoseconds], 0 for instant events, see trace_buffer#is_instant.
+            double duration_ns;
+            /// A value, see smpc#traceEventType.
+            double value;
+            /// An index, see smpc#traceEventType.
+            unsigned int index;
+            /// Identifier of the solver, see solver#set_trace.
+            unsigned int solver_id;
+            /// Type of the event.
+            traceEventType type;
+    };
+
+
+    /**
+     * @brief A ring buffer of events of the solvers, the oldest events are
+     * overwritten, when it is full. The buffer is preallocated, the events
+     * are added without locks, hence it can be shared by solvers running in
+     * different threads, but it must be read (#get, #write_chrome_json), when
+     * the solvers are not running.
+     *
+     * @note The events are recorded only if #tracing_enabled returns true.
+     */
+    class trace_buffer
+    {
+        public:
+            /**
+             * @param[in] capacity_ the maximal number of stored events.
+             */
+            explicit trace_buffer (const unsigned int capacity_ = 65536);
+            ~trace_buffer();
+
+
+            /**
+             * @brief Adds an event.
+             *
+             * @param[in] event the event.
+             */
+            void add (const trace_event &event);
+
+            /**
+             * @brief Removes all events.
+             */
+            void clear ();
+
+
+            /**
+             * @return the number of stored events.
+             */
+            unsigned int size () const;
+
+            /**
+             * @param[in] index 0 for the oldest stored event.
+             *
+             * @return an event.
+             */
+            const trace_event & get (const unsigned int index) const;
+
+
+            /**
+             * @brief Writes the events in the Chrome trace event format
+             * (JSON), which can be opened in chrome://tracing or Perfetto.
+             *
+             * @param[in] filename name of the file.
+             *
+             * @return false on failure.
+             */
+            bool write_chrome_json (const char *filename) const;
+
+
+            /**
+             * @brief Returns the name of a type of events.
+             *
+             * @param[in] type the type.
+             *
+             * @return a static string.
+             */
+            static const char *get_event_name (const traceEventType type);
+
+            /**
+             * @brief Checks if events of a type are instant (added with
+             * trace_instant) or have a duration (added with trace_scope).
+             *
+             * @param[in] type the type.
+             *
+             * @return true for instant events.
+             */
+            static bool is_instant (const traceEventType type);
+
+
+            /// The number of added events including the overwritten ones.
+            unsigned long num_added;
+
+
+        private:
+            trace_event *events;
+            unsigned int capacity;
+    };
+
+
+
+    /**
+     * @brief The state of a solver after an iteration, which is passed to
+     * smpc#iteration_callback.
+     */
+    class iteration_record
+    {
+        public:
+            /// The number of the iteration within solver#solve, starts from 1.
+            unsigned int iteration;
+            /// AS: the number of active constraints, IP: 0.
+            unsigned int active_set_size;
+            /// The length of the step made during the iteration.
+            double alpha;
+            /// The value of the objective function.
+            double objective;
+            /// IP: Newton decrement, AS: 0.
+            double decrement;
+            /// IP: logarithmic barrier multiplier, AS: 0.
+            double kappa;
+    };
+
+
+    /**
+     * @brief A function, which is called after each iteration of a solver.
+     *
+     * @param[in] record the state of the solver.
+     * @param[in,out] data the pointer passed to solver#set_iteration_callback.
+     *
+     * @return false to stop the solver after this iteration, the current
+     * (suboptimal) solution is kept.
+     */
+    typedef bool (*iteration_callback) (const iteration_record &record, void *data);
+
+
+
+    class problem_recorder;
+
+
     /**
      * @brief Abstract class providing common interface functions.
      */
     class solver
     {
         public:
+            solver();
+
             /**
              * @brief Virtual destructor.
              */
             virtual ~solver() = 0;
 
+
+            /**
+             * @brief Enables or disables recording of the problems: the
+             * inputs of #set_parameters and #form_init_fp are passed to the
+             * recorder.
+             *
+             * @param[in] recorder_ a recorder, NULL to disable recording.
+             */
+            void set_recorder (problem_recorder *recorder_);
+
+
+            /**
+             * @brief Enables or disables tracing of the iterations, which
+             * are added to the buffer, see #tracing_enabled.
+             *
+             * @param[in] trace_ a buffer, NULL to disable tracing.
+             * @param[in] id identifier of the solver in the trace.
+             */
+            void set_trace (trace_buffer *trace_, const unsigned int id = 0);
+
+            /**
+             * @brief Sets a function, which is called after each iteration,
+             * see #iteration_callbacks_enabled. The call is not virtual;
+             * when no function is set, the cost is a check of a pointer per
+             * iteration.
+             *
+             * @param[in] callback_ a function, NULL to disable the calls.
+             * @param[in] data_ a pointer passed to the function.
+             *
+             * @attention The objective function is evaluated for each call,
+             * this takes time proportional to the length of the preview
+             * window.
+             */
+            void set_iteration_callback (iteration_callback callback_, void *data_ = NULL);
+
             /** @brief Initializes quadratic problem.
 
                 @param[in] T sampling time for each time step [sec.]
@@ -302,10 +606,296 @@ namespace smpc
              * @param[in] ind index of control inputs [0 : N-1].
              */
             virtual void get_controls (control &c, const int ind) const = 0;
+
+
+            /**
+             * @brief Returns all states and controls in the preview window at
+             * once. Each of the output arrays must have at least N elements.
+             *
+             * @param[out] x  x CoM (or ZMP) positions [meter]
+             * @param[out] vx x CoM velocities [meter/s]
+             * @param[out] ax x CoM accelerations [meter/s^2]
+             * @param[out] y  y CoM (or ZMP) positions [meter]
+             * @param[out] vy y CoM velocities [meter/s]
+             * @param[out] ay y CoM accelerations [meter/s^2]
+             * @param[out] jx jerks along x axis
+             * @param[out] jy jerks along y axis
+             * @param[in] tilde_form if true, the states are returned in
+             *  @ref pX_tilde "tilde" form (see smpc#state_zmp), otherwise
+             *  in the original form (see smpc#state_com).
+             *
+             * @note Element i of the arrays corresponds to the state, which
+             * is returned by #get_state for index i, and the controls, which
+             * are returned by #get_controls for the same index.
+             */
+            virtual void get_trajectory (
+                    double *x, double *vx, double *ax,
+                    double *y, double *vy, double *ay,
+                    double *jx, double *jy,
+                    const bool tilde_form = false) const = 0;
+
+
+            /**
+             * @brief Returns the value of the objective function for the
+             * current solution.
+             *
+             * @return value of the objective function.
+             *
+             * @note The values returned by different solvers cannot be
+             * compared, since the objective functions differ by a constant
+             * term.
+             */
+            virtual double get_objective () const = 0;
+
+
+        protected:
+            /// The recorder of the problems, NULL if the recording is disabled.
+            problem_recorder *recorder;
+
+            /// The buffer of events, NULL if tracing is disabled.
+            trace_buffer *trace;
+            /// Identifier of the solver in the trace.
+            unsigned int trace_id;
+
+            /// The function called after each iteration, may be NULL.
+            iteration_callback callback;
+            /// The pointer passed to #callback.
+            void *callback_data;
     };
 
 
 
+    /**
+     * @brief Writes the problems (the inputs of solver#set_parameters and
+     * solver#form_init_fp) to a binary log, which can be read using
+     * smpc#problem_log. The records are collected in two preallocated
+     * buffers: when one of them is full, recording continues in the other
+     * one, and the full buffer is written to the file by #flush, which should
+     * be called periodically from a thread other than the control loop.
+     *
+     * @attention If #flush is not called often enough (or not called at all),
+     * the solver writes the full buffer itself, when the other one is full,
+     * i.e. blocking I/O is performed in the control loop. If #flush is
+     * writing the buffer at this moment, the new record is dropped, see
+     * #num_dropped.
+     *
+     * The log consists of a header and records of the same size, which
+     * contain the following arrays of doubles: T[N], h[N], angle[N],
+     * zref_x[N], zref_y[N], lb[2*N], ub[2*N], x_coord[N], y_coord[N],
+     * h_initial, init_state[6], 1 if the state is smpc#state_zmp or 0.
+     *
+     * @note The logs are not portable between platforms with different byte
+     * order or size of types.
+     */
+    class problem_recorder
+    {
+        public:
+            /**
+             * @brief Constructor: allocates the buffer.
+             *
+             * @param[in] N Number of sampling times in a preview window
+             * @param[in] buffer_size the number of records in each of the
+             * two buffers.
+             */
+            problem_recorder (const int N, const unsigned int buffer_size = 64);
+
+            ~problem_recorder();
+
+
+            /**
+             * @brief Creates a log, the previous log is closed.
+             *
+             * @param[in] filename name of the file.
+             *
+             * @return false on failure.
+             */
+            bool open (const char *filename);
+
+            /**
+             * @brief Writes the buffered records and closes the log.
+             *
+             * @return false on failure.
+             *
+             * @attention Must not be called concurrently with recording or
+             * #flush.
+             */
+            bool close ();
+
+            /**
+             * @brief Writes the full buffer, if there is one, and flushes
+             * the file. The partially filled buffer is not written.
+             *
+             * @return false on failure or if the log is not open.
+             *
+             * @note Can be called from one thread concurrently with
+             * recording, requires the atomic builtins of GCC (otherwise the
+             * calls must not be concurrent).
+             */
+            bool flush ();
+
+
+            ///@{
+            /// Called by the solvers, the records are complete after
+            /// #record_init_fp.
+            void record_parameters (
+                    const double* T,
+                    const double* h,
+                    const double h_initial,
+                    const double* angle,
+                    const double* zref_x,
+                    const double* zref_y,
+                    const double* lb,
+                    const double* ub);
+            void record_init_fp (
+                    const double *x_coord,
+                    const double *y_coord,
+                    const double *init_state,
+                    const bool tilde_state);
+            ///@}
+
+
+            /**
+             * @param[in] N Number of sampling times in a preview window
+             *
+             * @return the number of doubles in a record.
+             */
+            static unsigned int record_size (const int N);
+
+
+            /// The number of records written to the current log.
+            unsigned int num_records;
+
+            /// The number of records, which were dropped, since #flush was
+            /// writing the full buffer, when the other one got full.
+            unsigned int num_dropped;
+
+
+        private:
+            bool write_pending (bool &);
+
+
+            int N;
+
+            /// The log, NULL if it is not open.
+            FILE *file;
+
+            /// The record, which is being formed.
+            double *current;
+
+            /// Two buffers of complete records.
+            double *buffer;
+
+            /// The capacity of each buffer.
+            unsigned int buffer_size;
+
+            /// The buffer, which is being filled, and the number of records
+            /// in it.
+            unsigned int active;
+            unsigned int buffered;
+
+            /// The number of records in the full buffer, which is waiting
+            /// for #flush, 0 if there is no such buffer.
+            volatile unsigned int pending;
+            /// The index of the full buffer.
+            unsigned int pending_index;
+
+            /// 1 while the full buffer is being written.
+            volatile int writing;
+    };
+
+
+
+    /**
+     * @brief A log of problems written by smpc#problem_recorder. The file is
+     * mapped to memory, the problems can be replayed concurrently.
+     */
+    class problem_log
+    {
+        public:
+            problem_log();
+            ~problem_log();
+
+
+            /**
+             * @brief Maps a log to memory, the previous log is closed.
+             *
+             * @param[in] filename name of the file.
+             *
+             * @return false if the file cannot be mapped or is not a log.
+             */
+            bool open (const char *filename);
+
+            /**
+             * @brief Unmaps the log.
+             */
+            void close ();
+
+
+            /**
+             * @brief Passes a problem to a solver: calls solver#set_parameters
+             * and solver#form_init_fp.
+             *
+             * @param[in] index the number of the problem
+             * @param[in,out] s a solver with the same length of the preview
+             *  window, see #N.
+             * @param[out] X memory for the solution
+             */
+            void replay (const unsigned int index, solver &s, double *X) const;
+
+
+            /// Number of sampling times in a preview window.
+            int N;
+
+            /// The number of problems in the log.
+            unsigned int size;
+
+
+        private:
+            /// The mapped file, NULL if the log is not open.
+            void *data;
+            size_t data_size;
+
+            /// The first record.
+            const double *records;
+    };
+
+
+
+
+    class solver_as;
+
+
+    /**
+     * @brief A container for the internal state of smpc#solver_as, see
+     * solver_as#snapshot and solver_as#restore. All necessary memory is
+     * allocated on construction.
+     */
+    class checkpoint_as
+    {
+        public:
+            /**
+             * @brief Constructor.
+             *
+             * @param[in] solver the checkpoint is created for this solver:
+             *  the size of the preview window and the parameters are copied.
+             */
+            explicit checkpoint_as (const solver_as &solver);
+
+            ~checkpoint_as();
+
+
+            /**
+             * @brief Internal representation.
+             */
+            qp_as *qp_state;
+
+            /**
+             * @brief Memory for a copy of the solution.
+             */
+            double *X;
+    };
+
+
 
     /**
      * @brief API of the sparse MPC solver.
@@ -326,6 +916,13 @@ namespace smpc
                         (NOT the size of active set), no limit if set to 0.
                 @param[in] constraint_removal_on enable/disable removal of activated constraints.
                 @param[in] obj_computation_on compute and keep values of the objective function
+                @param[in] memory_block a block of memory for all workspaces of the solver
+                        (for example, locked memory), which is allocated by the caller and
+                        must not be released before the solver is destroyed. The size of
+                        the block is returned by #memory_footprint. If NULL, the memory
+                        is allocated by the solver.
+                @param[in] block_size the size of memory_block in bytes, the program
+                        is aborted if it is less than #memory_footprint.
 
               @note smpc#max_added_constraints_num and smpc#constraint_removal_on affect the time required 
               for solution. If the number of added constraints is less than (length of preview window)*2 
@@ -341,12 +938,25 @@ namespace smpc
                     const double tol = 1e-7,
                     const unsigned int max_added_constraints_num = 0,
                     const bool constraint_removal_on = true,
-                    const bool obj_computation_on = false);
+                    const bool obj_computation_on = false,
+                    void *memory_block = NULL,
+                    const size_t block_size = 0);
 
 
             ~solver_as();
 
 
+            /**
+             * @brief Returns the size of memory, which is required by the 
+             * solver with the given preview window length.
+             *
+             * @param[in] N Number of sampling times in a preview window
+             *
+             * @return the number of bytes.
+             */
+            static size_t memory_footprint (const int N);
+
+
             // -------------------------------
 
 
@@ -365,9 +975,50 @@ namespace smpc
             void get_state (state_zmp &, const int) const;
             void get_first_controls (control &) const;
             void get_controls (control &, const int) const;
+            void get_trajectory (
+                    double *, double *, double *,
+                    double *, double *, double *,
+                    double *, double *,
+                    const bool tilde_form = false) const;
+            double get_objective () const;
             ///@}
 
 
+            // -------------------------------
+
+
+            /**
+             * @brief Saves the internal state of the solver (parameters of the
+             * problem, active set, Cholesky factors, the solution and counters).
+             *
+             * @param[out] chk a checkpoint.
+             *
+             * @return false if the checkpoint was created for a solver with
+             * a different size of the preview window.
+             *
+             * @note No memory is allocated. #objective_log is not saved.
+             * The reference positions of ZMP are copied to the checkpoint.
+             */
+            bool snapshot (checkpoint_as &chk) const;
+
+            /**
+             * @brief Restores the internal state of the solver, which was
+             * saved using #snapshot.
+             *
+             * @param[in] chk a checkpoint.
+             *
+             * @return false if the checkpoint was created for a solver with
+             * a different size of the preview window, the state is not
+             * changed in this case.
+             *
+             * @note The solution is copied to the memory, which was passed
+             * to the solver in the last call of #form_init_fp. The
+             * reference positions of ZMP are copied to the solver, the
+             * checkpoint may be destroyed or reused afterwards.
+             */
+            bool restore (const checkpoint_as &chk);
+
+
             // -------------------------------
 
        
@@ -393,6 +1044,13 @@ namespace smpc
              */
             unsigned int active_set_size;
 
+            /**
+             * @brief Durations of the internal phases.
+             *
+             * @note Updated by #solve function, reset by #set_parameters.
+             */
+            solve_stats stats;
+
 
             /**
              * @brief Contains values of objective function after each iteration,
@@ -414,6 +1072,100 @@ namespace smpc
     };
 
 
+    /**
+     * @brief A pool of preallocated smpc#solver_as instances, which can be
+     * used by several threads simultaneously.
+     *
+     * A solver is checked out by a thread, used as usual and checked in 
+     * afterwards. Checkout and checkin are lock-free. The solvers do not 
+     * share any writable data and the library has no global state, hence 
+     * the checked out solvers can be used concurrently without locking.
+     *
+     * All solvers have the same gains. The Cholesky factor corresponding to
+     * the equality constraints (it depends only on sampling times and heights
+     * of the CoM) can be computed once by #set_shared_parameters and is used 
+     * read-only by all solvers, when their parameters match.
+     *
+     * @note The pool is available only with compilers supporting the atomic
+     * builtins of GCC.
+     */
+    class solver_pool
+    {
+        public:
+            /**
+             * @brief Constructor: allocates all solvers.
+             *
+             * @param[in] size the number of solvers in the pool.
+             *
+             * @note The other parameters are passed to the constructor of
+             * smpc#solver_as.
+             */
+            solver_pool (
+                    const unsigned int size,
+                    const int N, 
+                    const double gain_position = 2000.0, 
+                    const double gain_velocity = 150.0, 
+                    const double gain_acceleration = 0.02,
+                    const double gain_jerk = 1.0,
+                    const double tol = 1e-7,
+                    const unsigned int max_added_constraints_num = 0,
+                    const bool constraint_removal_on = true,
+                    const bool obj_computation_on = false);
+
+            ~solver_pool();
+
+
+            /**
+             * @brief Checks out a free solver.
+             *
+             * @return a solver or NULL if all solvers are in use.
+             */
+            solver_as *checkout ();
+
+            /**
+             * @brief Returns a solver to the pool.
+             *
+             * @param[in] solver a solver obtained using #checkout.
+             */
+            void checkin (const solver_as *solver);
+
+
+            /**
+             * @brief Forms the shared Cholesky factor.
+             *
+             * @param[in] T sampling time for each time step [sec.]
+             * @param[in] h height of the center of mass divided by gravity for each time step
+             * @param[in] h_initial initial value of height of the center of mass divided by gravity
+             *
+             * @note h_initial is necessary, since the difference h[0] - h_initial
+             * enters the first state transition matrix and, hence, the factor.
+             * The shared factor is used by a solver only if the parameters
+             * passed to its set_parameters() are the same (bitwise).
+             *
+             * @attention Must not be called, when any solver is checked out.
+             */
+            void set_shared_parameters (
+                    const double* T,
+                    const double* h,
+                    const double h_initial);
+
+
+            /// Number of solvers in the pool.
+            unsigned int size;
+
+
+        private:
+            /// The solvers.
+            std::vector<solver_as *> solvers;
+
+            /// Flags, which indicate, that a solver is checked out.
+            int *in_use;
+
+            /// Data shared by all solvers.
+            qp_as_shared *shared;
+    };
+
+
     /**
      * @brief Type of the backtracking search
      */
@@ -428,6 +1180,41 @@ namespace smpc
     };
 
 
+    class solver_ip;
+
+
+    /**
+     * @brief A container for the internal state of smpc#solver_ip, see
+     * solver_ip#snapshot and solver_ip#restore. All necessary memory is
+     * allocated on construction.
+     */
+    class checkpoint_ip
+    {
+        public:
+            /**
+             * @brief Constructor.
+             *
+             * @param[in] solver the checkpoint is created for this solver:
+             *  the size of the preview window and the parameters are copied.
+             */
+            explicit checkpoint_ip (const solver_ip &solver);
+
+            ~checkpoint_ip();
+
+
+            /**
+             * @brief Internal representation.
+             */
+            qp_ip *qp_state;
+
+            /**
+             * @brief Memory for a copy of the solution.
+             */
+            double *X;
+    };
+
+
+
     /**
      * @brief API of the sparse MPC solver.
      */
@@ -454,6 +1241,9 @@ namespace smpc
              *          note that even when it is disabled, the 'bs_beta' parameter is still used.
              * @param[in] obj_computation_on enable computation of the objective function 
              *          (the results are kept in #objective_log)
+             * @param[in] memory_block a block of memory for all workspaces of the solver,
+             *          see solver_as#solver_as.
+             * @param[in] block_size the size of memory_block in bytes.
              */
             solver_ip (
                     const int N, 
@@ -469,11 +1259,24 @@ namespace smpc
                     const double bs_beta = 0.5,
                     const int unsigned max_iter = 0,
                     const backtrackingSearchType bs_type = SMPC_IP_BS_LOGBAR,
-                    const bool obj_computation_on = false);
+                    const bool obj_computation_on = false,
+                    void *memory_block = NULL,
+                    const size_t block_size = 0);
 
             ~solver_ip();
 
 
+            /**
+             * @brief Returns the size of memory, which is required by the 
+             * solver with the given preview window length.
+             *
+             * @param[in] N Number of sampling times in a preview window
+             *
+             * @return the number of bytes.
+             */
+            static size_t memory_footprint (const int N);
+
+
             // -------------------------------
 
 
@@ -492,12 +1295,54 @@ namespace smpc
             void get_state (state_zmp &, const int) const;
             void get_first_controls (control &) const;
             void get_controls (control &, const int) const;
+            void get_trajectory (
+                    double *, double *, double *,
+                    double *, double *, double *,
+                    double *, double *,
+                    const bool tilde_form = false) const;
+            double get_objective () const;
             ///@}
 
 
             // -------------------------------
 
 
+            /**
+             * @brief Saves the internal state of the solver (parameters of the
+             * problem, Cholesky factor, the solution, intermediate vectors 
+             * and counters).
+             *
+             * @param[out] chk a checkpoint.
+             *
+             * @return false if the checkpoint was created for a solver with
+             * a different size of the preview window.
+             *
+             * @note No memory is allocated. #objective_log is not saved.
+             * The reference positions of ZMP and the bounds are copied to the checkpoint.
+             */
+            bool snapshot (checkpoint_ip &chk) const;
+
+            /**
+             * @brief Restores the internal state of the solver, which was
+             * saved using #snapshot.
+             *
+             * @param[in] chk a checkpoint.
+             *
+             * @return false if the checkpoint was created for a solver with
+             * a different size of the preview window, the state is not
+             * changed in this case.
+             *
+             * @note The solution is copied to the memory, which was passed
+             * to the solver in the last call of #form_init_fp. The
+             * reference positions of ZMP and the bounds are copied to the
+             * solver, the checkpoint may be destroyed or reused afterwards.
+             */
+            bool restore (const checkpoint_ip &chk);
+
+
+            // -------------------------------
+
+
             /**
              * @brief The number of iterations of the external loop.
              *
@@ -519,6 +1364,13 @@ namespace smpc
              */
             unsigned int bt_search_iterations;
 
+            /**
+             * @brief Durations of the internal phases.
+             *
+             * @note Updated by #solve function, reset by #set_parameters.
+             */
+            solve_stats stats;
+
 
             /**
              * @brief Contains values of objective function after each iteration,
@@ -11,9 +11,10 @@
  ****************************************/
 
 #include "as_chol_solve.h"
+#include "phase_timer.h"
 
 #include <cmath> // sqrt
-#include <cstring> // memset, memmove
+#include <cstring> // memset, memmove, memcpy
 
 
 /****************************************
@@ -28,14 +29,21 @@ namespace AS
      * @brief Constructor
      *
      * @param[in] N size of the preview window.
+     * @param[in,out] arena memory arena
+     * @param[in,out] stats_ durations of the phases of the solver
      */
-    chol_solve::chol_solve (const int N) : ecL(N)
+    chol_solve::chol_solve (const int N, memory_arena &arena, smpc::solve_stats &stats_) :
+        ecL(N, arena), stats(stats_)
     {
-        nu = new double[SMPC_NUM_VAR*N];
-        z = new double[SMPC_NUM_VAR*N];
+        shared_ecL = NULL;
+        cur_ecL = &ecL;
 
-        icL = new double*[N*2];
-        icL_mem = new double[SMPC_NUM_VAR*N*N*2];
+        nu = arena.alloc_double (SMPC_NUM_VAR*N);
+        z = arena.alloc_double (SMPC_NUM_VAR*N);
+
+        // the rows are filled one by one, when constraints are added.
+        icL = arena.alloc_double_ptr (N*2);
+        icL_mem = arena.alloc_double (SMPC_NUM_VAR*N*N*2);
         for(int i = 0; i < N*2; ++i)
         {
             icL[i] = &icL_mem[i * SMPC_NUM_VAR*N];
@@ -44,23 +52,18 @@ namespace AS
 
 
     /**
-     * @brief Destructor
+     * @brief Returns the amount of memory, which is allocated in an arena.
+     *
+     * @param[in] N size of the preview window.
+     *
+     * @return the number of bytes.
      */
-    chol_solve::~chol_solve()
+    size_t chol_solve::memory_footprint (const int N)
     {
-        if (icL != NULL)
-        {
-            delete icL_mem;
-            delete icL;
-        }
-        if (z != NULL)
-        {
-            delete z;
-        }
-        if (nu != NULL)
-        {
-            delete nu;
-        }
+        return (matrix_ecL::memory_footprint (N)
+                + 2 * memory_arena::aligned_size (sizeof(double) * SMPC_NUM_VAR*N)
+                + memory_arena::aligned_size (sizeof(double *) * N*2)
+                + memory_arena::aligned_size (sizeof(double) * SMPC_NUM_VAR*N*N*2));
     }
     //==============================================
 
@@ -121,14 +124,23 @@ namespace AS
         int i;
 
 
-        // generate L
-        ecL.form (ppar);
+        // generate L, unless the shared factor is formed for the same parameters
+        if ((shared_ecL != NULL) && (shared_ecL->is_formed_for (ppar)))
+        {
+            cur_ecL = shared_ecL;
+        }
+        else
+        {
+            phase_timer timer (stats, smpc::SMPC_PHASE_ECL_FORM);
+            ecL.form (ppar);
+            cur_ecL = &ecL;
+        }
 
         // obtain s = E * x;
         E.form_Ex (ppar, x, s_nu);
 
         // obtain nu
-        ecL.solve_forward(ppar.N, s_nu);
+        cur_ecL->solve_forward(ppar.N, s_nu);
         // make copy of z - it is constant
         for (i = 0; i < ppar.N * SMPC_NUM_STATE_VAR; i += SMPC_NUM_STATE_VAR)
         {
@@ -140,7 +152,7 @@ namespace AS
             s_nu[i+5] = -s_nu[i+5];
         }
         memmove(z, s_nu, sizeof(double) * ppar.N * SMPC_NUM_STATE_VAR);
-        ecL.solve_backward(ppar.N, s_nu);
+        cur_ecL->solve_backward(ppar.N, s_nu);
 
         // - i2H * E' * nu
         E.form_i2HETx (ppar, s_nu, dx);
@@ -214,7 +226,7 @@ namespace AS
         form_sa_row(ppar, c, last_num, new_row);
 
         // Forward substitution using L for equality constraints
-        ecL.solve_forward(ppar.N, new_row, c.cind/2);
+        cur_ecL->solve_forward(ppar.N, new_row, c.cind/2);
 
 
         // update the trailing elements of new_row using the
@@ -340,7 +352,7 @@ namespace AS
             }
         }
         // backward substitution for ecL
-        ecL.solve_backward(ppar.N, nu);
+        cur_ecL->solve_backward(ppar.N, nu);
 
 
         // - i2H * E' * nu
@@ -443,6 +455,37 @@ namespace AS
 
 
 
+    /**
+     * @brief Copies Cholesky factors and vectors @ref pz "z" and nu.
+     *
+     * @param[in] from an instance of the class to copy the data from
+     * @param[in] N size of the preview window.
+     * @param[in] nW number of active inequality constraints.
+     *
+     * @note Only the rows of #icL, which correspond to the active 
+     * constraints are copied.
+     */
+    void chol_solve::copy_state (
+            const chol_solve& from,
+            const int N,
+            const int nW)
+    {
+        const int len = N*SMPC_NUM_STATE_VAR + nW;
+
+        ecL.copy_state (*from.cur_ecL, N);
+        cur_ecL = &ecL;
+
+        memcpy (nu, from.nu, sizeof(double) * len);
+        memcpy (z, from.z, sizeof(double) * len);
+        for (int i = 0; i < nW; ++i)
+        {
+            // the last element in the row is the diagonal element
+            memcpy (icL[i], from.icL[i], sizeof(double) * (N*SMPC_NUM_STATE_VAR + i + 1));
+        }
+    }
+
+
+
     /**
      * @return a pointer to the memory where current lambdas are stored.
      * @param[in] ppar parameters
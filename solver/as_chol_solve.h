@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "smpc_common.h"
+#include "memory_arena.h"
 #include "as_matrix_E.h"
 #include "as_matrix_ecL.h"
 #include "as_problem_param.h"
@@ -26,6 +27,9 @@
 
 using namespace std;
 
+/// Internal functions are accessed through it, see kernel_access.h.
+class kernel_access;
+
 /// @addtogroup gAS
 /// @{
 namespace AS
@@ -37,9 +41,12 @@ namespace AS
     class chol_solve
     {
         public:
+            friend class ::kernel_access;
+
             /*********** Constructors / Destructors ************/
-            chol_solve (const int);
-            ~chol_solve();
+            chol_solve (const int, memory_arena &, smpc::solve_stats &);
+
+            static size_t memory_footprint (const int);
 
             void solve(const AS::problem_parameters&, const double *, double *);
 
@@ -48,6 +55,12 @@ namespace AS
             double * get_lambda(const AS::problem_parameters&);
             void down_resolve(const AS::problem_parameters&, const vector<AS::constraint>&, const int, const double *, double *);
 
+            void copy_state (const chol_solve&, const int, const int);
+
+            /// A Cholesky factor, which is shared with other solvers 
+            /// (read-only), NULL if there is no such factor.
+            const AS::matrix_ecL *shared_ecL;
+
 
         private:
             void update (const AS::problem_parameters&, const AS::constraint&, const int);
@@ -70,6 +83,10 @@ namespace AS
             /// L for equality AS::constraints
             AS::matrix_ecL ecL;
 
+            /// L for equality AS::constraints, which is currently used 
+            /// (#ecL or #shared_ecL).
+            const AS::matrix_ecL *cur_ecL;
+
             /// L for inequality AS::constraints
             double **icL;   
 
@@ -78,6 +95,9 @@ namespace AS
 
             /// Vector @ref pz "z".
             double *z;
+
+            /// Durations of the phases, see #phase_timer.
+            smpc::solve_stats &stats;
     };
 }
 /// @}
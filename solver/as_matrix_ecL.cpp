@@ -12,6 +12,7 @@
 #include "as_matrix_ecL.h"
 
 #include <cmath> // sqrt
+#include <cstring> // memcpy, memcmp
 
 
 /****************************************
@@ -47,12 +48,15 @@ namespace AS
     //==============================================
     // constructors / destructors
 
-    matrix_ecL::matrix_ecL (const int N)
+    matrix_ecL::matrix_ecL (const int N, memory_arena &arena)
     {
-        ecL = new double[MATRIX_SIZE_3x3*N + MATRIX_SIZE_3x3*(N-1)]();
-
-        iQAT = new double[MATRIX_SIZE_3x3];
-        ecL_diag = new double*[N];
+        // the tables of pointers are accessed before the matrix
+        ecL_diag = arena.alloc_double_ptr (N);
+        ecL_ndiag = arena.alloc_double_ptr (N-1);
+        ecL = arena.alloc_double (MATRIX_SIZE_3x3*N + MATRIX_SIZE_3x3*(N-1));
+        iQAT = arena.alloc_double (MATRIX_SIZE_3x3);
+        form_spar = static_cast<state_parameters *> (arena.alloc (sizeof(state_parameters) * N));
+        formed = false;
 
         /**
             A constant and well structured 'upper' part of Cholesky factor, 
@@ -90,7 +94,6 @@ namespace AS
         {
             ecL_diag[i] = &ecL[i * MATRIX_SIZE_3x3 * 2];
         }
-        ecL_ndiag = new double*[N-1];
         for (int i = 0; i < N-1; i++)
         {
             ecL_ndiag[i] = &ecL[i * MATRIX_SIZE_3x3 * 2 + MATRIX_SIZE_3x3];
@@ -98,21 +101,58 @@ namespace AS
     }
 
 
-    matrix_ecL::~matrix_ecL()
+    /**
+     * @brief Returns the amount of memory, which is allocated in an arena.
+     *
+     * @param[in] N size of the preview window.
+     *
+     * @return the number of bytes.
+     */
+    size_t matrix_ecL::memory_footprint (const int N)
     {
-        if (ecL != NULL)
-            delete ecL;
+        return (memory_arena::aligned_size (sizeof(double *) * N)
+                + memory_arena::aligned_size (sizeof(double *) * (N-1))
+                + memory_arena::aligned_size (sizeof(double) * (MATRIX_SIZE_3x3*N + MATRIX_SIZE_3x3*(N-1)))
+                + memory_arena::aligned_size (sizeof(double) * MATRIX_SIZE_3x3)
+                + memory_arena::aligned_size (sizeof(state_parameters) * N));
+    }
+    //==============================================
 
-        if (ecL_diag != NULL)
-            delete ecL_diag;
 
-        if (ecL_ndiag != NULL)
-            delete ecL_ndiag;
 
-        if (iQAT != NULL)
-            delete iQAT;
+    /**
+     * @brief Copies the Cholesky factor.
+     *
+     * @param[in] from an instance of the class to copy the factor from.
+     * @param[in] N number of states in the preview window
+     */
+    void matrix_ecL::copy_state (const matrix_ecL& from, const int N)
+    {
+        memcpy (ecL, from.ecL, sizeof(double) * (MATRIX_SIZE_3x3*N + MATRIX_SIZE_3x3*(N-1)));
+
+        formed = from.formed;
+        memcpy (form_spar, from.form_spar, sizeof(state_parameters) * N);
+        memcpy (form_i2Q, from.form_i2Q, sizeof(form_i2Q));
+        form_i2P = from.form_i2P;
+    }
+
+
+
+    /**
+     * @brief Checks if the matrix was formed using the given parameters. 
+     * The parameters are compared bitwise, since the matrix must be the same.
+     *
+     * @param[in] ppar parameters.
+     *
+     * @return true if the matrix does not need to be formed again.
+     */
+    bool matrix_ecL::is_formed_for (const problem_parameters& ppar) const
+    {
+        return (formed
+                && (memcmp (form_spar, ppar.spar, sizeof(state_parameters) * ppar.N) == 0)
+                && (memcmp (form_i2Q, ppar.i2Q, sizeof(form_i2Q)) == 0)
+                && (memcmp (&form_i2P, &ppar.i2P, sizeof(form_i2P)) == 0));
     }
-    //==============================================
 
 
 
@@ -314,6 +354,11 @@ namespace AS
             form_AiQATiQBiPB (ppar, stp, ecL_diag[i]);
             form_L_diag(ecL_ndiag[i-1], ecL_diag[i]);
         }
+
+        formed = true;
+        memcpy (form_spar, ppar.spar, sizeof(state_parameters) * ppar.N);
+        memcpy (form_i2Q, ppar.i2Q, sizeof(form_i2Q));
+        form_i2P = ppar.i2P;
     }
 
 
@@ -14,6 +14,7 @@
  ****************************************/
 
 #include "smpc_common.h"
+#include "memory_arena.h"
 #include "as_problem_param.h"
 
 
@@ -36,10 +37,13 @@ namespace AS
     {
         public:
             /*********** Constructors / Destructors ************/
-            matrix_ecL(const int);
-            ~matrix_ecL();
+            matrix_ecL(const int, memory_arena &);
+
+            static size_t memory_footprint (const int);
 
             void form (const problem_parameters&);
+            bool is_formed_for (const problem_parameters&) const;
+            void copy_state (const matrix_ecL&, const int);
 
             void solve_backward (const int, double *) const;
             void solve_forward (const int, double *, const int start_ind = 0) const;
@@ -61,6 +65,14 @@ namespace AS
 
             // intermediate results used in computation of L
             double *iQAT;       /// inv(Q) * A'
+
+            ///@{
+            /// Parameters, which were used to form the matrix.
+            bool formed;
+            state_parameters *form_spar;
+            double form_i2Q[3];
+            double form_i2P;
+            ///@}
     };
 }
 /// @}
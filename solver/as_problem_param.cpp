@@ -22,7 +22,8 @@ namespace AS
         const double gain_position,
         const double gain_velocity,
         const double gain_acceleration,
-        const double gain_jerk)
+        const double gain_jerk,
+        memory_arena &arena)
     {
         N = N_;
 
@@ -32,15 +33,44 @@ namespace AS
 
         i2P = 1/(2 * (gain_jerk/2));
 
-        spar = new state_parameters[N];
+        spar = static_cast<state_parameters *> (arena.alloc (sizeof(state_parameters) * N));
     }
 
 
+    /**
+     * @brief Constructor: the constant parameters are copied from another
+     * instance, the parameters of the states are not copied.
+     *
+     * @param[in] from an instance of the class.
+     * @param[in,out] arena memory arena.
+     */
+    problem_parameters::problem_parameters (
+        const problem_parameters &from,
+        memory_arena &arena)
+    {
+        N = from.N;
+
+        i2Q[0] = from.i2Q[0];
+        i2Q[1] = from.i2Q[1];
+        i2Q[2] = from.i2Q[2];
+
+        i2P = from.i2P;
 
-    problem_parameters::~problem_parameters()
+        spar = static_cast<state_parameters *> (arena.alloc (sizeof(state_parameters) * N));
+    }
+
+
+
+    /**
+     * @brief Returns the amount of memory, which is allocated in an arena.
+     *
+     * @param[in] N size of the preview window.
+     *
+     * @return the number of bytes.
+     */
+    size_t problem_parameters::memory_footprint (const int N)
     {
-        if (spar != NULL)
-            delete [] spar;
+        return (memory_arena::aligned_size (sizeof(state_parameters) * N));
     }
 
 
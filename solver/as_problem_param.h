@@ -13,6 +13,7 @@
  ****************************************/
 
 #include "smpc_common.h"
+#include "memory_arena.h"
 
 /****************************************
  * DEFINES
@@ -45,8 +46,10 @@ namespace AS
     class problem_parameters
     {
         public:
-            problem_parameters (const int, const double, const double, const double, const double);
-            ~problem_parameters();
+            problem_parameters (const int, const double, const double, const double, const double, memory_arena &);
+            problem_parameters (const problem_parameters &, memory_arena &);
+
+            static size_t memory_footprint (const int);
 
             void set_state_parameters (const double*, const double*, const double);
 
@@ -11,6 +11,9 @@
  ****************************************/
 
 #include "ip_chol_solve.h"
+#include "phase_timer.h"
+
+#include <cstring> // memcpy
 
 
 /****************************************
@@ -25,21 +28,44 @@ namespace IP
      * @brief Constructor
      *
      * @param[in] N size of the preview window.
+     * @param[in,out] arena memory arena
+     * @param[in,out] stats_ durations of the phases of the solver
      */
-    chol_solve::chol_solve (const int N) : ecL(N)
+    chol_solve::chol_solve (const int N, memory_arena &arena, smpc::solve_stats &stats_) :
+        ecL(N, arena), stats(stats_)
     {
-        w = new double[N*SMPC_NUM_STATE_VAR];
+        w = arena.alloc_double (N*SMPC_NUM_STATE_VAR);
     }
 
 
-    chol_solve::~chol_solve()
+    /**
+     * @brief Returns the amount of memory, which is allocated in an arena.
+     *
+     * @param[in] N size of the preview window.
+     *
+     * @return the number of bytes.
+     */
+    size_t chol_solve::memory_footprint (const int N)
     {
-        if (w != NULL)
-            delete w;
+        return (matrix_ecL::memory_footprint (N)
+                + memory_arena::aligned_size (sizeof(double) * N*SMPC_NUM_STATE_VAR));
     }
     //==============================================
 
 
+    /**
+     * @brief Copies the Cholesky factor and Lagrange multipliers.
+     *
+     * @param[in] from an instance of the class to copy the data from
+     * @param[in] N size of the preview window.
+     */
+    void chol_solve::copy_state (const chol_solve& from, const int N)
+    {
+        ecL.copy_state (from.ecL, N);
+        memcpy (w, from.w, sizeof(double) * N*SMPC_NUM_STATE_VAR);
+    }
+
+
     /**
      * @brief Determines feasible descent direction.
      *
@@ -61,7 +87,10 @@ namespace IP
 
 
         // generate L
-        ecL.form (ppar, i2hess);
+        {
+            phase_timer timer (stats, smpc::SMPC_PHASE_ECL_FORM);
+            ecL.form (ppar, i2hess);
+        }
 
         // obtain s = E * x;
         E.form_Ex (ppar, i2hess_grad, s_w);
@@ -12,6 +12,7 @@
  ****************************************/
 
 #include "smpc_common.h"
+#include "memory_arena.h"
 #include "ip_matrix_E.h"
 #include "ip_matrix_ecL.h"
 #include "ip_problem_param.h"
@@ -23,6 +24,9 @@
 
 using namespace std;
 
+/// Internal functions are accessed through it, see kernel_access.h.
+class kernel_access;
+
 /// @addtogroup gIP
 /// @{
 
@@ -35,11 +39,15 @@ namespace IP
     class chol_solve
     {
         public:
+            friend class ::kernel_access;
+
             /*********** Constructors / Destructors ************/
-            chol_solve (const int);
-            ~chol_solve();
+            chol_solve (const int, memory_arena &, smpc::solve_stats &);
+
+            static size_t memory_footprint (const int);
 
             void solve(const problem_parameters&, const double *, const double *, const double *, double *);
+            void copy_state (const chol_solve&, const int);
 
         private:
             /// matrix of equality constraints
@@ -50,6 +58,9 @@ namespace IP
 
             /// Lagrange multipliers
             double *w;
+
+            /// Durations of the phases, see #phase_timer.
+            smpc::solve_stats &stats;
     };
 }
 /// @}
@@ -12,6 +12,7 @@
 #include "ip_matrix_ecL.h"
 
 #include <cmath> // sqrt
+#include <cstring> // memcpy
 
 
 /****************************************
@@ -23,22 +24,41 @@ namespace IP
     // constructors / destructors
 
 
-    matrix_ecL::matrix_ecL (const int N)
+    matrix_ecL::matrix_ecL (const int N, memory_arena &arena)
     {
-        ecL = new double[MATRIX_SIZE_6x6*N + MATRIX_SIZE_6x6*(N-1)]();
+        ecL = arena.alloc_double (MATRIX_SIZE_6x6*N + MATRIX_SIZE_6x6*(N-1));
     }
 
 
-    matrix_ecL::~matrix_ecL()
+    /**
+     * @brief Returns the amount of memory, which is allocated in an arena.
+     *
+     * @param[in] N size of the preview window.
+     *
+     * @return the number of bytes.
+     */
+    size_t matrix_ecL::memory_footprint (const int N)
     {
-        if (ecL != NULL)
-            delete ecL;
+        return (memory_arena::aligned_size (sizeof(double) * (MATRIX_SIZE_6x6*N + MATRIX_SIZE_6x6*(N-1))));
     }
 
     //==============================================
 
 
 
+    /**
+     * @brief Copies the Cholesky factor.
+     *
+     * @param[in] from an instance of the class to copy the factor from.
+     * @param[in] N number of states in the preview window
+     */
+    void matrix_ecL::copy_state (const matrix_ecL& from, const int N)
+    {
+        memcpy (ecL, from.ecL, sizeof(double) * (MATRIX_SIZE_6x6*N + MATRIX_SIZE_6x6*(N-1)));
+    }
+
+
+
     /**
      * @brief Forms M = R*inv(hess_phi)*R'.
      *
@@ -14,6 +14,7 @@
  ****************************************/
 
 #include "smpc_common.h"
+#include "memory_arena.h"
 #include "ip_problem_param.h"
 
 using namespace std;
@@ -43,10 +44,12 @@ namespace IP
     {
         public:
             /*********** Constructors / Destructors ************/
-            matrix_ecL(const int);
-            ~matrix_ecL();
+            matrix_ecL(const int, memory_arena &);
+
+            static size_t memory_footprint (const int);
 
             void form (const problem_parameters&, const double *);
+            void copy_state (const matrix_ecL&, const int);
 
             void solve_backward (const int, double *);
             void solve_forward (const int, double *);
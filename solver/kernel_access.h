@@ -0,0 +1,137 @@
+/**
+ * @file
+ * @author agent
+ * @brief Access to the internal functions of the solvers, which is used
+ *  by the microbenchmarks (bench/bench_kernels.cpp).
+ */
+
+
+#ifndef KERNEL_ACCESS_H
+#define KERNEL_ACCESS_H
+
+/****************************************
+ * INCLUDES
+ ****************************************/
+#include "qp_as.h"
+#include "qp_ip.h"
+
+#include <vector>
+
+
+/****************************************
+ * TYPEDEFS
+ ****************************************/
+
+using namespace std;
+
+/// @addtogroup gINTERNALS
+/// @{
+
+/**
+ * @brief Calls the internal functions of the solvers separately, so that
+ * they can be measured. The function names follow the names of the called
+ * functions.
+ *
+ * @attention The functions are not used by the solvers and do not check
+ * the state of the solvers: the caller must reproduce the sequence of
+ * calls made in the solve() functions.
+ */
+class kernel_access
+{
+    public:
+    // AS
+        static const vector<AS::constraint> & active_set (const qp_as &qp)
+        {
+            return (qp.active_set);
+        }
+
+        /// Computes the initial descent direction for the given X.
+        static void chol_solve (qp_as &qp, const double *x)
+        {
+            qp.chol.solve (qp, x, qp.dX);
+        }
+
+        static void form_ecL (qp_as &qp)
+        {
+            qp.chol.ecL.form (qp);
+        }
+
+        static void solve_forward (const qp_as &qp, double *x)
+        {
+            qp.chol.ecL.solve_forward (qp.N, x);
+        }
+
+        static void solve_backward (const qp_as &qp, double *x)
+        {
+            qp.chol.ecL.solve_backward (qp.N, x);
+        }
+
+        /// Returns the index of the added constraint or -1.
+        static int check_blocking_constraints (qp_as &qp)
+        {
+            return (qp.check_blocking_constraints());
+        }
+
+        /// Removes the constraint added by #check_blocking_constraints.
+        static void remove_added_constraint (qp_as &qp, const int ind)
+        {
+            qp.constraints[ind].isActive = false;
+            qp.active_set.pop_back();
+        }
+
+        static void update (qp_as &qp, const AS::constraint &constraint, const int ic_num)
+        {
+            qp.chol.update (qp, constraint, ic_num);
+        }
+
+        static void downdate (qp_as &qp, const int nW, const int ind_exclude, const double *x)
+        {
+            qp.chol.downdate (qp, nW, ind_exclude, x);
+        }
+
+
+    // IP
+        /// Returns the logarithmic barrier parameter.
+        static double get_t (const qp_ip &qp)
+        {
+            return (qp.t);
+        }
+
+        static void form_grad_i2hess_logbar (qp_ip &qp, const double kappa)
+        {
+            qp.form_grad_i2hess_logbar (kappa);
+        }
+
+        static void form_ecL (qp_ip &qp)
+        {
+            qp.chol.ecL.form (qp, qp.i2hess);
+        }
+
+        static void chol_solve (qp_ip &qp)
+        {
+            qp.chol.solve (qp, qp.i2hess_grad, qp.i2hess, qp.X, qp.dX);
+        }
+
+        static void form_decrement (qp_ip &qp)
+        {
+            qp.form_decrement ();
+        }
+
+        static double init_alpha (qp_ip &qp)
+        {
+            return (qp.init_alpha ());
+        }
+
+        static void form_bs_alpha_obj_dX (qp_ip &qp)
+        {
+            qp.form_bs_alpha_obj_dX ();
+        }
+
+        static void form_phi_X_tmp (qp_ip &qp, const double kappa, const double alpha)
+        {
+            qp.form_phi_X_tmp (kappa, alpha);
+        }
+};
+
+///@}
+#endif /*KERNEL_ACCESS_H*/
@@ -0,0 +1,137 @@
+/** 
+ * @file
+ * @author agent
+ */
+
+
+/****************************************
+ * INCLUDES 
+ ****************************************/
+
+#include "memory_arena.h"
+
+#include <cstdio> // fprintf
+#include <cstdlib> // abort
+#include <cstring> // memset
+
+
+/****************************************
+ * FUNCTIONS 
+ ****************************************/
+
+/**
+ * @brief Constructor.
+ *
+ * @param[in] size_ the size of the memory block in bytes, including 
+ *  #SMPC_CACHE_LINE_SIZE bytes, which may be lost on alignment.
+ * @param[in] block memory provided by the caller (it is not released by the
+ *  arena), if NULL the memory is allocated.
+ * @param[in] block_size the size of the block provided by the caller in bytes,
+ *  must not be less than size_, ignored if block is NULL.
+ *
+ * @note The memory is initialized with zeros.
+ */
+memory_arena::memory_arena (const size_t size_, void *block, const size_t block_size)
+{
+    if (block == NULL)
+    {
+        own_memory = new char[size_];
+        block = own_memory;
+    }
+    else
+    {
+        if (block_size < size_)
+        {
+            fprintf (stderr, "The memory block is too small: %lu bytes, %lu bytes are required.\n",
+                    (unsigned long) block_size, (unsigned long) size_);
+            abort();
+        }
+        own_memory = NULL;
+    }
+
+    const size_t shift = 
+        (SMPC_CACHE_LINE_SIZE - (size_t) block % SMPC_CACHE_LINE_SIZE) % SMPC_CACHE_LINE_SIZE;
+    memory = static_cast<char *> (block) + shift;
+    size = size_ - shift;
+    used = 0;
+
+    memset (memory, 0, size);
+}
+
+
+/**
+ * @brief Destructor.
+ */
+memory_arena::~memory_arena()
+{
+    if (own_memory != NULL)
+    {
+        delete [] own_memory;
+    }
+}
+
+
+/**
+ * @brief Returns the size of a chunk, which is necessary to store the given
+ * number of bytes without violation of alignment of the subsequent chunks.
+ *
+ * @param[in] num_bytes the number of bytes.
+ *
+ * @return the size of a chunk.
+ */
+size_t memory_arena::aligned_size (const size_t num_bytes)
+{
+    return (((num_bytes + SMPC_CACHE_LINE_SIZE - 1) / SMPC_CACHE_LINE_SIZE) * SMPC_CACHE_LINE_SIZE);
+}
+
+
+/**
+ * @brief Allocates a chunk of memory.
+ *
+ * @param[in] num_bytes the number of bytes.
+ *
+ * @return a pointer to the chunk.
+ *
+ * @note Aborts the program if there is not enough memory.
+ */
+void *memory_arena::alloc (const size_t num_bytes)
+{
+    const size_t chunk_size = aligned_size (num_bytes);
+
+    if (used + chunk_size > size)
+    {
+        fprintf (stderr, "Out of memory in the arena: %lu bytes are requested, %lu bytes are available.\n",
+                (unsigned long) chunk_size, (unsigned long) (size - used));
+        abort();
+    }
+
+    void *chunk = &memory[used];
+    used += chunk_size;
+    return (chunk);
+}
+
+
+/**
+ * @brief Allocates an array of doubles.
+ *
+ * @param[in] num the number of elements.
+ *
+ * @return a pointer to the array.
+ */
+double *memory_arena::alloc_double (const size_t num)
+{
+    return (static_cast<double *> (alloc (num * sizeof(double))));
+}
+
+
+/**
+ * @brief Allocates an array of pointers to doubles.
+ *
+ * @param[in] num the number of elements.
+ *
+ * @return a pointer to the array.
+ */
+double **memory_arena::alloc_double_ptr (const size_t num)
+{
+    return (static_cast<double **> (alloc (num * sizeof(double *))));
+}
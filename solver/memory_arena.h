@@ -0,0 +1,68 @@
+/**
+ * @file
+ * @author agent
+ */
+
+
+#ifndef MEMORY_ARENA_H
+#define MEMORY_ARENA_H
+
+/****************************************
+ * INCLUDES 
+ ****************************************/
+
+#include "smpc_common.h"
+
+
+/****************************************
+ * DEFINES
+ ****************************************/
+
+/// @addtogroup gINTERNALS
+/// @{
+
+/// All chunks of memory allocated in an arena are aligned to this boundary.
+#define SMPC_CACHE_LINE_SIZE 64
+
+
+/****************************************
+ * TYPEDEFS 
+ ****************************************/
+
+/**
+ * @brief A single block of memory, which is split into cache line aligned
+ * chunks. The chunks are never released separately.
+ *
+ * @attention The arena never returns NULL: if the memory is not sufficient,
+ * the program is aborted, since this is a bug in the computation of the
+ * memory footprint or a block of insufficient size provided by the caller.
+ */
+class memory_arena
+{
+    public:
+        memory_arena (const size_t, void *, const size_t);
+        ~memory_arena();
+
+        void *alloc (const size_t);
+        double *alloc_double (const size_t);
+        double **alloc_double_ptr (const size_t);
+
+        static size_t aligned_size (const size_t);
+
+
+    private:
+        /// Memory allocated by the arena, NULL if the memory is owned by the caller.
+        char *own_memory;
+
+        /// Aligned start of the memory.
+        char *memory;
+
+        /// The number of available bytes.
+        size_t size;
+
+        /// The number of allocated bytes.
+        size_t used;
+};
+
+///@}
+#endif /*MEMORY_ARENA_H*/
@@ -0,0 +1,89 @@
+/**
+ * @file
+ * @author agent
+ */
+
+
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+/****************************************
+ * INCLUDES
+ ****************************************/
+
+#include "solver_config.h"
+#include "smpc_common.h"
+
+#if defined(SMPC_PHASE_TIMERS) || defined(SMPC_TRACE)
+#include <time.h> // clock_gettime
+#endif
+
+
+/****************************************
+ * FUNCTIONS
+ ****************************************/
+
+/// @addtogroup gINTERNALS
+/// @{
+
+#if defined(SMPC_PHASE_TIMERS) || defined(SMPC_TRACE)
+/**
+ * @return monotonic time [nanoseconds].
+ */
+inline double get_monotonic_time_ns ()
+{
+    timespec ts;
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+#endif
+
+
+/****************************************
+ * TYPEDEFS
+ ****************************************/
+
+/**
+ * @brief Measures the duration of a phase of a solver: the time between
+ * construction and destruction of an instance is added to smpc#solve_stats.
+ *
+ * @note If the library is built without SMPC_PHASE_TIMERS the class is empty
+ * and all calls are removed by the compiler.
+ */
+class phase_timer
+{
+    public:
+#ifdef SMPC_PHASE_TIMERS
+        /**
+         * @brief Starts the timer.
+         *
+         * @param[in,out] stats_ statistics, which are updated on destruction.
+         * @param[in] phase_ the measured phase.
+         */
+        phase_timer (smpc::solve_stats &stats_, const smpc::solverPhase phase_) :
+            stats (stats_), phase (phase_)
+        {
+            start_ns = get_monotonic_time_ns();
+        }
+
+        /**
+         * @brief Stops the timer.
+         */
+        ~phase_timer ()
+        {
+            stats.time_ns[phase] += get_monotonic_time_ns() - start_ns;
+            ++stats.calls[phase];
+        }
+
+
+    private:
+        smpc::solve_stats &stats;
+        const smpc::solverPhase phase;
+        double start_ns;
+#else
+        phase_timer (smpc::solve_stats &, const smpc::solverPhase) {}
+#endif
+};
+
+///@}
+#endif /*PHASE_TIMER_H*/
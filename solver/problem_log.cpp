@@ -0,0 +1,424 @@
+/**
+ * @file
+ * @author agent
+ * @brief Recording and replaying of the problems, see smpc#problem_recorder
+ *  and smpc#problem_log.
+ */
+
+
+/****************************************
+ * INCLUDES
+ ****************************************/
+
+#include "smpc_solver.h"
+
+#include <cstring> // memcpy, memcmp
+
+#include <fcntl.h> // open
+#include <unistd.h> // close
+#include <sys/mman.h> // mmap
+#include <sys/stat.h> // fstat
+
+
+/****************************************
+ * DEFINES
+ ****************************************/
+
+/// The version of the format of the logs.
+#define SMPC_LOG_VERSION 1
+
+
+/****************************************
+ * TYPEDEFS
+ ****************************************/
+
+namespace smpc
+{
+    /// The header of a log.
+    struct problem_log_header
+    {
+        /// "SMPR"
+        char magic[4];
+        unsigned int version;
+        /// Number of sampling times in a preview window.
+        int N;
+        /// The number of doubles in a record.
+        unsigned int record_size;
+    };
+
+
+    /// Offsets of the fields of a record (see smpc#problem_recorder).
+    enum problem_log_field
+    {
+        LOG_T = 0,
+        LOG_H = 1,
+        LOG_ANGLE = 2,
+        LOG_ZREF_X = 3,
+        LOG_ZREF_Y = 4,
+        LOG_LB = 5,
+        LOG_UB = 7,
+        LOG_FP_X = 9,
+        LOG_FP_Y = 10,
+        /// The fields after this one are not arrays.
+        LOG_H_INITIAL = 11
+    };
+}
+
+
+/****************************************
+ * FUNCTIONS
+ ****************************************/
+
+namespace smpc
+{
+    problem_recorder::problem_recorder (const int N_, const unsigned int buffer_size_)
+    {
+        N = N_;
+        buffer_size = (buffer_size_ > 0) ? buffer_size_ : 1;
+        active = 0;
+        buffered = 0;
+        pending = 0;
+        pending_index = 0;
+        writing = 0;
+        num_records = 0;
+        num_dropped = 0;
+        file = NULL;
+
+        current = new double[record_size(N)];
+        buffer = new double[2 * record_size(N) * buffer_size];
+        memset (current, 0, record_size(N) * sizeof(double));
+    }
+
+
+    problem_recorder::~problem_recorder ()
+    {
+        close();
+
+        if (current != NULL)
+        {
+            delete [] current;
+        }
+        if (buffer != NULL)
+        {
+            delete [] buffer;
+        }
+    }
+
+
+    unsigned int problem_recorder::record_size (const int N_)
+    {
+        return (LOG_H_INITIAL*N_ + 1 + SMPC_NUM_STATE_VAR + 1);
+    }
+
+
+    bool problem_recorder::open (const char *filename)
+    {
+        close();
+
+        file = fopen (filename, "wb");
+        if (file == NULL)
+        {
+            fprintf (stderr, "Cannot create the log of problems '%s'\n", filename);
+            return (false);
+        }
+
+        problem_log_header header;
+        memcpy (header.magic, "SMPR", sizeof(header.magic));
+        header.version = SMPC_LOG_VERSION;
+        header.N = N;
+        header.record_size = record_size(N);
+
+        if (fwrite (&header, sizeof(header), 1, file) != 1)
+        {
+            fprintf (stderr, "Cannot write the log of problems '%s'\n", filename);
+            fclose (file);
+            file = NULL;
+            return (false);
+        }
+
+        num_records = 0;
+        num_dropped = 0;
+        active = 0;
+        buffered = 0;
+        pending = 0;
+        return (true);
+    }
+
+
+    /**
+     * @brief Writes the full buffer, if there is one.
+     *
+     * @param[out] result set to false on failure.
+     *
+     * @return false if the buffer is being written by another thread.
+     */
+    bool problem_recorder::write_pending (bool &result)
+    {
+#ifdef __GNUC__
+        if (!__sync_bool_compare_and_swap (&writing, 0, 1))
+        {
+            return (false);
+        }
+#endif
+
+        const unsigned int num = pending;
+        if (num > 0)
+        {
+#ifdef __GNUC__
+            // pending_index and the records were stored before pending
+            __sync_synchronize();
+#endif
+            const unsigned int size = record_size(N);
+            if (fwrite (&buffer[pending_index * buffer_size * size], size * sizeof(double), num, file) != num)
+            {
+                fprintf (stderr, "Cannot write the log of problems.\n");
+                result = false;
+            }
+#ifdef __GNUC__
+            __sync_synchronize();
+#endif
+            pending = 0;
+        }
+
+#ifdef __GNUC__
+        __sync_lock_release (&writing);
+#endif
+        return (true);
+    }
+
+
+    bool problem_recorder::flush ()
+    {
+        if (file == NULL)
+        {
+            return (false);
+        }
+
+        bool result = true;
+        // if the solver thread is writing the buffer, it is flushed below
+        write_pending (result);
+        if (fflush (file) != 0)
+        {
+            fprintf (stderr, "Cannot write the log of problems.\n");
+            result = false;
+        }
+        return (result);
+    }
+
+
+    bool problem_recorder::close ()
+    {
+        if (file == NULL)
+        {
+            return (true);
+        }
+
+        bool result = true;
+        write_pending (result);
+        if (buffered > 0)
+        {
+            const unsigned int size = record_size(N);
+            if (fwrite (&buffer[active * buffer_size * size], size * sizeof(double), buffered, file) != buffered)
+            {
+                fprintf (stderr, "Cannot write the log of problems.\n");
+                result = false;
+            }
+            buffered = 0;
+        }
+        if (fclose (file) != 0)
+        {
+            result = false;
+        }
+        file = NULL;
+        return (result);
+    }
+
+
+    void problem_recorder::record_parameters (
+            const double* T,
+            const double* h,
+            const double h_initial,
+            const double* angle,
+            const double* zref_x,
+            const double* zref_y,
+            const double* lb,
+            const double* ub)
+    {
+        if (file == NULL)
+        {
+            return;
+        }
+
+        memcpy (&current[LOG_T*N],      T,      N * sizeof(double));
+        memcpy (&current[LOG_H*N],      h,      N * sizeof(double));
+        memcpy (&current[LOG_ANGLE*N],  angle,  N * sizeof(double));
+        memcpy (&current[LOG_ZREF_X*N], zref_x, N * sizeof(double));
+        memcpy (&current[LOG_ZREF_Y*N], zref_y, N * sizeof(double));
+        memcpy (&current[LOG_LB*N],     lb,     2*N * sizeof(double));
+        memcpy (&current[LOG_UB*N],     ub,     2*N * sizeof(double));
+        current[LOG_H_INITIAL*N] = h_initial;
+    }
+
+
+    void problem_recorder::record_init_fp (
+            const double *x_coord,
+            const double *y_coord,
+            const double *init_state,
+            const bool tilde_state)
+    {
+        if (file == NULL)
+        {
+            return;
+        }
+
+        const unsigned int size = record_size(N);
+
+        memcpy (&current[LOG_FP_X*N], x_coord, N * sizeof(double));
+        memcpy (&current[LOG_FP_Y*N], y_coord, N * sizeof(double));
+        memcpy (&current[LOG_H_INITIAL*N + 1], init_state, SMPC_NUM_STATE_VAR * sizeof(double));
+        current[size - 1] = tilde_state ? 1.0 : 0.0;
+
+        memcpy (&buffer[(active * buffer_size + buffered) * size], current, size * sizeof(double));
+        ++buffered;
+        ++num_records;
+
+        if (buffered == buffer_size)
+        {
+            bool result = true;
+            // flush() has not written the other buffer in time, it is
+            // written here; if flush() is writing it now, the record is
+            // dropped instead of waiting.
+            if ((pending > 0) && !write_pending (result))
+            {
+                --buffered;
+                --num_records;
+                ++num_dropped;
+                return;
+            }
+
+            pending_index = active;
+#ifdef __GNUC__
+            __sync_synchronize();
+#endif
+            pending = buffered;
+            active = 1 - active;
+            buffered = 0;
+        }
+    }
+
+
+    //************************************************************
+
+
+    problem_log::problem_log ()
+    {
+        N = 0;
+        size = 0;
+        data = NULL;
+        data_size = 0;
+        records = NULL;
+    }
+
+
+    problem_log::~problem_log ()
+    {
+        close();
+    }
+
+
+    bool problem_log::open (const char *filename)
+    {
+        close();
+
+        const int fd = ::open (filename, O_RDONLY);
+        if (fd == -1)
+        {
+            fprintf (stderr, "Cannot open the log of problems '%s'\n", filename);
+            return (false);
+        }
+
+        struct stat file_stat;
+        if ((fstat (fd, &file_stat) != 0)
+                || (file_stat.st_size < (off_t) sizeof(problem_log_header)))
+        {
+            fprintf (stderr, "The log of problems '%s' is empty or cannot be read.\n", filename);
+            ::close (fd);
+            return (false);
+        }
+
+        data_size = file_stat.st_size;
+        data = mmap (NULL, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close (fd);
+        if (data == MAP_FAILED)
+        {
+            fprintf (stderr, "Cannot map the log of problems '%s'\n", filename);
+            data = NULL;
+            data_size = 0;
+            return (false);
+        }
+
+        const problem_log_header *header = static_cast<const problem_log_header *> (data);
+        if ((memcmp (header->magic, "SMPR", sizeof(header->magic)) != 0)
+                || (header->version != SMPC_LOG_VERSION)
+                || (header->N <= 0)
+                || (header->record_size != problem_recorder::record_size(header->N)))
+        {
+            fprintf (stderr, "'%s' is not a log of problems.\n", filename);
+            close();
+            return (false);
+        }
+
+        N = header->N;
+        records = reinterpret_cast<const double *> (header + 1);
+        // an incomplete record at the end is ignored
+        size = (data_size - sizeof(problem_log_header)) / (header->record_size * sizeof(double));
+
+        // the problems are replayed sequentially
+        madvise (data, data_size, MADV_SEQUENTIAL);
+        return (true);
+    }
+
+
+    void problem_log::close ()
+    {
+        if (data != NULL)
+        {
+            munmap (data, data_size);
+        }
+        N = 0;
+        size = 0;
+        data = NULL;
+        data_size = 0;
+        records = NULL;
+    }
+
+
+    void problem_log::replay (const unsigned int index, solver &s, double *X) const
+    {
+        const double *record = &records[index * problem_recorder::record_size(N)];
+
+        s.set_parameters (
+                &record[LOG_T*N],
+                &record[LOG_H*N],
+                record[LOG_H_INITIAL*N],
+                &record[LOG_ANGLE*N],
+                &record[LOG_ZREF_X*N],
+                &record[LOG_ZREF_Y*N],
+                &record[LOG_LB*N],
+                &record[LOG_UB*N]);
+
+        const double *init_state = &record[LOG_H_INITIAL*N + 1];
+        if (record[LOG_H_INITIAL*N + 1 + SMPC_NUM_STATE_VAR] > 0.5)
+        {
+            state_zmp state;
+            memcpy (state.state_vector, init_state, SMPC_NUM_STATE_VAR * sizeof(double));
+            s.form_init_fp (&record[LOG_FP_X*N], &record[LOG_FP_Y*N], state, X);
+        }
+        else
+        {
+            state_com state;
+            memcpy (state.state_vector, init_state, SMPC_NUM_STATE_VAR * sizeof(double));
+            s.form_init_fp (&record[LOG_FP_X*N], &record[LOG_FP_Y*N], state, X);
+        }
+    }
+}
@@ -11,8 +11,12 @@
 #include "qp.h"
 #include "qp_as.h"
 #include "state_handling.h"
+#include "solver_config.h"
+#include "phase_timer.h"
+#include "trace.h"
 
 #include <cmath> //cos,sin
+#include <cstring> // memcpy
 
 
 using namespace AS;
@@ -32,6 +36,9 @@ using namespace AS;
     @param[in] obj_computation_on_ enable computation of the objective function
     @param[in] max_added_constraints_num_ limit on the number of the added constraints
     @param[in] constraint_removal_on_ enable constraint removal
+    @param[in] memory_block memory for the workspaces, see #memory_footprint,
+        allocated if NULL.
+    @param[in] block_size the size of memory_block in bytes.
 */
 qp_as::qp_as(
         const int N_, 
@@ -42,13 +49,80 @@ qp_as::qp_as(
         const double tol_,
         const bool obj_computation_on_,
         const unsigned int max_added_constraints_num_,
-        const bool constraint_removal_on_) : 
-    problem_parameters (N_, gain_position, gain_velocity, gain_acceleration, gain_jerk),
-    chol (N_)
+        const bool constraint_removal_on_,
+        void *memory_block,
+        const size_t block_size) : 
+    memory_arena (memory_footprint (N_), memory_block, block_size),
+    problem_parameters (N_, gain_position, gain_velocity, gain_acceleration, gain_jerk, *this),
+    dX (alloc_double (SMPC_NUM_VAR*N_)),
+    chol (N_, *this, stats)
 {
-    dX = new double[SMPC_NUM_VAR*N]();
+    zref_copy = alloc_double (2*N);
+    init (tol_, obj_computation_on_, max_added_constraints_num_, constraint_removal_on_);
+}
+
+
+/**
+ * @brief Constructor of a checkpoint: the constant parameters are copied
+ * from another instance, the state is not copied (see #copy_state).
+ *
+ * @param[in] from an instance of the class.
+ */
+qp_as::qp_as (const qp_as &from) :
+    memory_arena (memory_footprint (from.N), NULL, 0),
+    problem_parameters (from, *this),
+    dX (alloc_double (SMPC_NUM_VAR*from.N)),
+    chol (from.N, *this, stats)
+{
+    zref_copy = alloc_double (2*N);
+    init (from.tol, from.obj_computation_on, from.max_added_constraints_num, from.constraint_removal_on);
+}
+
+
+/**
+ * @brief Creates a checkpoint, which can hold the state of an instance.
+ *
+ * @param[in] from an instance of the class.
+ *
+ * @return a new instance with the same parameters, must be deleted by the
+ * caller.
+ */
+qp_as * qp_as::create_checkpoint (const qp_as &from)
+{
+    return (new qp_as (from));
+}
+
+
+/**
+ * @brief Initializes the variables, which are common for all constructors.
+ *
+ * @param[in] tol_ tolerance
+ * @param[in] obj_computation_on_ enable computation of the objective function
+ * @param[in] max_added_constraints_num_ limit on the number of the added constraints
+ * @param[in] constraint_removal_on_ enable constraint removal
+ */
+void qp_as::init (
+        const double tol_,
+        const bool obj_computation_on_,
+        const unsigned int max_added_constraints_num_,
+        const bool constraint_removal_on_)
+{
+    X = NULL;
+    zref_x = NULL;
+    zref_y = NULL;
+    alpha = 0.0;
 
     constraints.resize(2*N);
+    active_set.reserve(2*N);
+
+    added_constraints_num = 0;
+    removed_constraints_num = 0;
+    active_set_size = 0;
+
+    trace = NULL;
+    trace_id = 0;
+    callback = NULL;
+    callback_data = NULL;
 
     tol = tol_,
     obj_computation_on = obj_computation_on_;
@@ -62,11 +136,39 @@ qp_as::qp_as(
 }
 
 
-/** Destructor */
-qp_as::~qp_as()
+/**
+ * @brief Returns the size of memory, which is necessary for the workspaces.
+ *
+ * @param[in] N size of the preview window.
+ *
+ * @return the number of bytes.
+ */
+size_t qp_as::memory_footprint (const int N)
 {
-    if (dX != NULL)
-        delete dX;
+    // the memory block may be not aligned
+    return (SMPC_CACHE_LINE_SIZE
+            + problem_parameters::memory_footprint (N)
+            + memory_arena::aligned_size (sizeof(double) * SMPC_NUM_VAR*N)
+            + chol_solve::memory_footprint (N)
+            + memory_arena::aligned_size (sizeof(double) * 2*N));
+}
+
+
+/**
+ * @brief Sets the data, which is shared with other instances of the class.
+ *
+ * @param[in] shared shared data, NULL to disable sharing.
+ */
+void qp_as::set_shared (const qp_as_shared *shared)
+{
+    if (shared == NULL)
+    {
+        chol.shared_ecL = NULL;
+    }
+    else
+    {
+        chol.shared_ecL = &shared->ecL;
+    }
 }
 
 
@@ -91,6 +193,9 @@ void qp_as::set_parameters(
         const double* lb,
         const double* ub)
 {
+    stats.reset();
+    phase_timer timer (stats, smpc::SMPC_PHASE_SET_PARAMETERS);
+
     set_state_parameters (T_, h_, h_initial_);
 
     zref_x = zref_x_;
@@ -145,12 +250,82 @@ void qp_as::form_init_fp (
         const bool tilde_state,
         double* X_)
 {
+    phase_timer timer (stats, smpc::SMPC_PHASE_FORM_INIT_FP);
+
     X = X_;
     form_init_fp_tilde<problem_parameters>(*this, x_coord, y_coord, init_state, tilde_state, X);
 }
 
 
 
+/**
+ * @brief Copies the state of the solver: parameters of the problem, 
+ * active set, Cholesky factors, the solution and counters. No memory 
+ * is allocated.
+ *
+ * @param[in] from an instance of the class to copy the state from, 
+ *  it must have the same size of the preview window.
+ *
+ * @return false if the sizes of the preview windows differ, nothing is
+ * copied in this case.
+ *
+ * @note The solution is copied to the memory, which is currently used
+ * by this instance of the class (see #form_init_fp).
+ *
+ * @note The reference positions of ZMP are copied to #zref_copy, since
+ * the caller may reuse its arrays or destroy the instance @a from.
+ */
+bool qp_as::copy_state (const qp_as &from)
+{
+    if (N != from.N)
+    {
+        return (false);
+    }
+
+    h_initial = from.h_initial;
+    for (int i = 0; i < N; ++i)
+    {
+        spar[i] = from.spar[i];
+    }
+
+    if (from.zref_x == NULL)
+    {
+        zref_x = NULL;
+        zref_y = NULL;
+    }
+    else
+    {
+        // the arrays of a distinct instance never overlap with zref_copy
+        if (from.zref_x != zref_copy)
+        {
+            memcpy (zref_copy, from.zref_x, sizeof(double) * N);
+            memcpy (zref_copy + N, from.zref_y, sizeof(double) * N);
+        }
+        zref_x = zref_copy;
+        zref_y = zref_copy + N;
+    }
+
+    // the capacity is sufficient, no memory is allocated
+    constraints = from.constraints;
+    active_set = from.active_set;
+    chol.copy_state (from.chol, N, active_set.size());
+
+    if ((X != NULL) && (from.X != NULL))
+    {
+        memcpy (X, from.X, sizeof(double) * N*SMPC_NUM_VAR);
+    }
+    memcpy (dX, from.dX, sizeof(double) * N*SMPC_NUM_VAR);
+    alpha = from.alpha;
+
+    added_constraints_num = from.added_constraints_num;
+    removed_constraints_num = from.removed_constraints_num;
+    active_set_size = from.active_set_size;
+
+    return (true);
+}
+
+
+
 /**
  * @brief Checks for blocking constraints.
  *
@@ -158,6 +333,8 @@ void qp_as::form_init_fp (
  */
 int qp_as::check_blocking_constraints()
 {
+    phase_timer timer (stats, smpc::SMPC_PHASE_CHECK_CONSTRAINTS);
+
     alpha = 1;
 
     /* Index to include in the working set, -1 if no constraint have to be included. */
@@ -204,6 +381,8 @@ int qp_as::check_blocking_constraints()
         constraints[activated_var_num].sign = sign;
         constraints[activated_var_num].isActive = true;
         active_set.push_back(constraints[activated_var_num]);
+
+        trace_instant (trace, trace_id, smpc::SMPC_TRACE_ADD_CONSTRAINT, activated_var_num, alpha);
     }
 
     return (activated_var_num);
@@ -225,6 +404,8 @@ int qp_as::check_blocking_constraints()
  */
 int qp_as::choose_excl_constr (const double *lambda)
 {
+    phase_timer timer (stats, smpc::SMPC_PHASE_CHECK_CONSTRAINTS);
+
     double min_lambda = -tol;
     int ind_exclude = -1;
 
@@ -240,6 +421,8 @@ int qp_as::choose_excl_constr (const double *lambda)
 
     if (ind_exclude != -1)
     {
+        trace_instant (trace, trace_id, smpc::SMPC_TRACE_REMOVE_CONSTRAINT, active_set[ind_exclude].cind, 0.0);
+
         constraints[active_set[ind_exclude].cind].isActive = false;
         active_set.erase(active_set.begin()+ind_exclude);
     }
@@ -248,6 +431,39 @@ int qp_as::choose_excl_constr (const double *lambda)
 }
 
 
+/**
+ * @brief Passes the state of the solver to the iteration callback.
+ *
+ * @param[in] iteration the number of the iteration.
+ * @param[in] obj_log a vector of objective function values.
+ *
+ * @return false if the solver must stop.
+ */
+#ifdef SMPC_ITERATION_CALLBACK
+bool qp_as::report_iteration (const unsigned int iteration, const vector<double> &obj_log) const
+{
+    if (callback != NULL)
+    {
+        smpc::iteration_record record;
+        record.iteration = iteration;
+        record.active_set_size = active_set.size();
+        record.alpha = alpha;
+        record.objective = obj_computation_on ? obj_log.back() : compute_obj(false);
+        record.decrement = 0.0;
+        record.kappa = 0.0;
+
+        return (callback (record, callback_data));
+    }
+    return (true);
+}
+#else
+bool qp_as::report_iteration (const unsigned int, const vector<double> &) const
+{
+    return (true);
+}
+#endif
+
+
 /**
  * @brief Solve QP problem.
  *
@@ -257,6 +473,9 @@ int qp_as::choose_excl_constr (const double *lambda)
  */
 void qp_as::solve (vector<double> &obj_log)
 {
+    phase_timer timer (stats, smpc::SMPC_PHASE_SOLVE);
+    trace_scope solve_trace (trace, trace_id, smpc::SMPC_TRACE_SOLVE);
+
     for (int i = 0; i < N; ++i)
     {
         const int ind = i*SMPC_NUM_STATE_VAR;
@@ -266,13 +485,16 @@ void qp_as::solve (vector<double> &obj_log)
     if (obj_computation_on)
     {
         obj_log.clear();
-        obj_log.push_back(compute_obj());
+        obj_log.push_back(compute_obj(false));
     }
 
     // obtain dX
-    chol.solve(*this, X, dX);
+    {
+        phase_timer init_timer (stats, smpc::SMPC_PHASE_INIT_SOLVE);
+        chol.solve(*this, X, dX);
+    }
 
-    for (;;)
+    for (unsigned int iteration = 1; ; ++iteration)
     {
         int activated_var_num = check_blocking_constraints();
 
@@ -291,21 +513,24 @@ void qp_as::solve (vector<double> &obj_log)
 
         if (obj_computation_on)
         {
-            obj_log.push_back(compute_obj());
+            obj_log.push_back(compute_obj(false));
         }
 
+        const bool proceed = report_iteration (iteration, obj_log);
+
         if (activated_var_num != -1)
         {
             ++added_constraints_num;
-            if (added_constraints_num == max_added_constraints_num)
+            if ((added_constraints_num == max_added_constraints_num) || !proceed)
             {
                 break;
             }
 
             // add row to the L matrix and find new dX
+            phase_timer up_timer (stats, smpc::SMPC_PHASE_UP_RESOLVE);
             chol.up_resolve (*this, active_set, X, dX);
         }
-        else if (constraint_removal_on)
+        else if (constraint_removal_on && proceed)
         {
             // no new inequality constraints
             int ind_exclude = choose_excl_constr (chol.get_lambda(*this));
@@ -314,6 +539,7 @@ void qp_as::solve (vector<double> &obj_log)
                 break;
             }
 
+            phase_timer down_timer (stats, smpc::SMPC_PHASE_DOWN_RESOLVE);
             chol.down_resolve (*this, active_set, ind_exclude, X, dX);
             ++removed_constraints_num;
         }
@@ -331,6 +557,7 @@ void qp_as::solve (vector<double> &obj_log)
     }
 
     active_set_size = active_set.size();
+    solve_trace.set_index (added_constraints_num + removed_constraints_num);
 }
 
 
@@ -338,9 +565,12 @@ void qp_as::solve (vector<double> &obj_log)
 /**
  * @brief Compute value of the objective function.
  *
+ * @param[in] subtract_zref the reference ZMP positions are not subtracted
+ *          from #X, this is the case after #solve.
+ *
  * @return value of the objective function.
  */
-double qp_as::compute_obj()
+double qp_as::compute_obj(const bool subtract_zref) const
 {
     int i,j;
     double obj_pos = 0;
@@ -353,7 +583,12 @@ double qp_as::compute_obj()
         i < N*SMPC_NUM_STATE_VAR;
         i += SMPC_NUM_STATE_VAR, j += 2)
     {
-        const double X_copy[6] = {X[i], X[i+1], X[i+2], X[i+3], X[i+4], X[i+5]};
+        double X_copy[6] = {X[i], X[i+1], X[i+2], X[i+3], X[i+4], X[i+5]};
+        if (subtract_zref)
+        {
+            X_copy[0] -= zref_x[j/2];
+            X_copy[3] -= zref_y[j/2];
+        }
 
         // X'*H*X
         obj_pos += X_copy[0]*X_copy[0] + X_copy[3]*X_copy[3];
@@ -369,3 +604,60 @@ double qp_as::compute_obj()
     return (0.5*(obj_pos/i2Q[0] + obj_vel/i2Q[1] + obj_acc/i2Q[2] + obj_jerk/i2P));
 }
 
+
+
+
+//==============================================
+// qp_as_shared
+
+/** @brief Constructor.
+
+    @param[in] N_ Number of sampling times in a preview window
+    @param[in] gain_position Position gain
+    @param[in] gain_velocity Velocity gain
+    @param[in] gain_acceleration Acceleration gain
+    @param[in] gain_jerk Jerk gain
+*/
+qp_as_shared::qp_as_shared(
+        const int N_, 
+        const double gain_position, 
+        const double gain_velocity, 
+        const double gain_acceleration, 
+        const double gain_jerk) : 
+    memory_arena (memory_footprint (N_), NULL, 0),
+    problem_parameters (N_, gain_position, gain_velocity, gain_acceleration, gain_jerk, *this),
+    ecL (N_, *this)
+{
+}
+
+
+/**
+ * @brief Returns the size of memory, which is necessary for the shared data.
+ *
+ * @param[in] N size of the preview window.
+ *
+ * @return the number of bytes.
+ */
+size_t qp_as_shared::memory_footprint (const int N)
+{
+    return (SMPC_CACHE_LINE_SIZE
+            + problem_parameters::memory_footprint (N)
+            + matrix_ecL::memory_footprint (N));
+}
+
+
+/**
+ * @brief Forms the shared Cholesky factor.
+ *
+ * @param[in] T_ Sampling time [sec.]
+ * @param[in] h_ Height of the Center of Mass divided by gravity
+ * @param[in] h_initial_ current h
+ */
+void qp_as_shared::set_parameters(
+        const double* T_, 
+        const double* h_, 
+        const double h_initial_)
+{
+    set_state_parameters (T_, h_, h_initial_);
+    ecL.form (*this);
+}
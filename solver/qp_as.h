@@ -16,6 +16,7 @@
 #include "as_chol_solve.h"
 #include "as_constraint.h"
 #include "as_problem_param.h"
+#include "memory_arena.h"
 
 #include <vector>
 
@@ -30,13 +31,51 @@ using namespace std;
 /// @addtogroup gAS
 /// @{
 
+/**
+ * @brief Data, which can be shared by several instances of #qp_as with the
+ * same gains: the Cholesky factor corresponding to the equality constraints,
+ * which depends only on the sampling times and heights of the CoM (including
+ * the initial height, which enters the first state transition matrix).
+ *
+ * @attention The instances of #qp_as use this data without locking, it must
+ * not be changed while they are solving problems.
+ */
+class qp_as_shared : protected memory_arena, public AS::problem_parameters
+{
+    public:
+        qp_as_shared(
+                const int N_, 
+                const double, 
+                const double, 
+                const double,
+                const double);
+
+        static size_t memory_footprint (const int);
+
+        void set_parameters(
+                const double*, 
+                const double*, 
+                const double);
+
+        /// Cholesky factor corresponding to the equality constraints.
+        AS::matrix_ecL ecL;
+};
+
+
+
 /** 
  * @brief Solve a quadratic program with a specific structure. 
  * qp_as = Quadratic Programming / Active Set
+ *
+ * @note All workspaces are allocated in a single #memory_arena, which is
+ * a base class, since it must be initialized before the other bases and 
+ * members.
  */
-class qp_as : public AS::problem_parameters
+class qp_as : protected memory_arena, public AS::problem_parameters
 {
     public:
+        friend class kernel_access;
+
 // functions        
         qp_as(
                 const int N_, 
@@ -47,8 +86,12 @@ class qp_as : public AS::problem_parameters
                 const double, 
                 const bool,
                 const unsigned int,
-                const bool);
-        ~qp_as();
+                const bool,
+                void *,
+                const size_t);
+
+        static size_t memory_footprint (const int);
+        static qp_as * create_checkpoint (const qp_as &);
 
         void set_parameters(
                 const double*, 
@@ -69,6 +112,9 @@ class qp_as : public AS::problem_parameters
                 const bool, 
                 double *);
 
+        bool copy_state (const qp_as &);
+        void set_shared (const qp_as_shared *);
+        double compute_obj(const bool) const;
 
         /** Variables for the QP (contain the states + control variables).
             Initial feasible point with respect to the equality and inequality 
@@ -80,6 +126,16 @@ class qp_as : public AS::problem_parameters
         unsigned int added_constraints_num;
         unsigned int removed_constraints_num;
         unsigned int active_set_size;
+        /// Durations of the phases.
+        smpc::solve_stats stats;
+        /// The buffer of events, NULL if tracing is disabled.
+        smpc::trace_buffer *trace;
+        /// Identifier of the solver in the trace.
+        unsigned int trace_id;
+        /// The function called after each iteration, may be NULL.
+        smpc::iteration_callback callback;
+        /// The pointer passed to #callback.
+        void *callback_data;
     // limits
         bool constraint_removal_on;
         unsigned int max_added_constraints_num;
@@ -88,12 +144,19 @@ class qp_as : public AS::problem_parameters
     private:
 
 // functions        
+        qp_as (const qp_as &);
+        void init (const double, const bool, const unsigned int, const bool);
         int check_blocking_constraints();
         int choose_excl_constr (const double *);
-        double compute_obj();
+        bool report_iteration (const unsigned int, const vector<double> &) const;
 
 // variables        
 
+    // descent direction
+        /** Feasible descent direction (to be used for updating #X). 
+         * @attention Must be declared before #chol, see the constructor. */
+        double *dX;
+
         /// An instance of AS#chol_solve class.
         AS::chol_solve chol;
 
@@ -101,6 +164,9 @@ class qp_as : public AS::problem_parameters
         const double *zref_x;
         const double *zref_y;
 
+        /// Copies of #zref_x and #zref_y (2*#N), see #copy_state.
+        double *zref_copy;
+
         /// tolerance
         double tol;
 
@@ -114,10 +180,6 @@ class qp_as : public AS::problem_parameters
         vector <AS::constraint> constraints;
 
 
-    // descent direction
-        /** Feasible descent direction (to be used for updating #X). */
-        double *dX;
-
         /** A number from 0 to 1, which controls depth of descent #X = #X + #alpha*#dX. */
         double alpha;        
 };
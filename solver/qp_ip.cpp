@@ -11,9 +11,13 @@
 #include "qp_ip.h"
 #include "state_handling.h"
 #include "qp.h"
+#include "solver_config.h"
+#include "phase_timer.h"
+#include "trace.h"
 
 
 #include <cmath> // log
+#include <cstring> // memcpy
 
 /****************************************
  * FUNCTIONS
@@ -34,6 +38,9 @@ using namespace IP;
     @param[in] tol_ tolerance
     @param[in] obj_computation_on_ enable computation of the objective function
     @param[in] bs_type_ type of backtracking search
+    @param[in] memory_block memory for the workspaces, see #memory_footprint,
+        allocated if NULL.
+    @param[in] block_size the size of memory_block in bytes.
 */
 qp_ip::qp_ip(
         const int N_, 
@@ -43,20 +50,21 @@ qp_ip::qp_ip(
         const double gain_jerk_,
         const double tol_,
         const bool obj_computation_on_,
-        const backtrackingSearchType bs_type_) :
-    problem_parameters (N_, gain_position_, gain_velocity_, gain_acceleration_, gain_jerk_),
-    chol (N_)
+        const backtrackingSearchType bs_type_,
+        void *memory_block,
+        const size_t block_size) :
+    memory_arena (memory_footprint (N_), memory_block, block_size),
+    problem_parameters (N_, gain_position_, gain_velocity_, gain_acceleration_, gain_jerk_, *this),
+    // ordered by access pattern
+    dX (alloc_double (SMPC_NUM_VAR*N_)),
+    g (alloc_double (2*N_)),
+    i2hess (alloc_double (2*N_)),
+    i2hess_grad (alloc_double (N_*SMPC_NUM_VAR)),
+    grad (alloc_double (2*N_)),
+    chol (N_, *this, stats)
 {
-    dX = new double[SMPC_NUM_VAR*N]();
-    g = new double[2*N];
-    i2hess = new double[2*N];
-    i2hess_grad = new double[N*SMPC_NUM_VAR];
-    grad = new double[2*N];
-
-    tol = tol_;
-
-    obj_computation_on = obj_computation_on_;
-    bs_type = bs_type_;
+    parameters_copy = alloc_double (6*N);
+    init (tol_, obj_computation_on_, bs_type_);
 
     gain_position = gain_position_;
 
@@ -67,19 +75,103 @@ qp_ip::qp_ip(
 }
 
 
-/** Destructor */
-qp_ip::~qp_ip()
+/**
+ * @brief Constructor of a checkpoint: the constant parameters are copied
+ * from another instance, the state is not copied (see #copy_state).
+ *
+ * @param[in] from an instance of the class.
+ */
+qp_ip::qp_ip (const qp_ip &from) :
+    memory_arena (memory_footprint (from.N), NULL, 0),
+    problem_parameters (from, *this),
+    // ordered by access pattern
+    dX (alloc_double (SMPC_NUM_VAR*from.N)),
+    g (alloc_double (2*from.N)),
+    i2hess (alloc_double (2*from.N)),
+    i2hess_grad (alloc_double (from.N*SMPC_NUM_VAR)),
+    grad (alloc_double (2*from.N)),
+    chol (from.N, *this, stats)
+{
+    parameters_copy = alloc_double (6*N);
+    init (from.tol, from.obj_computation_on, from.bs_type);
+    set_ip_parameters (from.t, from.mu, from.bs_alpha, from.bs_beta, from.max_iter, from.tol_out);
+
+    gain_position = from.gain_position;
+
+    Q[0] = from.Q[0];
+    Q[1] = from.Q[1];
+    Q[2] = from.Q[2];
+    P = from.P;
+}
+
+
+/**
+ * @brief Creates a checkpoint, which can hold the state of an instance.
+ *
+ * @param[in] from an instance of the class.
+ *
+ * @return a new instance with the same parameters, must be deleted by the
+ * caller.
+ */
+qp_ip * qp_ip::create_checkpoint (const qp_ip &from)
+{
+    return (new qp_ip (from));
+}
+
+
+/**
+ * @brief Initializes the variables, which are common for all constructors.
+ *
+ * @param[in] tol_ tolerance
+ * @param[in] obj_computation_on_ enable computation of the objective function
+ * @param[in] bs_type_ type of backtracking search
+ */
+void qp_ip::init (
+        const double tol_,
+        const bool obj_computation_on_,
+        const backtrackingSearchType bs_type_)
+{
+    X = NULL;
+    lb = NULL;
+    ub = NULL;
+    zref_x = NULL;
+    zref_y = NULL;
+
+    int_loop_counter = 0;
+    ext_loop_counter = 0;
+    bs_counter = 0;
+
+    trace = NULL;
+    trace_id = 0;
+    callback = NULL;
+    callback_data = NULL;
+    stop_requested = false;
+
+    tol = tol_;
+
+    obj_computation_on = obj_computation_on_;
+    bs_type = bs_type_;
+}
+
+
+/**
+ * @brief Returns the size of memory, which is necessary for the workspaces.
+ *
+ * @param[in] N size of the preview window.
+ *
+ * @return the number of bytes.
+ */
+size_t qp_ip::memory_footprint (const int N)
 {
-    if (g != NULL)
-        delete g;
-    if (i2hess != NULL)
-        delete i2hess;
-    if (i2hess_grad != NULL)
-        delete i2hess_grad;
-    if (grad != NULL)
-        delete grad;
-    if (dX  != NULL)
-        delete dX;
+    // the memory block may be not aligned
+    return (SMPC_CACHE_LINE_SIZE
+            + problem_parameters::memory_footprint (N)
+            + memory_arena::aligned_size (sizeof(double) * SMPC_NUM_VAR*N)
+            + 2 * memory_arena::aligned_size (sizeof(double) * 2*N)
+            + memory_arena::aligned_size (sizeof(double) * N*SMPC_NUM_VAR)
+            + memory_arena::aligned_size (sizeof(double) * 2*N)
+            + chol_solve::memory_footprint (N)
+            + memory_arena::aligned_size (sizeof(double) * 6*N));
 }
 
 
@@ -104,6 +196,9 @@ void qp_ip::set_parameters(
         const double* lb_,
         const double* ub_)
 {
+    stats.reset();
+    phase_timer timer (stats, SMPC_PHASE_SET_PARAMETERS);
+
     set_state_parameters (T, h, h_initial_, angle);
 
     lb = lb_;
@@ -426,6 +521,9 @@ void qp_ip::set_ip_parameters (
  */
 void qp_ip::solve(vector<double> &obj_log)
 {
+    phase_timer timer (stats, SMPC_PHASE_SOLVE);
+    trace_scope solve_trace (trace, trace_id, SMPC_TRACE_SOLVE);
+
     if (obj_computation_on)
     {
         obj_log.clear();
@@ -438,10 +536,13 @@ void qp_ip::solve(vector<double> &obj_log)
     int_loop_counter = 0;
     ext_loop_counter = 0;
     bs_counter = 0;
+    stop_requested = false;
 
     for (;;)
     {
         ++ext_loop_counter;
+        trace_scope outer_trace (trace, trace_id, SMPC_TRACE_IP_OUTER, ext_loop_counter, kappa);
+
         while ((max_iter == 0) || (int_loop_counter < max_iter))
         {
             ++int_loop_counter;
@@ -450,7 +551,7 @@ void qp_ip::solve(vector<double> &obj_log)
                 break;
             }
         }
-        if ((max_iter == 0) && (int_loop_counter == max_iter))
+        if (((max_iter == 0) && (int_loop_counter == max_iter)) || stop_requested)
         {
             break;
         }
@@ -462,6 +563,7 @@ void qp_ip::solve(vector<double> &obj_log)
             break;
         }
     }
+    solve_trace.set_index (int_loop_counter);
 }
 
 
@@ -504,64 +606,81 @@ bool qp_ip::solve_onestep (const double kappa, vector<double> &obj_log)
 {
     /// Value of phi(X), where phi is the cost function + log barrier.
     double phi_X = 0.0;
+    double decrement;
+
+    // the step length is set only if a step is made
+    trace_scope inner_trace (trace, trace_id, SMPC_TRACE_IP_INNER, int_loop_counter);
 
-    if (bs_type == SMPC_IP_BS_LOGBAR)
-    {
-        phi_X = form_grad_i2hess_logbar (kappa);
-        phi_X += form_phi_X ();
-    }
-    else
     {
-        form_grad_i2hess_logbar (kappa);
-        if (bs_type == SMPC_IP_BS_ORIGINAL)
+        phase_timer newton_timer (stats, SMPC_PHASE_NEWTON_STEP);
+
+        if (bs_type == SMPC_IP_BS_LOGBAR)
         {
-            phi_X = compute_obj(false);
+            phi_X = form_grad_i2hess_logbar (kappa);
+            phi_X += form_phi_X ();
         }
-    }
+        else
+        {
+            form_grad_i2hess_logbar (kappa);
+            if (bs_type == SMPC_IP_BS_ORIGINAL)
+            {
+                phi_X = compute_obj(false);
+            }
+        }
+
 
+        chol.solve (*this, i2hess_grad, i2hess, X, dX);
 
-    chol.solve (*this, i2hess_grad, i2hess, X, dX);
+        decrement = form_decrement ();
+    }
 
 
     // stopping criterion (decrement)
-    if (form_decrement () < tol)
+    if (decrement < tol)
     {
         return (false);
     }
 
 
     // A number from 0 to 1, which controls depth of descent #X = #X + #alpha*#dX.
-    double alpha = init_alpha ();
-    // stopping criterion (step size)
-    if (alpha < tol)
-    {
-        return (false); // done
-    }
-
+    double alpha;
 
-    // backtracking search
-    if (bs_type != SMPC_IP_BS_NONE)
     {
-        double bs_kappa = kappa;
-        if (bs_type == SMPC_IP_BS_ORIGINAL)
+        phase_timer search_timer (stats, SMPC_PHASE_LINE_SEARCH);
+
+        alpha = init_alpha ();
+        // stopping criterion (step size)
+        if (alpha < tol)
         {
-            bs_kappa = 0.0; // eliminates logarithmic barrier
+            return (false); // done
         }
-        const double bs_alpha_grad_dX = form_bs_alpha_obj_dX ();
-        for (;;)
+
+
+        // backtracking search
+        if (bs_type != SMPC_IP_BS_NONE)
         {
-            ++bs_counter;
-            if (form_phi_X_tmp (bs_kappa, alpha) <= phi_X + alpha * bs_alpha_grad_dX)
+            double bs_kappa = kappa;
+            if (bs_type == SMPC_IP_BS_ORIGINAL)
             {
-                break;
+                bs_kappa = 0.0; // eliminates logarithmic barrier
             }
-
-            alpha = bs_beta * alpha;
-
-            // stopping criterion (step size)
-            if (alpha < tol)
+            const double bs_alpha_grad_dX = form_bs_alpha_obj_dX ();
+            for (;;)
             {
-                return (false); // done
+                ++bs_counter;
+                trace_instant (trace, trace_id, SMPC_TRACE_IP_BS, bs_counter, alpha);
+                if (form_phi_X_tmp (bs_kappa, alpha) <= phi_X + alpha * bs_alpha_grad_dX)
+                {
+                    break;
+                }
+
+                alpha = bs_beta * alpha;
+
+                // stopping criterion (step size)
+                if (alpha < tol)
+                {
+                    return (false); // done
+                }
             }
         }
     }
@@ -583,6 +702,132 @@ bool qp_ip::solve_onestep (const double kappa, vector<double> &obj_log)
     {
         obj_log.push_back(compute_obj(true));
     }
+    inner_trace.set_value (alpha);
+
+    if (!report_iteration (kappa, alpha, decrement, obj_log))
+    {
+        stop_requested = true;
+        return (false);
+    }
+
+    return (true);
+}
+
+
+
+/**
+ * @brief Passes the state of the solver to the iteration callback.
+ *
+ * @param[in] kappa logarithmic barrier multiplier
+ * @param[in] alpha step length
+ * @param[in] decrement Newton decrement
+ * @param[in] obj_log a vector of objective function values
+ *
+ * @return false if the solver must stop.
+ */
+#ifdef SMPC_ITERATION_CALLBACK
+bool qp_ip::report_iteration (
+        const double kappa,
+        const double alpha,
+        const double decrement,
+        const vector<double> &obj_log) const
+{
+    if (callback != NULL)
+    {
+        smpc::iteration_record record;
+        record.iteration = int_loop_counter;
+        record.active_set_size = 0;
+        record.alpha = alpha;
+        record.objective = obj_computation_on ? obj_log.back() : compute_obj(true);
+        record.decrement = decrement;
+        record.kappa = kappa;
+
+        return (callback (record, callback_data));
+    }
+    return (true);
+}
+#else
+bool qp_ip::report_iteration (
+        const double,
+        const double,
+        const double,
+        const vector<double> &) const
+{
+    return (true);
+}
+#endif
+
+
+
+/**
+ * @brief Copies the state of the solver: parameters of the problem, 
+ * Cholesky factor, the solution, intermediate vectors and counters. 
+ * No memory is allocated.
+ *
+ * @param[in] from an instance of the class to copy the state from, 
+ *  it must have the same size of the preview window.
+ *
+ * @return false if the sizes of the preview windows differ, nothing is
+ * copied in this case.
+ *
+ * @note The solution is copied to the memory, which is currently used
+ * by this instance of the class (see #form_init_fp).
+ *
+ * @note The reference positions of ZMP and the bounds are copied to
+ * #parameters_copy, since the caller may reuse its arrays or destroy the
+ * instance @a from.
+ */
+bool qp_ip::copy_state (const qp_ip &from)
+{
+    if (N != from.N)
+    {
+        return (false);
+    }
+
+    h_initial = from.h_initial;
+    for (int i = 0; i < N; ++i)
+    {
+        spar[i] = from.spar[i];
+    }
+
+    if (from.zref_x == NULL)
+    {
+        lb = NULL;
+        ub = NULL;
+        zref_x = NULL;
+        zref_y = NULL;
+    }
+    else
+    {
+        // the arrays of a distinct instance never overlap with parameters_copy
+        if (from.zref_x != parameters_copy)
+        {
+            memcpy (parameters_copy, from.zref_x, sizeof(double) * N);
+            memcpy (parameters_copy + N, from.zref_y, sizeof(double) * N);
+            memcpy (parameters_copy + 2*N, from.lb, sizeof(double) * 2*N);
+            memcpy (parameters_copy + 4*N, from.ub, sizeof(double) * 2*N);
+        }
+        zref_x = parameters_copy;
+        zref_y = parameters_copy + N;
+        lb = parameters_copy + 2*N;
+        ub = parameters_copy + 4*N;
+    }
+
+    chol.copy_state (from.chol, N);
+
+    if ((X != NULL) && (from.X != NULL))
+    {
+        memcpy (X, from.X, sizeof(double) * N*SMPC_NUM_VAR);
+    }
+    memcpy (dX, from.dX, sizeof(double) * N*SMPC_NUM_VAR);
+    memcpy (g, from.g, sizeof(double) * 2*N);
+    memcpy (i2hess, from.i2hess, sizeof(double) * 2*N);
+    memcpy (i2hess_grad, from.i2hess_grad, sizeof(double) * N*SMPC_NUM_VAR);
+    memcpy (grad, from.grad, sizeof(double) * 2*N);
+
+    int_loop_counter = from.int_loop_counter;
+    ext_loop_counter = from.ext_loop_counter;
+    bs_counter = from.bs_counter;
 
     return (true);
 }
@@ -607,6 +852,8 @@ void qp_ip::form_init_fp (
         const bool tilde_state,
         double* X_)
 {
+    phase_timer timer (stats, SMPC_PHASE_FORM_INIT_FP);
+
     X = X_;
     form_init_fp_tilde<problem_parameters>(*this, x_coord, y_coord, init_state, tilde_state, X);
 
@@ -628,7 +875,7 @@ void qp_ip::form_init_fp (
  *
  * @return value of the objective function.
  */
-double qp_ip::compute_obj(const bool add_constant_term)
+double qp_ip::compute_obj(const bool add_constant_term) const
 {
     int i,j;
     double obj_pos = 0.0;
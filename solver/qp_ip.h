@@ -16,6 +16,7 @@
 #include "smpc_common.h"
 #include "ip_chol_solve.h"
 #include "ip_problem_param.h"
+#include "memory_arena.h"
 
 #include <vector>
 
@@ -34,10 +35,16 @@ using namespace smpc;
 /** 
  * @brief Solve a quadratic program with a specific structure. 
  * qp_ip = Quadratic Programming / Interior-point method
+ *
+ * @note All workspaces are allocated in a single #memory_arena, which is
+ * a base class, since it must be initialized before the other bases and 
+ * members.
  */
-class qp_ip : public IP::problem_parameters
+class qp_ip : protected memory_arena, public IP::problem_parameters
 {
     public:
+        friend class kernel_access;
+
 // functions        
         qp_ip(
                 const int N_, 
@@ -47,8 +54,12 @@ class qp_ip : public IP::problem_parameters
                 const double,
                 const double,
                 const bool,
-                const backtrackingSearchType);
-        ~qp_ip();
+                const backtrackingSearchType,
+                void *,
+                const size_t);
+
+        static size_t memory_footprint (const int);
+        static qp_ip * create_checkpoint (const qp_ip &);
 
         void set_parameters(
                 const double*, 
@@ -77,6 +88,8 @@ class qp_ip : public IP::problem_parameters
                 const double);
 
         void solve(vector<double> &);
+        bool copy_state (const qp_ip &);
+        double compute_obj(const bool) const;
 
         /** Variables for the QP (contain the states + control variables).
             Initial feasible point with respect to the equality and inequality 
@@ -87,6 +100,16 @@ class qp_ip : public IP::problem_parameters
         unsigned int int_loop_counter;
         unsigned int ext_loop_counter;
         unsigned int bs_counter;
+        /// Durations of the phases.
+        smpc::solve_stats stats;
+        /// The buffer of events, NULL if tracing is disabled.
+        smpc::trace_buffer *trace;
+        /// Identifier of the solver in the trace.
+        unsigned int trace_id;
+        /// The function called after each iteration, may be NULL.
+        smpc::iteration_callback callback;
+        /// The pointer passed to #callback.
+        void *callback_data;
 
 
     private:
@@ -141,6 +164,9 @@ class qp_ip : public IP::problem_parameters
         const double *zref_x;
         const double *zref_y;
 
+        /// Copies of #zref_x, #zref_y, #lb and #ub (6*#N), see #copy_state.
+        double *parameters_copy;
+
 
 // IP parameters
         double t; /// logarithmic barrier parameter
@@ -150,17 +176,22 @@ class qp_ip : public IP::problem_parameters
         unsigned int max_iter; /// maximum number of internal loop iterations (in total)
         double tol_out; /// tolerance of the outer loop
 
+        /// The iteration callback requested to stop the solver.
+        bool stop_requested;
+
 
 // functions        
+        qp_ip (const qp_ip &);
+        void init (const double, const bool, const backtrackingSearchType);
         double init_alpha();
         double form_bs_alpha_obj_dX ();
         double form_phi_X_tmp (const double, const double);
         bool solve_onestep (const double, vector<double> &);
+        bool report_iteration (const double, const double, const double, const vector<double> &) const;
         void form_g (const double *, const double *);
         double form_grad_i2hess_logbar (const double);
         double form_phi_X ();
         double form_decrement();
-        double compute_obj(const bool);
 };
 
 ///@}
@@ -40,9 +40,121 @@ namespace smpc
     }
 
 
+    bool phase_timers_enabled()
+    {
+#ifdef SMPC_PHASE_TIMERS
+        return (true);
+#else
+        return (false);
+#endif
+    }
+
+
+    bool tracing_enabled()
+    {
+#ifdef SMPC_TRACE
+        return (true);
+#else
+        return (false);
+#endif
+    }
+
+
+    bool iteration_callbacks_enabled()
+    {
+#ifdef SMPC_ITERATION_CALLBACK
+        return (true);
+#else
+        return (false);
+#endif
+    }
+
+
+    solver::solver()
+    {
+        recorder = NULL;
+        trace = NULL;
+        trace_id = 0;
+        callback = NULL;
+        callback_data = NULL;
+    }
+
+
     solver::~solver() {} // virtual destructor
 
 
+    void solver::set_recorder (problem_recorder *recorder_)
+    {
+        recorder = recorder_;
+    }
+
+
+    void solver::set_trace (trace_buffer *trace_, const unsigned int id)
+    {
+        trace = trace_;
+        trace_id = id;
+    }
+
+
+    void solver::set_iteration_callback (iteration_callback callback_, void *data_)
+    {
+        callback = callback_;
+        callback_data = data_;
+    }
+
+
+    //************************************************************
+
+
+    solve_stats::solve_stats()
+    {
+        reset();
+    }
+
+
+    void solve_stats::reset()
+    {
+        for (int i = 0; i < SMPC_PHASE_NUM; ++i)
+        {
+            time_ns[i] = 0.0;
+            calls[i] = 0;
+        }
+    }
+
+
+    const char *solve_stats::get_phase_name (const solverPhase phase)
+    {
+        switch (phase)
+        {
+            case SMPC_PHASE_SET_PARAMETERS:
+                return ("set_parameters");
+            case SMPC_PHASE_FORM_INIT_FP:
+                return ("form_init_fp");
+            case SMPC_PHASE_SOLVE:
+                return ("solve");
+            case SMPC_PHASE_ECL_FORM:
+                return ("ecL_form");
+            case SMPC_PHASE_INIT_SOLVE:
+                return ("init_solve");
+            case SMPC_PHASE_UP_RESOLVE:
+                return ("up_resolve");
+            case SMPC_PHASE_DOWN_RESOLVE:
+                return ("down_resolve");
+            case SMPC_PHASE_CHECK_CONSTRAINTS:
+                return ("check_constraints");
+            case SMPC_PHASE_NEWTON_STEP:
+                return ("newton_step");
+            case SMPC_PHASE_LINE_SEARCH:
+                return ("line_search");
+            default:
+                return ("unknown");
+        }
+    }
+
+
+    //************************************************************
+
+
     solver_as::solver_as (
                     const int N,
                     const double gain_position, 
@@ -52,14 +164,17 @@ namespace smpc
                     const double tol,
                     const unsigned int max_added_constraints_num,
                     const bool constraint_removal_on,
-                    const bool obj_computation_on)
+                    const bool obj_computation_on,
+                    void *memory_block,
+                    const size_t block_size)
     {
         qp_sol = new qp_as (
                 N, 
                 gain_position, gain_velocity, gain_acceleration, gain_jerk, 
                 tol, 
                 obj_computation_on,
-                max_added_constraints_num, constraint_removal_on);
+                max_added_constraints_num, constraint_removal_on,
+                memory_block, block_size);
         added_constraints_num = 0;
         removed_constraints_num = 0;
         active_set_size = 0;
@@ -75,6 +190,12 @@ namespace smpc
     }
 
 
+    size_t solver_as::memory_footprint (const int N)
+    {
+        return (qp_as::memory_footprint (N));
+    }
+
+
 
 
     void solver_as::set_parameters(
@@ -83,6 +204,10 @@ namespace smpc
             const double* zref_x, const double* zref_y,
             const double* lb, const double* ub)
     {
+        if (recorder != NULL)
+        {
+            recorder->record_parameters (T, h, h_initial, angle, zref_x, zref_y, lb, ub);
+        }
         if (qp_sol != NULL)
         {
             qp_sol->set_parameters(T, h, h_initial, angle, zref_x, zref_y, lb, ub);
@@ -96,6 +221,10 @@ namespace smpc
             const state_com &init_state,
             double* X)
     {
+        if (recorder != NULL)
+        {
+            recorder->record_init_fp (x_coord, y_coord, init_state.state_vector, false);
+        }
         if (qp_sol != NULL)
         {
             qp_sol->form_init_fp (x_coord, y_coord, init_state.state_vector, false, X);
@@ -109,6 +238,10 @@ namespace smpc
             const state_zmp &init_state,
             double* X)
     {
+        if (recorder != NULL)
+        {
+            recorder->record_init_fp (x_coord, y_coord, init_state.state_vector, true);
+        }
         if (qp_sol != NULL)
         {
             qp_sol->form_init_fp (x_coord, y_coord, init_state.state_vector, true, X);
@@ -120,11 +253,16 @@ namespace smpc
     {
         if (qp_sol != NULL)
         {
+            qp_sol->trace = trace;
+            qp_sol->trace_id = trace_id;
+            qp_sol->callback = callback;
+            qp_sol->callback_data = callback_data;
             qp_sol->solve (objective_log);
             
             added_constraints_num   = qp_sol->added_constraints_num;
             removed_constraints_num = qp_sol->removed_constraints_num;
             active_set_size         = qp_sol->active_set_size;
+            stats                   = qp_sol->stats;
         }
     }
 
@@ -214,6 +352,200 @@ namespace smpc
     }
 
 
+    void solver_as::get_trajectory (
+            double *x, double *vx, double *ax,
+            double *y, double *vy, double *ay,
+            double *jx, double *jy,
+            const bool tilde_form) const
+    {
+        if (qp_sol != NULL)
+        {
+            const int N = qp_sol->N;
+            const double *X = qp_sol->X;
+            const double *U = &X[N*SMPC_NUM_STATE_VAR];
+
+            for (int i = 0; i < N; ++i)
+            {
+                const double *s = &X[i*SMPC_NUM_STATE_VAR];
+                // see state_handling::tilde_to_orig
+                const double h = tilde_form ? 0.0 : qp_sol->spar[i].h;
+
+                x[i]  = s[0] + h * s[2];
+                vx[i] = s[1];
+                ax[i] = s[2];
+                y[i]  = s[3] + h * s[5];
+                vy[i] = s[4];
+                ay[i] = s[5];
+
+                jx[i] = U[i*SMPC_NUM_CONTROL_VAR];
+                jy[i] = U[i*SMPC_NUM_CONTROL_VAR + 1];
+            }
+        }
+    }
+
+
+    double solver_as::get_objective () const
+    {
+        if (qp_sol != NULL)
+        {
+            return (qp_sol->compute_obj (true));
+        }
+        return (0.0);
+    }
+
+
+    //************************************************************
+
+
+    bool solver_as::snapshot (checkpoint_as &chk) const
+    {
+        if ((qp_sol != NULL) && (chk.qp_state != NULL))
+        {
+            return (chk.qp_state->copy_state (*qp_sol));
+        }
+        return (false);
+    }
+
+
+    bool solver_as::restore (const checkpoint_as &chk)
+    {
+        if ((qp_sol != NULL) && (chk.qp_state != NULL))
+        {
+            if (!qp_sol->copy_state (*chk.qp_state))
+            {
+                return (false);
+            }
+
+            added_constraints_num   = qp_sol->added_constraints_num;
+            removed_constraints_num = qp_sol->removed_constraints_num;
+            active_set_size         = qp_sol->active_set_size;
+            return (true);
+        }
+        return (false);
+    }
+
+
+    checkpoint_as::checkpoint_as (const solver_as &solver)
+    {
+        qp_state = NULL;
+        X = NULL;
+        if (solver.qp_sol != NULL)
+        {
+            qp_state = qp_as::create_checkpoint (*solver.qp_sol);
+            X = new double[SMPC_NUM_VAR*qp_state->N]();
+
+            qp_state->X = X;
+        }
+    }
+
+
+    checkpoint_as::~checkpoint_as ()
+    {
+        if (qp_state != NULL)
+        {
+            delete qp_state;
+        }
+        if (X != NULL)
+        {
+            delete [] X;
+        }
+    }
+
+
+//************************************************************
+//************************************************************
+//************************************************************
+
+#ifndef __GNUC__
+#error "smpc::solver_pool requires the atomic builtins of GCC (__sync_*)."
+#endif
+
+    solver_pool::solver_pool (
+                    const unsigned int size_,
+                    const int N,
+                    const double gain_position, 
+                    const double gain_velocity, 
+                    const double gain_acceleration,
+                    const double gain_jerk, 
+                    const double tol,
+                    const unsigned int max_added_constraints_num,
+                    const bool constraint_removal_on,
+                    const bool obj_computation_on)
+    {
+        size = size_;
+
+        shared = new qp_as_shared (N, gain_position, gain_velocity, gain_acceleration, gain_jerk);
+
+        in_use = new int[size]();
+        solvers.resize(size);
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            solvers[i] = new solver_as (
+                    N, 
+                    gain_position, gain_velocity, gain_acceleration, gain_jerk,
+                    tol,
+                    max_added_constraints_num, constraint_removal_on,
+                    obj_computation_on);
+            solvers[i]->qp_sol->set_shared (shared);
+        }
+    }
+
+
+    solver_pool::~solver_pool()
+    {
+        for (unsigned int i = 0; i < solvers.size(); ++i)
+        {
+            if (solvers[i] != NULL)
+            {
+                delete solvers[i];
+            }
+        }
+        if (in_use != NULL)
+        {
+            delete [] in_use;
+        }
+        if (shared != NULL)
+        {
+            delete shared;
+        }
+    }
+
+
+    solver_as * solver_pool::checkout ()
+    {
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            if (__sync_bool_compare_and_swap (&in_use[i], 0, 1))
+            {
+                return (solvers[i]);
+            }
+        }
+        return (NULL);
+    }
+
+
+    void solver_pool::checkin (const solver_as *solver)
+    {
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            if (solvers[i] == solver)
+            {
+                __sync_lock_release (&in_use[i]);
+                break;
+            }
+        }
+    }
+
+
+    void solver_pool::set_shared_parameters (
+            const double* T, 
+            const double* h, 
+            const double h_initial)
+    {
+        shared->set_parameters (T, h, h_initial);
+    }
+
+
 //************************************************************
 //************************************************************
 //************************************************************
@@ -229,13 +561,16 @@ namespace smpc
                     const double bs_alpha, const double bs_beta,
                     const unsigned int max_iter,
                     const backtrackingSearchType bs_type,
-                    const bool obj_computation_on)
+                    const bool obj_computation_on,
+                    void *memory_block,
+                    const size_t block_size)
     {
         qp_sol = new qp_ip (
                 N, 
                 gain_position, gain_velocity, gain_acceleration, gain_jerk, 
                 tol, 
-                obj_computation_on, bs_type);
+                obj_computation_on, bs_type,
+                memory_block, block_size);
         qp_sol->set_ip_parameters (t, mu, bs_alpha, bs_beta, max_iter, tol_out);
 
         int_loop_iterations = 0;
@@ -253,12 +588,22 @@ namespace smpc
     }
 
 
+    size_t solver_ip::memory_footprint (const int N)
+    {
+        return (qp_ip::memory_footprint (N));
+    }
+
+
     void solver_ip::set_parameters(
             const double* T, const double* h, const double h_initial,
             const double* angle,
             const double* zref_x, const double* zref_y,
             const double* lb, const double* ub)
     {
+        if (recorder != NULL)
+        {
+            recorder->record_parameters (T, h, h_initial, angle, zref_x, zref_y, lb, ub);
+        }
         if (qp_sol != NULL)
         {
             qp_sol->set_parameters(T, h, h_initial, angle, zref_x, zref_y, lb, ub);
@@ -273,6 +618,10 @@ namespace smpc
             const state_com &init_state,
             double* X)
     {
+        if (recorder != NULL)
+        {
+            recorder->record_init_fp (x_coord, y_coord, init_state.state_vector, false);
+        }
         if (qp_sol != NULL)
         {
             qp_sol->form_init_fp (x_coord, y_coord, init_state.state_vector, false, X);
@@ -285,6 +634,10 @@ namespace smpc
             const state_zmp &init_state,
             double* X)
     {
+        if (recorder != NULL)
+        {
+            recorder->record_init_fp (x_coord, y_coord, init_state.state_vector, true);
+        }
         if (qp_sol != NULL)
         {
             qp_sol->form_init_fp (x_coord, y_coord, init_state.state_vector, true, X);
@@ -297,11 +650,16 @@ namespace smpc
     {
         if (qp_sol != NULL)
         {
+            qp_sol->trace = trace;
+            qp_sol->trace_id = trace_id;
+            qp_sol->callback = callback;
+            qp_sol->callback_data = callback_data;
             qp_sol->solve (objective_log);
 
             int_loop_iterations = qp_sol->int_loop_counter;
             ext_loop_iterations = qp_sol->ext_loop_counter;
             bt_search_iterations = qp_sol->bs_counter;
+            stats = qp_sol->stats;
         }
     }
 
@@ -399,6 +757,109 @@ namespace smpc
     }
 
 
+    void solver_ip::get_trajectory (
+            double *x, double *vx, double *ax,
+            double *y, double *vy, double *ay,
+            double *jx, double *jy,
+            const bool tilde_form) const
+    {
+        if (qp_sol != NULL)
+        {
+            const int N = qp_sol->N;
+            const double *X = qp_sol->X;
+            const double *U = &X[N*SMPC_NUM_STATE_VAR];
+
+            for (int i = 0; i < N; ++i)
+            {
+                const double *s = &X[i*SMPC_NUM_STATE_VAR];
+                const double cosA = qp_sol->spar[i].cos;
+                const double sinA = qp_sol->spar[i].sin;
+                // see state_handling::tilde_to_orig
+                const double h = tilde_form ? 0.0 : qp_sol->spar[i].h;
+
+                // see state_handling::bar_to_tilde
+                x[i]  = (cosA*s[0] - sinA*s[3]) + h * s[2];
+                vx[i] = s[1];
+                ax[i] = s[2];
+                y[i]  = (sinA*s[0] + cosA*s[3]) + h * s[5];
+                vy[i] = s[4];
+                ay[i] = s[5];
+
+                jx[i] = U[i*SMPC_NUM_CONTROL_VAR];
+                jy[i] = U[i*SMPC_NUM_CONTROL_VAR + 1];
+            }
+        }
+    }
+
+
+    double solver_ip::get_objective () const
+    {
+        if (qp_sol != NULL)
+        {
+            return (qp_sol->compute_obj (true));
+        }
+        return (0.0);
+    }
+
+
+    //************************************************************
+
+
+    bool solver_ip::snapshot (checkpoint_ip &chk) const
+    {
+        if ((qp_sol != NULL) && (chk.qp_state != NULL))
+        {
+            return (chk.qp_state->copy_state (*qp_sol));
+        }
+        return (false);
+    }
+
+
+    bool solver_ip::restore (const checkpoint_ip &chk)
+    {
+        if ((qp_sol != NULL) && (chk.qp_state != NULL))
+        {
+            if (!qp_sol->copy_state (*chk.qp_state))
+            {
+                return (false);
+            }
+
+            int_loop_iterations = qp_sol->int_loop_counter;
+            ext_loop_iterations = qp_sol->ext_loop_counter;
+            bt_search_iterations = qp_sol->bs_counter;
+            return (true);
+        }
+        return (false);
+    }
+
+
+    checkpoint_ip::checkpoint_ip (const solver_ip &solver)
+    {
+        qp_state = NULL;
+        X = NULL;
+        if (solver.qp_sol != NULL)
+        {
+            qp_state = qp_ip::create_checkpoint (*solver.qp_sol);
+            X = new double[SMPC_NUM_VAR*qp_state->N]();
+
+            qp_state->X = X;
+        }
+    }
+
+
+    checkpoint_ip::~checkpoint_ip ()
+    {
+        if (qp_state != NULL)
+        {
+            delete qp_state;
+        }
+        if (X != NULL)
+        {
+            delete [] X;
+        }
+    }
+
+
 //************************************************************
 //************************************************************
 //************************************************************
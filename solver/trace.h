@@ -0,0 +1,148 @@
+/**
+ * @file
+ * @author agent
+ */
+
+
+#ifndef TRACE_H
+#define TRACE_H
+
+/****************************************
+ * INCLUDES
+ ****************************************/
+
+#include "solver_config.h"
+#include "smpc_common.h"
+#include "phase_timer.h"
+
+
+/****************************************
+ * TYPEDEFS
+ ****************************************/
+
+/// @addtogroup gINTERNALS
+/// @{
+
+/**
+ * @brief Adds an event with the duration of a scope to smpc#trace_buffer:
+ * the event is added on destruction of an instance.
+ *
+ * @note If the library is built without SMPC_TRACE the class is empty and
+ * all calls are removed by the compiler.
+ */
+class trace_scope
+{
+    public:
+#ifdef SMPC_TRACE
+        /**
+         * @brief Starts the event.
+         *
+         * @param[in,out] trace_ the buffer, may be NULL.
+         * @param[in] solver_id identifier of the solver.
+         * @param[in] type type of the event.
+         * @param[in] index index, see smpc#traceEventType.
+         * @param[in] value value, see smpc#traceEventType.
+         */
+        trace_scope (
+                smpc::trace_buffer *trace_,
+                const unsigned int solver_id,
+                const smpc::traceEventType type,
+                const unsigned int index = 0,
+                const double value = 0.0) :
+            trace (trace_)
+        {
+            if (trace != NULL)
+            {
+                event.solver_id = solver_id;
+                event.type = type;
+                event.index = index;
+                event.value = value;
+                event.start_ns = get_monotonic_time_ns();
+            }
+        }
+
+        /**
+         * @brief Adds the event.
+         */
+        ~trace_scope ()
+        {
+            if (trace != NULL)
+            {
+                event.duration_ns = get_monotonic_time_ns() - event.start_ns;
+                trace->add (event);
+            }
+        }
+
+
+        /// Changes the index of the event.
+        void set_index (const unsigned int index)
+        {
+            event.index = index;
+        }
+
+        /// Changes the value of the event.
+        void set_value (const double value)
+        {
+            event.value = value;
+        }
+
+
+    private:
+        smpc::trace_buffer *trace;
+        smpc::trace_event event;
+#else
+        trace_scope (
+                smpc::trace_buffer *,
+                const unsigned int,
+                const smpc::traceEventType,
+                const unsigned int = 0,
+                const double = 0.0) {}
+
+        void set_index (const unsigned int) {}
+        void set_value (const double) {}
+#endif
+};
+
+
+/**
+ * @brief Adds an instant event to smpc#trace_buffer.
+ *
+ * @param[in,out] trace the buffer, may be NULL.
+ * @param[in] solver_id identifier of the solver.
+ * @param[in] type type of the event.
+ * @param[in] index index, see smpc#traceEventType.
+ * @param[in] value value, see smpc#traceEventType.
+ *
+ * @note If the library is built without SMPC_TRACE the function is empty.
+ */
+#ifdef SMPC_TRACE
+inline void trace_instant (
+        smpc::trace_buffer *trace,
+        const unsigned int solver_id,
+        const smpc::traceEventType type,
+        const unsigned int index,
+        const double value)
+{
+    if (trace != NULL)
+    {
+        smpc::trace_event event;
+        event.solver_id = solver_id;
+        event.type = type;
+        event.index = index;
+        event.value = value;
+        event.start_ns = get_monotonic_time_ns();
+        event.duration_ns = 0.0;
+        trace->add (event);
+    }
+}
+#else
+inline void trace_instant (
+        smpc::trace_buffer *,
+        const unsigned int,
+        const smpc::traceEventType,
+        const unsigned int,
+        const double) {}
+#endif
+
+///@}
+#endif /*TRACE_H*/
@@ -0,0 +1,147 @@
+/**
+ * @file
+ * @author agent
+ * @brief Implementation of smpc#trace_buffer.
+ */
+
+
+/****************************************
+ * INCLUDES
+ ****************************************/
+
+#include "smpc_solver.h"
+
+
+/****************************************
+ * FUNCTIONS
+ ****************************************/
+
+namespace smpc
+{
+    trace_buffer::trace_buffer (const unsigned int capacity_)
+    {
+        capacity = (capacity_ > 0) ? capacity_ : 1;
+        events = new trace_event[capacity];
+        num_added = 0;
+    }
+
+
+    trace_buffer::~trace_buffer ()
+    {
+        if (events != NULL)
+        {
+            delete [] events;
+        }
+    }
+
+
+    void trace_buffer::add (const trace_event &event)
+    {
+        // each writer gets its own slot
+#ifdef __GNUC__
+        const unsigned long slot = __sync_fetch_and_add (&num_added, 1);
+#else
+        const unsigned long slot = num_added++;
+#endif
+        events[slot % capacity] = event;
+    }
+
+
+    void trace_buffer::clear ()
+    {
+        num_added = 0;
+    }
+
+
+    unsigned int trace_buffer::size () const
+    {
+        return ((num_added < capacity) ? num_added : capacity);
+    }
+
+
+    const trace_event & trace_buffer::get (const unsigned int index) const
+    {
+        const unsigned long first = (num_added < capacity) ? 0 : num_added;
+        return (events[(first + index) % capacity]);
+    }
+
+
+    const char *trace_buffer::get_event_name (const traceEventType type)
+    {
+        switch (type)
+        {
+            case SMPC_TRACE_SOLVE:
+                return ("solve");
+            case SMPC_TRACE_ADD_CONSTRAINT:
+                return ("add_constraint");
+            case SMPC_TRACE_REMOVE_CONSTRAINT:
+                return ("remove_constraint");
+            case SMPC_TRACE_IP_OUTER:
+                return ("ip_outer");
+            case SMPC_TRACE_IP_INNER:
+                return ("ip_inner");
+            case SMPC_TRACE_IP_BS:
+                return ("ip_bs");
+            default:
+                return ("unknown");
+        }
+    }
+
+
+    bool trace_buffer::is_instant (const traceEventType type)
+    {
+        return ((type == SMPC_TRACE_ADD_CONSTRAINT)
+                || (type == SMPC_TRACE_REMOVE_CONSTRAINT)
+                || (type == SMPC_TRACE_IP_BS));
+    }
+
+
+    bool trace_buffer::write_chrome_json (const char *filename) const
+    {
+        FILE *out = fopen (filename, "w");
+        if (out == NULL)
+        {
+            fprintf (stderr, "Cannot open file (for writing): %s\n", filename);
+            return (false);
+        }
+
+        // names of the arguments: index, value
+        const char *arg_names[SMPC_TRACE_EVENT_NUM][2] = {
+            {"iterations", NULL},
+            {"constraint", "alpha"},
+            {"constraint", NULL},
+            {"iteration", "kappa"},
+            {"iteration", "alpha"},
+            {"iteration", "alpha"}};
+
+        fprintf (out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+        for (unsigned int i = 0; i < size(); ++i)
+        {
+            const trace_event &event = get(i);
+
+            // the time is in microseconds
+            fprintf (out, "{\"name\": \"%s\", \"cat\": \"smpc\", \"pid\": 0, \"tid\": %u, \"ts\": %.3f, ",
+                    get_event_name (event.type), event.solver_id, event.start_ns * 1e-3);
+            if (is_instant (event.type))
+            {
+                fprintf (out, "\"ph\": \"i\", \"s\": \"t\", ");
+            }
+            else
+            {
+                // the duration may be 0 due to the resolution of the clock
+                fprintf (out, "\"ph\": \"X\", \"dur\": %.3f, ", event.duration_ns * 1e-3);
+            }
+
+            fprintf (out, "\"args\": {\"%s\": %u", arg_names[event.type][0], event.index);
+            if (arg_names[event.type][1] != NULL)
+            {
+                fprintf (out, ", \"%s\": %.9g", arg_names[event.type][1], event.value);
+            }
+            fprintf (out, "}}%s\n", (i + 1 < size()) ? "," : "");
+        }
+        fprintf (out, "]}\n");
+
+        fclose (out);
+        return (true);
+    }
+}
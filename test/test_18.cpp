@@ -0,0 +1,135 @@
+/**
+ * @file
+ * @author agent
+ * @brief Compares the trajectory obtained using get_trajectory() with
+ *  the states and controls returned by get_state() and get_controls().
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/**
+ * @brief Returns the maximal difference between the output of get_trajectory()
+ * and the output of get_state() / get_controls().
+ *
+ * @param[in] solver a solver
+ * @param[in] N size of the preview window
+ */
+double compare_trajectory (const smpc::solver &solver, const unsigned int N)
+{
+    vector<double> traj(8*N);
+    double *x  = &traj[0];
+    double *vx = &traj[N];
+    double *ax = &traj[2*N];
+    double *y  = &traj[3*N];
+    double *vy = &traj[4*N];
+    double *ay = &traj[5*N];
+    double *jx = &traj[6*N];
+    double *jy = &traj[7*N];
+
+    double max_err = 0.0;
+
+    for (int form = 0; form < 2; ++form)
+    {
+        solver.get_trajectory (x, vx, ax, y, vy, ay, jx, jy, form == 1);
+
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            smpc::state_com state_com;
+            smpc::state_zmp state_zmp;
+            smpc::state *state;
+            smpc::control control;
+
+            if (form == 1)
+            {
+                solver.get_state (state_zmp, i);
+                state = &state_zmp;
+            }
+            else
+            {
+                solver.get_state (state_com, i);
+                state = &state_com;
+            }
+            solver.get_controls (control, i);
+
+            const double err[8] = {
+                x[i]  - state->x(),
+                vx[i] - state->vx(),
+                ax[i] - state->ax(),
+                y[i]  - state->y(),
+                vy[i] - state->vy(),
+                ay[i] - state->ay(),
+                jx[i] - control.jx(),
+                jy[i] - control.jy()};
+
+            for (int j = 0; j < 8; ++j)
+            {
+                if (fabs(err[j]) > max_err)
+                {
+                    max_err = fabs(err[j]);
+                }
+            }
+        }
+    }
+
+    return (max_err);
+}
+
+
+int main(int argc, char **argv)
+{
+    init_10 AS_test("");
+    init_10 IP_test("");
+
+    smpc::solver_as AS_solver (AS_test.wmg->N);
+    smpc::solver_ip IP_solver (IP_test.wmg->N);
+
+    double max_err = 0.0;
+
+    for(;;)
+    {
+        //------------------------------------------------------
+        if (AS_test.wmg->formPreviewWindow(*AS_test.par) == WMG_HALT)
+        {
+            break;
+        }
+        if (IP_test.wmg->formPreviewWindow(*IP_test.par) == WMG_HALT)
+        {
+            break;
+        }
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        AS_solver.set_parameters (AS_test.par->T, AS_test.par->h, AS_test.par->h0, AS_test.par->angle, AS_test.par->zref_x, AS_test.par->zref_y, AS_test.par->lb, AS_test.par->ub);
+        AS_solver.form_init_fp (AS_test.par->fp_x, AS_test.par->fp_y, AS_test.par->init_state, AS_test.par->X);
+        AS_solver.solve();
+        AS_solver.get_next_state(AS_test.par->init_state);
+
+        IP_solver.set_parameters (IP_test.par->T, IP_test.par->h, IP_test.par->h0, IP_test.par->angle, IP_test.par->zref_x, IP_test.par->zref_y, IP_test.par->lb, IP_test.par->ub);
+        IP_solver.form_init_fp (IP_test.par->fp_x, IP_test.par->fp_y, IP_test.par->init_state, IP_test.par->X);
+        IP_solver.solve();
+        IP_solver.get_next_state(IP_test.par->init_state);
+        //------------------------------------------------------
+
+
+        double err = compare_trajectory (AS_solver, AS_test.wmg->N);
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+        err = compare_trajectory (IP_solver, IP_test.wmg->N);
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+    }
+
+    cout << "Max. error (all states and controls, all preview windows): " << max_err << endl;
+
+    return ((max_err > 1e-12) ? 1 : 0);
+}
+///@}
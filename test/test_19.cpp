@@ -0,0 +1,251 @@
+/**
+ * @file
+ * @author agent
+ * @brief Saves the state of the solvers using snapshot(), solves a 
+ *  perturbed problem, overwrites the parameters of the problem, restores
+ *  the state and compares the solutions and the values of the objective
+ *  function. The state is also saved again after restoring and restored
+ *  from a checkpoint, which is destroyed before the objective is evaluated.
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/**
+ * @brief Returns the maximal difference between two vectors.
+ *
+ * @param[in] a first vector
+ * @param[in] b second vector
+ * @param[in] size size of the vectors
+ */
+double compare_vectors (const double *a, const double *b, const unsigned int size)
+{
+    double max_err = 0.0;
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        if (fabs(a[i] - b[i]) > max_err)
+        {
+            max_err = fabs(a[i] - b[i]);
+        }
+    }
+    return (max_err);
+}
+
+
+/**
+ * @brief Overwrites the reference positions of ZMP and the bounds, or
+ * restores them.
+ *
+ * @param[in,out] par parameters
+ * @param[in,out] saved saved parameters
+ * @param[in] save save the parameters and overwrite them if true, restore
+ *  otherwise.
+ */
+void overwrite_parameters (smpc_parameters &par, vector<double> &saved, const bool save)
+{
+    const unsigned int N = saved.size() / 6;
+    double *arrays[4] = {par.zref_x, par.zref_y, par.lb, par.ub};
+    const unsigned int sizes[4] = {N, N, 2*N, 2*N};
+
+    for (unsigned int i = 0, k = 0; i < 4; ++i)
+    {
+        for (unsigned int j = 0; j < sizes[i]; ++j, ++k)
+        {
+            if (save)
+            {
+                saved[k] = arrays[i][j];
+                arrays[i][j] += 1.0;
+            }
+            else
+            {
+                arrays[i][j] = saved[k];
+            }
+        }
+    }
+}
+
+
+int main(int argc, char **argv)
+{
+    init_10 AS_test("");
+    init_10 IP_test("");
+
+    const unsigned int N = AS_test.wmg->N;
+
+    smpc::solver_as AS_solver (N);
+    smpc::solver_ip IP_solver (N);
+    smpc::checkpoint_as AS_chk (AS_solver);
+    smpc::checkpoint_ip IP_chk (IP_solver);
+
+    // checkpoints of solvers with different size of the preview window
+    smpc::solver_as AS_other_solver (N + 1);
+    smpc::solver_ip IP_other_solver (N + 1);
+    smpc::checkpoint_as AS_other_chk (AS_other_solver);
+    smpc::checkpoint_ip IP_other_chk (IP_other_solver);
+
+    vector<double> AS_saved(6*N);
+    vector<double> IP_saved(6*N);
+
+    vector<double> AS_X(SMPC_NUM_VAR*N);
+    vector<double> IP_X(SMPC_NUM_VAR*N);
+    smpc::state_com perturbed_state;
+
+    double max_err = 0.0;
+    bool counters_ok = true;
+    bool return_ok = true;
+
+    for(;;)
+    {
+        //------------------------------------------------------
+        if (AS_test.wmg->formPreviewWindow(*AS_test.par) == WMG_HALT)
+        {
+            break;
+        }
+        if (IP_test.wmg->formPreviewWindow(*IP_test.par) == WMG_HALT)
+        {
+            break;
+        }
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        AS_solver.set_parameters (AS_test.par->T, AS_test.par->h, AS_test.par->h0, AS_test.par->angle, AS_test.par->zref_x, AS_test.par->zref_y, AS_test.par->lb, AS_test.par->ub);
+        AS_solver.form_init_fp (AS_test.par->fp_x, AS_test.par->fp_y, AS_test.par->init_state, AS_test.par->X);
+        AS_solver.solve();
+        return_ok = AS_solver.snapshot (AS_chk) && !AS_solver.snapshot (AS_other_chk) && return_ok;
+        const double AS_obj = AS_solver.get_objective();
+        copy (AS_test.par->X, AS_test.par->X + SMPC_NUM_VAR*N, AS_X.begin());
+        const int AS_added = AS_solver.added_constraints_num;
+        const int AS_active = AS_solver.active_set_size;
+
+        IP_solver.set_parameters (IP_test.par->T, IP_test.par->h, IP_test.par->h0, IP_test.par->angle, IP_test.par->zref_x, IP_test.par->zref_y, IP_test.par->lb, IP_test.par->ub);
+        IP_solver.form_init_fp (IP_test.par->fp_x, IP_test.par->fp_y, IP_test.par->init_state, IP_test.par->X);
+        IP_solver.solve();
+        return_ok = IP_solver.snapshot (IP_chk) && !IP_solver.snapshot (IP_other_chk) && return_ok;
+        const double IP_obj = IP_solver.get_objective();
+        copy (IP_test.par->X, IP_test.par->X + SMPC_NUM_VAR*N, IP_X.begin());
+        const int IP_ext = IP_solver.ext_loop_iterations;
+        const int IP_int = IP_solver.int_loop_iterations;
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        // solve a perturbed problem
+        perturbed_state = AS_test.par->init_state;
+        perturbed_state.x() += 0.005;
+        perturbed_state.y() -= 0.005;
+        AS_solver.form_init_fp (AS_test.par->fp_x, AS_test.par->fp_y, perturbed_state, AS_test.par->X);
+        AS_solver.solve();
+
+        perturbed_state = IP_test.par->init_state;
+        perturbed_state.x() += 0.005;
+        perturbed_state.y() -= 0.005;
+        IP_solver.form_init_fp (IP_test.par->fp_x, IP_test.par->fp_y, perturbed_state, IP_test.par->X);
+        IP_solver.solve();
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        // the caller may reuse the arrays after a snapshot
+        overwrite_parameters (*AS_test.par, AS_saved, true);
+        overwrite_parameters (*IP_test.par, IP_saved, true);
+
+        return_ok = !AS_solver.restore (AS_other_chk) && AS_solver.restore (AS_chk)
+            && !IP_solver.restore (IP_other_chk) && IP_solver.restore (IP_chk)
+            && return_ok;
+
+        // the objective depends on the reference positions of ZMP
+        double err = fabs(AS_obj - AS_solver.get_objective());
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+        err = fabs(IP_obj - IP_solver.get_objective());
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+
+        overwrite_parameters (*AS_test.par, AS_saved, false);
+        overwrite_parameters (*IP_test.par, IP_saved, false);
+
+        err = compare_vectors (AS_test.par->X, &AS_X[0], SMPC_NUM_VAR*N);
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+        err = compare_vectors (IP_test.par->X, &IP_X[0], SMPC_NUM_VAR*N);
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+
+        if ((AS_added != AS_solver.added_constraints_num) 
+                || (AS_active != AS_solver.active_set_size)
+                || (IP_ext != IP_solver.ext_loop_iterations)
+                || (IP_int != IP_solver.int_loop_iterations))
+        {
+            counters_ok = false;
+        }
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        // snapshot after restore, then restore from a temporary checkpoint
+        smpc::checkpoint_as *AS_tmp_chk = new smpc::checkpoint_as (AS_solver);
+        smpc::checkpoint_ip *IP_tmp_chk = new smpc::checkpoint_ip (IP_solver);
+
+        return_ok = AS_solver.snapshot (AS_chk) && AS_solver.snapshot (*AS_tmp_chk)
+            && IP_solver.snapshot (IP_chk) && IP_solver.snapshot (*IP_tmp_chk)
+            && return_ok;
+
+        AS_solver.form_init_fp (AS_test.par->fp_x, AS_test.par->fp_y, perturbed_state, AS_test.par->X);
+        AS_solver.solve();
+        IP_solver.form_init_fp (IP_test.par->fp_x, IP_test.par->fp_y, perturbed_state, IP_test.par->X);
+        IP_solver.solve();
+
+        return_ok = AS_solver.restore (*AS_tmp_chk) && IP_solver.restore (*IP_tmp_chk) && return_ok;
+        delete AS_tmp_chk;
+        delete IP_tmp_chk;
+
+        err = fabs(AS_obj - AS_solver.get_objective());
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+        err = fabs(IP_obj - IP_solver.get_objective());
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+
+        // the checkpoint, which was overwritten after restore
+        return_ok = AS_solver.restore (AS_chk) && IP_solver.restore (IP_chk) && return_ok;
+
+        err = compare_vectors (AS_test.par->X, &AS_X[0], SMPC_NUM_VAR*N);
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+        err = compare_vectors (IP_test.par->X, &IP_X[0], SMPC_NUM_VAR*N);
+        if (err > max_err)
+        {
+            max_err = err;
+        }
+        //------------------------------------------------------
+
+
+        AS_solver.get_next_state(AS_test.par->init_state);
+        IP_solver.get_next_state(IP_test.par->init_state);
+    }
+
+    cout << "Max. error (restored solutions, all preview windows): " << max_err << endl;
+    cout << "Counters restored: " << (counters_ok ? "yes" : "no") << endl;
+    cout << "Return values: " << (return_ok ? "ok" : "wrong") << endl;
+
+    return (((max_err > 0.0) || !counters_ok || !return_ok) ? 1 : 0);
+}
+///@}
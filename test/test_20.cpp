@@ -0,0 +1,127 @@
+/**
+ * @file
+ * @author agent
+ * @brief Evaluates candidate positions of the next SS using 
+ *  WMG::evaluateNextSSCandidates(), selects the best candidate and compares 
+ *  the result with the solution obtained after changeNextSSPosition().
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+int main(int argc, char **argv)
+{
+    init_10 test_10("");
+    const unsigned int N = test_10.wmg->N;
+
+
+    // candidates: positions of all single supports in the plan
+    vector<double> x_coord;
+    vector<double> y_coord;
+    vector<double> angle_rot;
+    test_10.wmg->getFootsteps(x_coord, y_coord, angle_rot);
+
+    const unsigned int num = x_coord.size();
+    vector<double> postures(num*16, 0.0);
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        double *posture = &postures[i*16];
+        // column-major 4x4 homogeneous matrix
+        posture[0] = cos(angle_rot[i]);
+        posture[1] = sin(angle_rot[i]);
+        posture[4] = -sin(angle_rot[i]);
+        posture[5] = cos(angle_rot[i]);
+        posture[10] = 1.0;
+        posture[12] = x_coord[i];
+        posture[13] = y_coord[i];
+        posture[15] = 1.0;
+    }
+
+
+    nextSSCandidates candidates (num, N, test_10.par->hCoM);
+    vector<smpc::solver *> solvers (num);
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        solvers[i] = new smpc::solver_as (N);
+    }
+    smpc::solver_as solver (N);
+
+
+    double max_err = 0.0;
+    unsigned int evaluated = 0;
+    for(;;)
+    {
+        if (test_10.wmg->evaluateNextSSCandidates (
+                    candidates, &solvers[0], &postures[0], true, test_10.par->init_state) == WMG_HALT)
+        {
+            for (unsigned int i = 0; i < num; ++i)
+            {
+                if (candidates.objective[i] < HUGE_VAL)
+                {
+                    cout << "A candidate is not marked as invalid at the end of simulation." << endl;
+                    return (1);
+                }
+            }
+            break;
+        }
+
+        unsigned int best = 0;
+        for (unsigned int i = 1; i < num; ++i)
+        {
+            if (candidates.objective[i] < candidates.objective[best])
+            {
+                best = i;
+            }
+        }
+        test_10.wmg->changeNextSSPosition (&postures[best*16], true);
+        ++evaluated;
+
+
+        //------------------------------------------------------
+        if (test_10.wmg->formPreviewWindow(*test_10.par) == WMG_HALT)
+        {
+            cout << "Evaluation of candidates did not detect the end of simulation." << endl;
+            return (1);
+        }
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        solver.set_parameters (test_10.par->T, test_10.par->h, test_10.par->h0, test_10.par->angle, test_10.par->zref_x, test_10.par->zref_y, test_10.par->lb, test_10.par->ub);
+        solver.form_init_fp (test_10.par->fp_x, test_10.par->fp_y, test_10.par->init_state, test_10.par->X);
+        solver.solve();
+        solver.get_next_state(test_10.par->init_state);
+        //------------------------------------------------------
+
+
+        smpc::control control;
+        solver.get_first_controls (control);
+
+        const double err[3] = {
+            control.jx() - candidates.first_controls[best].jx(),
+            control.jy() - candidates.first_controls[best].jy(),
+            solver.get_objective() - candidates.objective[best]};
+        for (int j = 0; j < 3; ++j)
+        {
+            if (fabs(err[j]) > max_err)
+            {
+                max_err = fabs(err[j]);
+            }
+        }
+    }
+
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        delete solvers[i];
+    }
+
+    cout << "Number of candidates: " << num << endl;
+    cout << "Evaluated preview windows: " << evaluated << endl;
+    cout << "Max. error (first controls and objective): " << max_err << endl;
+
+    return ((max_err > 0.0) ? 1 : 0);
+}
+///@}
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @author agent
+ * @brief Compares the solutions obtained by the solvers, which use their own
+ *  memory, with the solutions obtained by the solvers, which use memory 
+ *  provided by the caller. Also checks, that memory_footprint() is sufficient
+ *  for all alignments of the memory block (the solvers abort otherwise).
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+int main(int argc, char **argv)
+{
+    init_10 test_own("");
+    init_10 test_ext("");
+    const unsigned int N = test_own.wmg->N;
+
+    cout << "Memory footprint (AS): " << smpc::solver_as::memory_footprint(N) << " bytes" << endl;
+    cout << "Memory footprint (IP): " << smpc::solver_ip::memory_footprint(N) << " bytes" << endl;
+
+    const size_t AS_size = smpc::solver_as::memory_footprint(N);
+    const size_t IP_size = smpc::solver_ip::memory_footprint(N);
+
+    // all shifts within a cache line
+    for (size_t shift = 0; shift < 64; ++shift)
+    {
+        vector<char> memory (AS_size + IP_size + 64);
+        smpc::solver_as AS_shifted (N, 2000.0, 150.0, 0.02, 1.0, 1e-7, 0, true, false,
+                &memory[shift], AS_size);
+        smpc::solver_ip IP_shifted (N, 2000.0, 150.0, 0.01, 1.0, 1e-3, 1e-2, 100, 15, 0.01, 0.5, 0,
+                smpc::SMPC_IP_BS_LOGBAR, false, &memory[shift + AS_size], IP_size);
+    }
+
+    // not aligned on purpose
+    vector<char> AS_memory (AS_size + 1);
+    vector<char> IP_memory (IP_size + 1);
+
+
+    smpc::solver_as AS_own (N);
+    smpc::solver_ip IP_own (N);
+    smpc::solver_as AS_ext (N, 2000.0, 150.0, 0.02, 1.0, 1e-7, 0, true, false, &AS_memory[1], AS_size);
+    smpc::solver_ip IP_ext (N, 2000.0, 150.0, 0.01, 1.0, 1e-3, 1e-2, 100, 15, 0.01, 0.5, 0, 
+            smpc::SMPC_IP_BS_LOGBAR, false, &IP_memory[1], IP_size);
+
+    smpc::solver *solvers_own[2] = {&AS_own, &IP_own};
+    smpc::solver *solvers_ext[2] = {&AS_ext, &IP_ext};
+    smpc::state_com init_state_own[2];
+    smpc::state_com init_state_ext[2];
+    vector<double> X_own(SMPC_NUM_VAR*N);
+    vector<double> X_ext(SMPC_NUM_VAR*N);
+
+
+    double max_err = 0.0;
+    for(;;)
+    {
+        //------------------------------------------------------
+        if (test_own.wmg->formPreviewWindow(*test_own.par) == WMG_HALT)
+        {
+            break;
+        }
+        if (test_ext.wmg->formPreviewWindow(*test_ext.par) == WMG_HALT)
+        {
+            break;
+        }
+        //------------------------------------------------------
+
+
+        for (int i = 0; i < 2; ++i)
+        {
+            smpc_parameters *par = test_own.par;
+            solvers_own[i]->set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+            solvers_own[i]->form_init_fp (par->fp_x, par->fp_y, init_state_own[i], &X_own[0]);
+            solvers_own[i]->solve();
+            solvers_own[i]->get_next_state(init_state_own[i]);
+
+            par = test_ext.par;
+            solvers_ext[i]->set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+            solvers_ext[i]->form_init_fp (par->fp_x, par->fp_y, init_state_ext[i], &X_ext[0]);
+            solvers_ext[i]->solve();
+            solvers_ext[i]->get_next_state(init_state_ext[i]);
+
+            for (unsigned int j = 0; j < SMPC_NUM_VAR*N; ++j)
+            {
+                if (fabs(X_own[j] - X_ext[j]) > max_err)
+                {
+                    max_err = fabs(X_own[j] - X_ext[j]);
+                }
+            }
+        }
+    }
+
+    cout << "Max. error (all solutions): " << max_err << endl;
+
+    return ((max_err > 0.0) ? 1 : 0);
+}
+///@}
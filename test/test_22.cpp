@@ -0,0 +1,196 @@
+/**
+ * @file
+ * @author agent
+ * @brief Checks out solvers from a solver pool and compares their solutions
+ *  with the solutions of a standalone solver. The same problems are then
+ *  solved by pooled solvers sharing the Cholesky factor from several threads
+ *  (if OpenMP is enabled), the solutions must be bitwise identical.
+ */
+
+
+#include <cstring> // memcmp
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/**
+ * @brief A problem and its solution obtained with a standalone solver.
+ */
+class pool_problem
+{
+    public:
+        /**
+         * @brief Copies the problem.
+         *
+         * @param[in] par parameters
+         * @param[in] N Number of sampling times in a preview window
+         */
+        pool_problem (const smpc_parameters &par, const unsigned int N)
+        {
+            T.assign (par.T, par.T + N);
+            h.assign (par.h, par.h + N);
+            angle.assign (par.angle, par.angle + N);
+            zref_x.assign (par.zref_x, par.zref_x + N);
+            zref_y.assign (par.zref_y, par.zref_y + N);
+            lb.assign (par.lb, par.lb + 2*N);
+            ub.assign (par.ub, par.ub + 2*N);
+            fp_x.assign (par.fp_x, par.fp_x + N);
+            fp_y.assign (par.fp_y, par.fp_y + N);
+            h0 = par.h0;
+            init_state = par.init_state;
+        }
+
+        /**
+         * @brief Solves the problem.
+         *
+         * @param[in,out] solver a solver
+         * @param[out] X the solution
+         */
+        void solve (smpc::solver_as &solver, double *X) const
+        {
+            solver.set_parameters (&T[0], &h[0], h0, &angle[0], &zref_x[0], &zref_y[0], &lb[0], &ub[0]);
+            solver.form_init_fp (&fp_x[0], &fp_y[0], init_state, X);
+            solver.solve();
+        }
+
+        vector<double> T;
+        vector<double> h;
+        vector<double> angle;
+        vector<double> zref_x;
+        vector<double> zref_y;
+        vector<double> lb;
+        vector<double> ub;
+        vector<double> fp_x;
+        vector<double> fp_y;
+        double h0;
+        smpc::state_com init_state;
+
+        /// The solution of the standalone solver.
+        vector<double> X;
+};
+
+
+int main(int argc, char **argv)
+{
+    init_10 test_10("");
+    const unsigned int N = test_10.wmg->N;
+    const unsigned int pool_size = 3;
+
+    smpc::solver_pool pool (pool_size, N);
+    smpc::solver_as solver (N);
+
+
+    // all solvers can be checked out, but not more
+    vector<smpc::solver_as *> checked_out;
+    for (unsigned int i = 0; i < pool_size; ++i)
+    {
+        checked_out.push_back(pool.checkout());
+        if (checked_out.back() == NULL)
+        {
+            cout << "Failed to check out a solver." << endl;
+            return (1);
+        }
+    }
+    if (pool.checkout() != NULL)
+    {
+        cout << "Checked out more solvers than available." << endl;
+        return (1);
+    }
+    for (unsigned int i = 0; i < pool_size; ++i)
+    {
+        pool.checkin(checked_out[i]);
+    }
+
+
+    vector<double> X(SMPC_NUM_VAR*N);
+    smpc::state_com init_state;
+    vector<pool_problem> problems;
+
+    double max_err = 0.0;
+    for(int counter = 0; ; ++counter)
+    {
+        //------------------------------------------------------
+        if (test_10.wmg->formPreviewWindow(*test_10.par) == WMG_HALT)
+        {
+            break;
+        }
+        //------------------------------------------------------
+
+        smpc_parameters *par = test_10.par;
+        problems.push_back (pool_problem (*par, N));
+
+        // the shared factor is updated only sometimes, the solvers must
+        // detect that it cannot be used.
+        if (counter % 10 == 0)
+        {
+            pool.set_shared_parameters (par->T, par->h, par->h0);
+        }
+
+        //------------------------------------------------------
+        solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        solver.solve();
+        problems.back().X.assign (par->X, par->X + SMPC_NUM_VAR*N);
+
+        smpc::solver_as *pooled_solver = pool.checkout();
+        pooled_solver->set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        pooled_solver->form_init_fp (par->fp_x, par->fp_y, par->init_state, &X[0]);
+        pooled_solver->solve();
+        pool.checkin(pooled_solver);
+
+        solver.get_next_state(par->init_state);
+        //------------------------------------------------------
+
+
+        for (unsigned int j = 0; j < SMPC_NUM_VAR*N; ++j)
+        {
+            if (fabs(par->X[j] - X[j]) > max_err)
+            {
+                max_err = fabs(par->X[j] - X[j]);
+            }
+        }
+    }
+
+    cout << "Max. error (all solutions): " << max_err << endl;
+
+
+    //------------------------------------------------------
+    // concurrent solution, the factor is formed once
+    //------------------------------------------------------
+    if (problems.empty())
+    {
+        return (1);
+    }
+    pool.set_shared_parameters (&problems[0].T[0], &problems[0].h[0], problems[0].h0);
+
+    vector<double> solutions (problems.size() * SMPC_NUM_VAR*N);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int i = 0; i < (int) problems.size(); ++i)
+    {
+        // there may be more threads than solvers
+        smpc::solver_as *pooled_solver = NULL;
+        while (pooled_solver == NULL)
+        {
+            pooled_solver = pool.checkout();
+        }
+        problems[i].solve (*pooled_solver, &solutions[i * SMPC_NUM_VAR*N]);
+        pool.checkin(pooled_solver);
+    }
+
+    unsigned int num_diff = 0;
+    for (unsigned int i = 0; i < problems.size(); ++i)
+    {
+        if (memcmp (&solutions[i * SMPC_NUM_VAR*N], &problems[i].X[0], SMPC_NUM_VAR*N * sizeof(double)) != 0)
+        {
+            ++num_diff;
+        }
+    }
+    cout << "Differing solutions (concurrent): " << num_diff << " of " << problems.size() << endl;
+
+    return (((max_err > 0.0) || (num_diff > 0)) ? 1 : 0);
+}
+///@}
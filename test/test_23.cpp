@@ -0,0 +1,101 @@
+/**
+ * @file
+ * @author agent
+ * @brief Compares the preview windows and solutions obtained with the
+ *  incremental and full forming of the preview windows.
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/**
+ * @brief Counts the elements, which differ in two arrays.
+ *
+ * @param[in] a the first array
+ * @param[in] b the second array
+ * @param[in] size size of the arrays
+ */
+unsigned int count_diff (const double *a, const double *b, const unsigned int size)
+{
+    unsigned int num = 0;
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        if ((a[i] < b[i]) || (a[i] > b[i]))
+        {
+            ++num;
+        }
+    }
+    return (num);
+}
+
+
+int main(int argc, char **argv)
+{
+    init_10 full_test("");
+    init_10 incr_test("");
+
+    incr_test.wmg->incremental_preview_window = true;
+
+    const unsigned int N = full_test.wmg->N;
+    smpc::solver_as full_solver (N);
+    smpc::solver_as incr_solver (N);
+
+    unsigned int num_diff = 0;
+    unsigned int num_windows = 0;
+
+    for(;;)
+    {
+        //------------------------------------------------------
+        WMGret full_ret = full_test.wmg->formPreviewWindow(*full_test.par);
+        WMGret incr_ret = incr_test.wmg->formPreviewWindow(*incr_test.par);
+        if (full_ret != incr_ret)
+        {
+            ++num_diff;
+        }
+        if ((full_ret == WMG_HALT) || (incr_ret == WMG_HALT))
+        {
+            break;
+        }
+        ++num_windows;
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        smpc_parameters *p = full_test.par;
+        smpc_parameters *q = incr_test.par;
+
+        num_diff += count_diff (p->T, q->T, N);
+        num_diff += count_diff (p->angle, q->angle, N);
+        num_diff += count_diff (p->fp_x, q->fp_x, N);
+        num_diff += count_diff (p->fp_y, q->fp_y, N);
+        num_diff += count_diff (p->zref_x, q->zref_x, N);
+        num_diff += count_diff (p->zref_y, q->zref_y, N);
+        num_diff += count_diff (p->lb, q->lb, 2*N);
+        num_diff += count_diff (p->ub, q->ub, 2*N);
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        full_solver.set_parameters (p->T, p->h, p->h0, p->angle, p->zref_x, p->zref_y, p->lb, p->ub);
+        full_solver.form_init_fp (p->fp_x, p->fp_y, p->init_state, p->X);
+        full_solver.solve();
+        full_solver.get_next_state(p->init_state);
+
+        incr_solver.set_parameters (q->T, q->h, q->h0, q->angle, q->zref_x, q->zref_y, q->lb, q->ub);
+        incr_solver.form_init_fp (q->fp_x, q->fp_y, q->init_state, q->X);
+        incr_solver.solve();
+        incr_solver.get_next_state(q->init_state);
+
+        num_diff += count_diff (p->X, q->X, SMPC_NUM_VAR*N);
+        //------------------------------------------------------
+    }
+
+    cout << "Preview windows: " << num_windows << endl;
+    cout << "Number of differences: " << num_diff << endl;
+
+    return (((num_diff == 0) && (num_windows > 0)) ? 0 : 1);
+}
+///@}
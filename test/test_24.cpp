@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @author agent
+ * @brief Compares the positions of feet obtained using the batch, cursor
+ *  and single shift versions of WMG::getFeetPositions().
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+int main(int argc, char **argv)
+{
+    init_10 test_24("");
+
+    const unsigned int num = 41;
+    const unsigned int shift_step_ms = 10;
+
+    vector<unsigned int> shift(num);
+    vector<unsigned int> shift_reversed(num);
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        shift[i] = i * shift_step_ms;
+        shift_reversed[num - 1 - i] = shift[i];
+    }
+
+    double max_err = 0.0;
+    feetCursor cursor;
+
+    for(;;)
+    {
+        //------------------------------------------------------
+        if (test_24.wmg->formPreviewWindow(*test_24.par) == WMG_HALT)
+        {
+            break;
+        }
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        vector<double> left(num*16, 0.0);
+        vector<double> right(num*16, 0.0);
+        vector<double> left_batch(num*16, 0.0);
+        vector<double> right_batch(num*16, 0.0);
+        vector<double> left_reversed(num*16, 0.0);
+        vector<double> right_reversed(num*16, 0.0);
+        vector<double> left_compact(num*4, 0.0);
+        vector<double> right_compact(num*4, 0.0);
+        vector<double> left_cursor(num*16, 0.0);
+        vector<double> right_cursor(num*16, 0.0);
+
+        for (unsigned int i = 0; i < num; ++i)
+        {
+            test_24.wmg->getFeetPositions (shift[i], &left[i*16], &right[i*16]);
+        }
+        test_24.wmg->getFeetPositions (num, &shift[0], &left_batch[0], &right_batch[0]);
+        test_24.wmg->getFeetPositions (num, &shift_reversed[0], &left_reversed[0], &right_reversed[0]);
+        test_24.wmg->getFeetPositions (num, &shift[0], &left_compact[0], &right_compact[0], true);
+        for (unsigned int i = 0; i < num; ++i)
+        {
+            test_24.wmg->getFeetPositions (cursor, shift[i], &left_cursor[i*16], &right_cursor[i*16]);
+        }
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        // the last shift lies beyond the last footstep
+        const bool skip_reversed = (left[(num-1)*16 + 15] == 0.0);
+
+        for (unsigned int i = 0; i < num; ++i)
+        {
+            const unsigned int ri = num - 1 - i;
+
+            for (int j = 0; j < 16; ++j)
+            {
+                double err[6] = {
+                    left[i*16 + j] - left_batch[i*16 + j],
+                    right[i*16 + j] - right_batch[i*16 + j],
+                    skip_reversed ? 0.0 : left[i*16 + j] - left_reversed[ri*16 + j],
+                    skip_reversed ? 0.0 : right[i*16 + j] - right_reversed[ri*16 + j],
+                    left[i*16 + j] - left_cursor[i*16 + j],
+                    right[i*16 + j] - right_cursor[i*16 + j]};
+
+                for (int k = 0; k < 6; ++k)
+                {
+                    if (fabs(err[k]) > max_err)
+                    {
+                        max_err = fabs(err[k]);
+                    }
+                }
+            }
+
+            const double *m[2] = {&left[i*16], &right[i*16]};
+            const double *c[2] = {&left_compact[i*4], &right_compact[i*4]};
+            for (int k = 0; k < 2; ++k)
+            {
+                double err[5] = {
+                    m[k][12] - c[k][0],
+                    m[k][13] - c[k][1],
+                    m[k][14] - c[k][2],
+                    m[k][0] - cos(c[k][3]),
+                    m[k][1] - sin(c[k][3])};
+
+                for (int j = 0; j < 5; ++j)
+                {
+                    if (fabs(err[j]) > max_err)
+                    {
+                        max_err = fabs(err[j]);
+                    }
+                }
+            }
+        }
+        //------------------------------------------------------
+    }
+
+    cout << "Max. error (batch and cursor vs single shift): " << max_err << endl;
+
+    return ((max_err > 1e-12) ? 1 : 0);
+}
+///@}
@@ -0,0 +1,170 @@
+/**
+ * @file
+ * @author agent
+ * @brief Compares the preview windows and positions of feet obtained with
+ *  and without streaming of footsteps through a queue.
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/**
+ * @brief Builds a request for a footstep.
+ */
+footstepQueue::request make_request (
+        const double x_relative,
+        const double y_relative,
+        const fs_type type,
+        const unsigned int def_time_ms,
+        const unsigned int ds_time_ms,
+        const unsigned int ds_number)
+{
+    footstepQueue::request req;
+
+    req.x_relative = x_relative;
+    req.y_relative = y_relative;
+    req.angle_relative = 0.0;
+    req.type = type;
+    req.def_time_ms = def_time_ms;
+    req.ds_time_ms = ds_time_ms;
+    req.ds_number = ds_number;
+    req.use_user_constraints = false;
+
+    return (req);
+}
+
+
+/**
+ * @brief Returns true if the numbers differ.
+ */
+bool differ (const double a, const double b)
+{
+    return ((a < b) || (a > b));
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int N = 40;
+    const unsigned int preview_sampling_time_ms = 40;
+    const unsigned int num_steps = 200;
+
+    WMG full_wmg (N, preview_sampling_time_ms, 0.02);
+    WMG stream_wmg (N, preview_sampling_time_ms, 0.02);
+    smpc_parameters full_par (N, 0.252007);
+    smpc_parameters stream_par (N, 0.252007);
+
+
+    // the walk, the first two footsteps are added directly
+    const double step_x = 0.04;
+    const double step_y = full_wmg.def_constraints.support_distance_y;
+    vector<footstepQueue::request> plan;
+
+    plan.push_back (make_request (0.0, -step_y/2, FS_TYPE_SS_R, 0, 0, 0));
+    plan.push_back (make_request (0.0, step_y/2, FS_TYPE_DS, 1200, 0, 0));
+    plan.push_back (make_request (0.0, step_y/2, FS_TYPE_AUTO, 400, 0, 0));
+    for (unsigned int i = 0; i < num_steps; ++i)
+    {
+        plan.push_back (make_request (step_x, (i % 2 == 0) ? -step_y : step_y, FS_TYPE_AUTO, 400, 40, 3));
+    }
+    plan.push_back (make_request (0.0, step_y/2, FS_TYPE_DS, 2000, 0, 0));
+    plan.push_back (make_request (0.0, step_y/2, FS_TYPE_SS_L, 0, 0, 0));
+
+    for (unsigned int i = 0; i < plan.size(); ++i)
+    {
+        full_wmg.setFootstepParametersMS (plan[i].def_time_ms, plan[i].ds_time_ms, plan[i].ds_number);
+        full_wmg.addFootstep (plan[i].x_relative, plan[i].y_relative, plan[i].angle_relative, plan[i].type);
+    }
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        stream_wmg.setFootstepParametersMS (plan[i].def_time_ms, plan[i].ds_time_ms, plan[i].ds_number);
+        stream_wmg.addFootstep (plan[i].x_relative, plan[i].y_relative, plan[i].angle_relative, plan[i].type);
+    }
+
+    footstepQueue queue(4);
+    stream_wmg.footstep_queue = &queue;
+    unsigned int next_request = 2;
+
+
+    unsigned int num_diff = 0;
+    unsigned int num_windows = 0;
+    unsigned int max_stream_fs = 0;
+
+    for(;;)
+    {
+        // producer
+        while ((next_request < plan.size()) && queue.push (plan[next_request]))
+        {
+            ++next_request;
+        }
+
+
+        //------------------------------------------------------
+        WMGret full_ret = full_wmg.formPreviewWindow(full_par);
+        WMGret stream_ret = stream_wmg.formPreviewWindow(stream_par);
+        if (full_ret != stream_ret)
+        {
+            ++num_diff;
+        }
+        if ((full_ret == WMG_HALT) || (stream_ret == WMG_HALT))
+        {
+            break;
+        }
+        ++num_windows;
+
+        if (stream_wmg.getNumFootsteps() > max_stream_fs)
+        {
+            max_stream_fs = stream_wmg.getNumFootsteps();
+        }
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            if (differ (full_par.T[i], stream_par.T[i])
+                    || differ (full_par.fp_x[i], stream_par.fp_x[i])
+                    || differ (full_par.fp_y[i], stream_par.fp_y[i])
+                    || differ (full_par.zref_x[i], stream_par.zref_x[i])
+                    || differ (full_par.zref_y[i], stream_par.zref_y[i])
+                    || differ (full_par.lb[2*i], stream_par.lb[2*i])
+                    || differ (full_par.ub[2*i + 1], stream_par.ub[2*i + 1]))
+            {
+                ++num_diff;
+            }
+        }
+
+        // the positions of feet are undefined in the last supports
+        if (next_request < plan.size())
+        {
+            double full_left[16], full_right[16];
+            double stream_left[16], stream_right[16];
+            full_wmg.getFeetPositions (preview_sampling_time_ms, full_left, full_right);
+            stream_wmg.getFeetPositions (preview_sampling_time_ms, stream_left, stream_right);
+            for (int i = 0; i < 16; ++i)
+            {
+                if (differ (full_left[i], stream_left[i]) || differ (full_right[i], stream_right[i]))
+                {
+                    ++num_diff;
+                }
+            }
+        }
+
+        if (full_wmg.isSupportSwitchNeeded() != stream_wmg.isSupportSwitchNeeded())
+        {
+            ++num_diff;
+        }
+        //------------------------------------------------------
+    }
+
+    cout << "Preview windows: " << num_windows << endl;
+    cout << "Footsteps (without streaming): " << full_wmg.getNumFootsteps() << endl;
+    cout << "Max. footsteps (streaming): " << max_stream_fs << endl;
+    cout << "Number of differences: " << num_diff << endl;
+
+    return (((num_diff == 0) && (num_windows > 0) && (4 * max_stream_fs < full_wmg.getNumFootsteps())) ? 0 : 1);
+}
+///@}
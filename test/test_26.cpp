@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @author agent
+ * @brief Saves a footstep plan to a binary file, loads it and compares the
+ *  preview windows obtained with the original and the loaded plans. The
+ *  plan is saved during a walk, loading must restart the walk and detach
+ *  the queue of footsteps.
+ */
+
+
+#include <cstdio> // remove
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/**
+ * @brief Counts the elements, which differ in two arrays.
+ *
+ * @param[in] a the first array
+ * @param[in] b the second array
+ * @param[in] size size of the arrays
+ */
+unsigned int count_diff (const double *a, const double *b, const unsigned int size)
+{
+    unsigned int num = 0;
+    for (unsigned int i = 0; i < size; ++i)
+    {
+        if ((a[i] < b[i]) || (a[i] > b[i]))
+        {
+            ++num;
+        }
+    }
+    return (num);
+}
+
+
+int main(int argc, char **argv)
+{
+    const string plan_filename = "test_26_plan.bin";
+    init_10 orig_test("");
+    init_10 load_test("");
+    init_10 walk_test("");
+
+    unsigned int num_diff = 0;
+    unsigned int num_windows = 0;
+
+    // an invalid file must be rejected without changes of the plan
+    orig_test.wmg->FS2file(plan_filename);
+    if (load_test.wmg->loadPlan(plan_filename)
+            || (load_test.wmg->getNumFootsteps() != orig_test.wmg->getNumFootsteps()))
+    {
+        ++num_diff;
+    }
+
+    // the plan is saved during a walk
+    for (int i = 0; i < 50; ++i)
+    {
+        walk_test.wmg->formPreviewWindow(*walk_test.par);
+    }
+
+    // the loaded plan replaces the existing footsteps
+    footstepQueue queue(4);
+    load_test.wmg->footstep_queue = &queue;
+    load_test.wmg->addFootstep(0.0, 0.0, 0.0);
+    if (!walk_test.wmg->savePlan(plan_filename)
+            || !load_test.wmg->loadPlan(plan_filename)
+            || (load_test.wmg->getNumFootsteps() != orig_test.wmg->getNumFootsteps())
+            || (load_test.wmg->footstep_queue != NULL))
+    {
+        ++num_diff;
+    }
+    remove (plan_filename.c_str());
+
+
+    const unsigned int N = orig_test.wmg->N;
+    for(;;)
+    {
+        //------------------------------------------------------
+        WMGret orig_ret = orig_test.wmg->formPreviewWindow(*orig_test.par);
+        WMGret load_ret = load_test.wmg->formPreviewWindow(*load_test.par);
+        if (orig_ret != load_ret)
+        {
+            ++num_diff;
+        }
+        if ((orig_ret == WMG_HALT) || (load_ret == WMG_HALT))
+        {
+            break;
+        }
+        ++num_windows;
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        smpc_parameters *p = orig_test.par;
+        smpc_parameters *q = load_test.par;
+
+        num_diff += count_diff (p->T, q->T, N);
+        num_diff += count_diff (p->angle, q->angle, N);
+        num_diff += count_diff (p->fp_x, q->fp_x, N);
+        num_diff += count_diff (p->fp_y, q->fp_y, N);
+        num_diff += count_diff (p->zref_x, q->zref_x, N);
+        num_diff += count_diff (p->zref_y, q->zref_y, N);
+        num_diff += count_diff (p->lb, q->lb, 2*N);
+        num_diff += count_diff (p->ub, q->ub, 2*N);
+        //------------------------------------------------------
+    }
+
+    cout << "Preview windows: " << num_windows << endl;
+    cout << "Number of differences: " << num_diff << endl;
+
+    return (((num_diff == 0) && (num_windows > 0)) ? 0 : 1);
+}
+///@}
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @author agent
+ * @brief Checks that WMG::repositionFootsteps() translates the footsteps in
+ *  the preview windows.
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+int main(int argc, char **argv)
+{
+    init_10 orig_test("");
+    init_10 repos_test("");
+
+    const unsigned int N = orig_test.wmg->N;
+
+    // the offsets, which can be observed after each repositioning
+    const unsigned int num_offsets = 3;
+    const unsigned int repos_window[num_offsets - 1] = {20, 45};
+    const double diff_x[num_offsets - 1] = {0.01, -0.03};
+    const double diff_y[num_offsets - 1] = {0.02, 0.005};
+    double offset_x[num_offsets] = {0.0, 0.0, 0.0};
+    double offset_y[num_offsets] = {0.0, 0.0, 0.0};
+    unsigned int num_repos = 0;
+
+    double max_err = 0.0;
+    unsigned int num_windows = 0;
+    bool moved = false;
+
+    for(;;)
+    {
+        //------------------------------------------------------
+        if ((num_repos < num_offsets - 1) && (num_windows == repos_window[num_repos]))
+        {
+            repos_test.wmg->repositionFootsteps (diff_x[num_repos], diff_y[num_repos]);
+            offset_x[num_repos + 1] = offset_x[num_repos] + diff_x[num_repos];
+            offset_y[num_repos + 1] = offset_y[num_repos] + diff_y[num_repos];
+            ++num_repos;
+        }
+
+        WMGret orig_ret = orig_test.wmg->formPreviewWindow(*orig_test.par);
+        WMGret repos_ret = repos_test.wmg->formPreviewWindow(*repos_test.par);
+        if (orig_ret != repos_ret)
+        {
+            max_err = 1.0;
+        }
+        if ((orig_ret == WMG_HALT) || (repos_ret == WMG_HALT))
+        {
+            break;
+        }
+        ++num_windows;
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        // each element must be translated by one of the offsets
+        smpc_parameters *p = orig_test.par;
+        smpc_parameters *q = repos_test.par;
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            double err = 1.0;
+            for (unsigned int j = 0; j <= num_repos; ++j)
+            {
+                const double dx = q->fp_x[i] - p->fp_x[i] - offset_x[j];
+                const double dy = q->fp_y[i] - p->fp_y[i] - offset_y[j];
+                const double e = fabs(dx) + fabs(dy);
+                if (e < err)
+                {
+                    err = e;
+                }
+            }
+            if (fabs(q->fp_x[i] - p->fp_x[i]) > 1e-3)
+            {
+                moved = true;
+            }
+
+            // the reference points are not moved, the sizes of the
+            // support polygons are not changed
+            err += fabs(q->zref_x[i] - p->zref_x[i]) + fabs(q->zref_y[i] - p->zref_y[i]);
+            for (unsigned int j = 2*i; j < 2*i + 2; ++j)
+            {
+                err += fabs((q->ub[j] - q->lb[j]) - (p->ub[j] - p->lb[j]));
+            }
+
+            if (err > max_err)
+            {
+                max_err = err;
+            }
+        }
+        //------------------------------------------------------
+    }
+
+    cout << "Preview windows: " << num_windows << endl;
+    cout << "Max. error: " << max_err << endl;
+
+    return (((max_err < 1e-12) && moved && (num_windows > repos_window[num_offsets - 2])) ? 0 : 1);
+}
+///@}
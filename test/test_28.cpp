@@ -0,0 +1,161 @@
+/**
+ * @file
+ * @author agent
+ * @brief Compares the preview windows and positions of feet obtained with
+ *  the footsteps added one by one and using WMG::addFootsteps().
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/**
+ * @brief Builds a step.
+ */
+footstepQueue::request make_step (
+        const double x_relative,
+        const double y_relative,
+        const double angle_relative,
+        const fs_type type,
+        const unsigned int def_time_ms,
+        const unsigned int ds_time_ms,
+        const unsigned int ds_number)
+{
+    footstepQueue::request step;
+
+    step.x_relative = x_relative;
+    step.y_relative = y_relative;
+    step.angle_relative = angle_relative;
+    step.type = type;
+    step.def_time_ms = def_time_ms;
+    step.ds_time_ms = ds_time_ms;
+    step.ds_number = ds_number;
+    step.use_user_constraints = false;
+
+    return (step);
+}
+
+
+int main(int argc, char **argv)
+{
+    const unsigned int N = 40;
+    const unsigned int preview_sampling_time_ms = 40;
+    const unsigned int num_steps = 2500;
+
+    WMG seq_wmg (N, preview_sampling_time_ms, 0.02);
+    WMG bulk_wmg (N, preview_sampling_time_ms, 0.02);
+    smpc_parameters seq_par (N, 0.252007);
+    smpc_parameters bulk_par (N, 0.252007);
+
+
+    // a walk along a wavy line, long enough to be scanned in several blocks
+    const double step_x = 0.04;
+    const double step_y = seq_wmg.def_constraints.support_distance_y;
+    vector<footstepQueue::request> plan;
+
+    plan.push_back (make_step (0.0, -step_y/2, 0.0, FS_TYPE_SS_R, 0, 0, 0));
+    plan.push_back (make_step (0.0, step_y/2, 0.0, FS_TYPE_DS, 1200, 0, 0));
+    plan.push_back (make_step (0.0, step_y/2, 0.0, FS_TYPE_AUTO, 400, 0, 0));
+    for (unsigned int i = 0; i < num_steps; ++i)
+    {
+        plan.push_back (make_step (
+                    step_x,
+                    (i % 2 == 0) ? -step_y : step_y,
+                    0.05 * sin(i * 0.01),
+                    FS_TYPE_AUTO,
+                    400,
+                    40,
+                    1 + i % 3));
+    }
+    plan.push_back (make_step (0.0, step_y/2, 0.0, FS_TYPE_DS, 2000, 0, 0));
+    plan.push_back (make_step (0.0, step_y/2, 0.0, FS_TYPE_SS_L, 0, 0, 0));
+
+    for (unsigned int i = 0; i < plan.size(); ++i)
+    {
+        seq_wmg.setFootstepParametersMS (plan[i].def_time_ms, plan[i].ds_time_ms, plan[i].ds_number);
+        seq_wmg.addFootstep (plan[i].x_relative, plan[i].y_relative, plan[i].angle_relative, plan[i].type);
+    }
+    // the first two steps are added separately
+    bulk_wmg.addFootsteps (2, &plan[0]);
+    bulk_wmg.addFootsteps (plan.size() - 2, &plan[2]);
+
+
+    double max_err = 0.0;
+    unsigned int num_windows = 0;
+    bool same_time = (seq_wmg.getNumFootsteps() == bulk_wmg.getNumFootsteps());
+
+    for(;;)
+    {
+        //------------------------------------------------------
+        WMGret seq_ret = seq_wmg.formPreviewWindow(seq_par);
+        WMGret bulk_ret = bulk_wmg.formPreviewWindow(bulk_par);
+        if (seq_ret != bulk_ret)
+        {
+            same_time = false;
+        }
+        if ((seq_ret == WMG_HALT) || (bulk_ret == WMG_HALT))
+        {
+            break;
+        }
+        ++num_windows;
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        for (unsigned int i = 0; i < N; ++i)
+        {
+            if ((seq_par.T[i] < bulk_par.T[i]) || (seq_par.T[i] > bulk_par.T[i]))
+            {
+                same_time = false;
+            }
+
+            double err[8] = {
+                seq_par.angle[i] - bulk_par.angle[i],
+                seq_par.fp_x[i] - bulk_par.fp_x[i],
+                seq_par.fp_y[i] - bulk_par.fp_y[i],
+                seq_par.zref_x[i] - bulk_par.zref_x[i],
+                seq_par.zref_y[i] - bulk_par.zref_y[i],
+                seq_par.lb[2*i] - bulk_par.lb[2*i],
+                seq_par.ub[2*i + 1] - bulk_par.ub[2*i + 1],
+                seq_par.ub[2*i] - bulk_par.ub[2*i]};
+
+            for (int j = 0; j < 8; ++j)
+            {
+                if (fabs(err[j]) > max_err)
+                {
+                    max_err = fabs(err[j]);
+                }
+            }
+        }
+
+        // the positions of feet are undefined in the last supports
+        if (num_windows < num_steps * 10)
+        {
+            double seq_left[16], seq_right[16];
+            double bulk_left[16], bulk_right[16];
+            seq_wmg.getFeetPositions (preview_sampling_time_ms, seq_left, seq_right);
+            bulk_wmg.getFeetPositions (preview_sampling_time_ms, bulk_left, bulk_right);
+            for (int i = 0; i < 16; ++i)
+            {
+                if (fabs(seq_left[i] - bulk_left[i]) > max_err)
+                {
+                    max_err = fabs(seq_left[i] - bulk_left[i]);
+                }
+                if (fabs(seq_right[i] - bulk_right[i]) > max_err)
+                {
+                    max_err = fabs(seq_right[i] - bulk_right[i]);
+                }
+            }
+        }
+        //------------------------------------------------------
+    }
+
+    cout << "Footsteps: " << bulk_wmg.getNumFootsteps() << endl;
+    cout << "Preview windows: " << num_windows << endl;
+    cout << "Max. error: " << max_err << endl;
+
+    return ((same_time && (num_windows > num_steps * 10) && (max_err < 1e-9)) ? 0 : 1);
+}
+///@}
@@ -0,0 +1,138 @@
+/**
+ * @file
+ * @author agent
+ * @brief Checks the durations of the phases of the solvers (smpc::solve_stats):
+ *  the numbers of calls must agree with the iteration counters, the nested
+ *  phases must not take longer than the solution. If the library is built
+ *  without the phase timers, the statistics must be empty.
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/**
+ * @brief Checks the statistics after a solution.
+ *
+ * @param[in] stats statistics
+ * @param[in] nested the phases nested in SMPC_PHASE_SOLVE
+ * @param[in] num_nested the number of nested phases
+ *
+ * @return false if the statistics are not consistent.
+ */
+bool check_stats (
+        const smpc::solve_stats &stats,
+        const smpc::solverPhase *nested,
+        const unsigned int num_nested)
+{
+    if (!smpc::phase_timers_enabled())
+    {
+        for (int i = 0; i < smpc::SMPC_PHASE_NUM; ++i)
+        {
+            if ((stats.calls[i] != 0) || (stats.time_ns[i] > 0.0))
+            {
+                return (false);
+            }
+        }
+        return (true);
+    }
+
+    if ((stats.calls[smpc::SMPC_PHASE_SET_PARAMETERS] != 1)
+            || (stats.calls[smpc::SMPC_PHASE_FORM_INIT_FP] != 1)
+            || (stats.calls[smpc::SMPC_PHASE_SOLVE] != 1))
+    {
+        return (false);
+    }
+
+    double nested_ns = 0.0;
+    for (unsigned int i = 0; i < num_nested; ++i)
+    {
+        nested_ns += stats.time_ns[nested[i]];
+    }
+    return (nested_ns <= stats.time_ns[smpc::SMPC_PHASE_SOLVE]);
+}
+
+
+int main(int argc, char **argv)
+{
+    init_10 as_test("");
+    init_10 ip_test("");
+
+    smpc::solver_as AS_solver (as_test.wmg->N);
+    smpc::solver_ip IP_solver (ip_test.wmg->N);
+
+    const smpc::solverPhase as_nested[] = {
+        smpc::SMPC_PHASE_INIT_SOLVE,
+        smpc::SMPC_PHASE_UP_RESOLVE,
+        smpc::SMPC_PHASE_DOWN_RESOLVE,
+        smpc::SMPC_PHASE_CHECK_CONSTRAINTS};
+    const smpc::solverPhase ip_nested[] = {
+        smpc::SMPC_PHASE_NEWTON_STEP,
+        smpc::SMPC_PHASE_LINE_SEARCH};
+
+    bool result = true;
+    unsigned int num_windows = 0;
+
+    for(;;)
+    {
+        //------------------------------------------------------
+        if ((as_test.wmg->formPreviewWindow(*as_test.par) == WMG_HALT)
+                || (ip_test.wmg->formPreviewWindow(*ip_test.par) == WMG_HALT))
+        {
+            break;
+        }
+        ++num_windows;
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        smpc_parameters *par = as_test.par;
+        AS_solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        AS_solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        AS_solver.solve();
+        AS_solver.get_next_state(par->init_state);
+
+        par = ip_test.par;
+        IP_solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        IP_solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        IP_solver.solve();
+        IP_solver.get_next_state(par->init_state);
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        const smpc::solve_stats &as_stats = AS_solver.stats;
+        const smpc::solve_stats &ip_stats = IP_solver.stats;
+
+        result = result
+            && check_stats (as_stats, as_nested, sizeof(as_nested)/sizeof(as_nested[0]))
+            && check_stats (ip_stats, ip_nested, sizeof(ip_nested)/sizeof(ip_nested[0]));
+
+        if (smpc::phase_timers_enabled())
+        {
+            // the last added constraint may be not resolved
+            result = result
+                && (as_stats.calls[smpc::SMPC_PHASE_INIT_SOLVE] == 1)
+                && (as_stats.calls[smpc::SMPC_PHASE_UP_RESOLVE] <= AS_solver.added_constraints_num)
+                && (as_stats.calls[smpc::SMPC_PHASE_UP_RESOLVE] + 1 >= AS_solver.added_constraints_num)
+                && (as_stats.calls[smpc::SMPC_PHASE_DOWN_RESOLVE] == AS_solver.removed_constraints_num)
+                && (ip_stats.calls[smpc::SMPC_PHASE_NEWTON_STEP] == IP_solver.int_loop_iterations)
+                && (ip_stats.calls[smpc::SMPC_PHASE_ECL_FORM] == IP_solver.int_loop_iterations);
+        }
+        //------------------------------------------------------
+    }
+
+    cout << "Phase timers: " << (smpc::phase_timers_enabled() ? "enabled" : "disabled") << endl;
+    cout << "Preview windows: " << num_windows << endl;
+    for (int i = 0; i < smpc::SMPC_PHASE_NUM; ++i)
+    {
+        cout << smpc::solve_stats::get_phase_name (static_cast<smpc::solverPhase>(i))
+             << ": AS " << AS_solver.stats.time_ns[i] << " ns (" << AS_solver.stats.calls[i] << ")"
+             << ", IP " << IP_solver.stats.time_ns[i] << " ns (" << IP_solver.stats.calls[i] << ")" << endl;
+    }
+
+    return ((result && (num_windows > 0)) ? 0 : 1);
+}
+///@}
@@ -0,0 +1,100 @@
+/**
+ * @file
+ * @author agent
+ * @brief Records the problems of a simulation (smpc::problem_recorder), replays
+ *  them from the log (smpc::problem_log) and checks, that the solutions are
+ *  identical. The buffers are flushed less often than they get full, so
+ *  that both the solver and flush() write them.
+ */
+
+
+#include <cstring> // memcmp
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+int main(int argc, char **argv)
+{
+    const char *log_filename = "test_30.log";
+
+    init_01 test_30 ("");
+    const int N = test_30.wmg->N;
+    const unsigned int num_var = SMPC_NUM_VAR * N;
+
+
+    //-----------------------------------------------------------
+    // record
+    //-----------------------------------------------------------
+    // a small buffer to check flushing
+    smpc::problem_recorder recorder (N, 4);
+    if (!recorder.open (log_filename))
+    {
+        return (1);
+    }
+
+    smpc::solver_as solver (N);
+    solver.set_recorder (&recorder);
+
+    vector<double> solutions;
+    for(;;)
+    {
+        if (test_30.wmg->formPreviewWindow(*test_30.par) == WMG_HALT)
+        {
+            break;
+        }
+
+        smpc_parameters *par = test_30.par;
+        solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        solver.solve();
+        solver.get_next_state(par->init_state);
+
+        solutions.insert (solutions.end(), par->X, par->X + num_var);
+
+        // normally called from another thread
+        if ((solutions.size() / num_var) % 8 == 0)
+        {
+            if (!recorder.flush())
+            {
+                return (1);
+            }
+        }
+    }
+    const unsigned int num_windows = solutions.size() / num_var;
+
+    if (!recorder.close())
+    {
+        return (1);
+    }
+
+
+    //-----------------------------------------------------------
+    // replay
+    //-----------------------------------------------------------
+    smpc::problem_log log;
+    if (!log.open (log_filename))
+    {
+        return (1);
+    }
+
+    smpc::solver_as replay_solver (log.N);
+    vector<double> X (num_var);
+    bool result = (log.N == N) && (log.size == num_windows) && (recorder.num_records == num_windows)
+        && (recorder.num_dropped == 0);
+
+    for (unsigned int i = 0; result && (i < log.size); ++i)
+    {
+        log.replay (i, replay_solver, &X[0]);
+        replay_solver.solve();
+
+        result = (memcmp (&X[0], &solutions[i * num_var], num_var * sizeof(double)) == 0);
+    }
+    cout << "Preview windows: " << num_windows << ", replayed: " << log.size << endl;
+    log.close();
+
+    cout << (result ? "Solutions are identical." : "Solutions differ.") << endl;
+
+    return ((result && (num_windows > 0)) ? 0 : 1);
+}
+///@}
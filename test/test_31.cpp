@@ -0,0 +1,126 @@
+/**
+ * @file
+ * @author agent
+ * @brief Checks tracing of the iterations of the solvers (smpc::trace_buffer):
+ *  the numbers of events must agree with the iteration counters. If the
+ *  library is built without tracing, the trace must be empty.
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+int main(int argc, char **argv)
+{
+    bool result = true;
+
+
+    //-----------------------------------------------------------
+    // the ring buffer keeps the newest events
+    //-----------------------------------------------------------
+    smpc::trace_buffer ring (3);
+    for (unsigned int i = 0; i < 5; ++i)
+    {
+        smpc::trace_event event;
+        event.start_ns = i;
+        event.duration_ns = 0.0;
+        event.value = 0.0;
+        event.index = i;
+        event.solver_id = 0;
+        event.type = smpc::SMPC_TRACE_SOLVE;
+        ring.add (event);
+    }
+    result = (ring.size() == 3) && (ring.num_added == 5)
+        && (ring.get(0).index == 2) && (ring.get(2).index == 4);
+
+
+    //-----------------------------------------------------------
+    // trace the solvers
+    //-----------------------------------------------------------
+    init_10 as_test("");
+    init_10 ip_test("");
+
+    smpc::solver_as AS_solver (as_test.wmg->N);
+    smpc::solver_ip IP_solver (ip_test.wmg->N);
+
+    smpc::trace_buffer trace (200000);
+    AS_solver.set_trace (&trace, 0);
+    IP_solver.set_trace (&trace, 1);
+
+    unsigned int num_windows = 0;
+    unsigned int counters[smpc::SMPC_TRACE_EVENT_NUM] = {0, 0, 0, 0, 0, 0};
+    for(;;)
+    {
+        if ((as_test.wmg->formPreviewWindow(*as_test.par) == WMG_HALT)
+                || (ip_test.wmg->formPreviewWindow(*ip_test.par) == WMG_HALT))
+        {
+            break;
+        }
+        ++num_windows;
+
+
+        smpc_parameters *par = as_test.par;
+        AS_solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        AS_solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        AS_solver.solve();
+        AS_solver.get_next_state(par->init_state);
+
+        par = ip_test.par;
+        IP_solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        IP_solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        IP_solver.solve();
+        IP_solver.get_next_state(par->init_state);
+
+
+        counters[smpc::SMPC_TRACE_SOLVE] += 2;
+        counters[smpc::SMPC_TRACE_ADD_CONSTRAINT] += AS_solver.added_constraints_num;
+        counters[smpc::SMPC_TRACE_REMOVE_CONSTRAINT] += AS_solver.removed_constraints_num;
+        counters[smpc::SMPC_TRACE_IP_OUTER] += IP_solver.ext_loop_iterations;
+        counters[smpc::SMPC_TRACE_IP_INNER] += IP_solver.int_loop_iterations;
+        counters[smpc::SMPC_TRACE_IP_BS] += IP_solver.bt_search_iterations;
+    }
+
+
+    if (smpc::tracing_enabled())
+    {
+        unsigned int events[smpc::SMPC_TRACE_EVENT_NUM] = {0, 0, 0, 0, 0, 0};
+        for (unsigned int i = 0; i < trace.size(); ++i)
+        {
+            const smpc::trace_event &event = trace.get(i);
+            ++events[event.type];
+
+            // instant events have no duration
+            result = result && (!smpc::trace_buffer::is_instant (event.type) || !(event.duration_ns > 0.0));
+
+            // events of the active set solver have id 0
+            if (event.type != smpc::SMPC_TRACE_SOLVE)
+            {
+                result = result && ((event.solver_id == 0) == (event.type <= smpc::SMPC_TRACE_REMOVE_CONSTRAINT));
+            }
+        }
+
+        for (int i = 0; i < smpc::SMPC_TRACE_EVENT_NUM; ++i)
+        {
+            cout << smpc::trace_buffer::get_event_name (static_cast<smpc::traceEventType> (i))
+                 << ": " << events[i] << " (expected " << counters[i] << ")" << endl;
+            result = result && (events[i] == counters[i]);
+        }
+
+        result = result
+            && (trace.num_added == trace.size())
+            && trace.write_chrome_json ("test_31.json");
+    }
+    else
+    {
+        cout << "Tracing is disabled." << endl;
+        result = result && (trace.size() == 0);
+    }
+
+    cout << "Preview windows: " << num_windows << endl;
+    cout << (result ? "Trace is consistent." : "Trace is not consistent.") << endl;
+
+    return ((result && (num_windows > 0)) ? 0 : 1);
+}
+///@}
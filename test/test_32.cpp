@@ -0,0 +1,165 @@
+/**
+ * @file
+ * @author agent
+ * @brief Checks the iteration callbacks (smpc::iteration_callback): the
+ *  numbers of calls must agree with the iteration counters and the solvers
+ *  must stop, when requested by the callback. If the library is built
+ *  without the callbacks, they must not be called.
+ */
+
+
+#include "tests_common.h"
+
+///@addtogroup gTEST
+///@{
+
+/// Data of #count_iterations.
+class iteration_counter
+{
+    public:
+        iteration_counter (const unsigned int stop_after_)
+        {
+            stop_after = stop_after_;
+            reset();
+        }
+
+        void reset()
+        {
+            calls = 0;
+            consistent = true;
+        }
+
+        /// Stop the solver after this number of iterations, 0 to never stop.
+        unsigned int stop_after;
+        /// The number of calls since #reset.
+        unsigned int calls;
+        /// false if the records are not consistent.
+        bool consistent;
+};
+
+
+/**
+ * @brief Counts the iterations, see smpc#iteration_callback.
+ */
+bool count_iterations (const smpc::iteration_record &record, void *data)
+{
+    iteration_counter *counter = static_cast<iteration_counter *> (data);
+
+    ++counter->calls;
+    counter->consistent = counter->consistent
+        && (record.alpha > 0.0)
+        && !(record.alpha > 1.0)
+        && !(record.decrement < 0.0)
+        && !(record.kappa < 0.0);
+
+    return ((counter->stop_after == 0) || (counter->calls < counter->stop_after));
+}
+
+
+int main(int argc, char **argv)
+{
+    init_10 as_test("");
+    init_10 ip_test("");
+    init_10 as_stop_test("");
+    init_10 ip_stop_test("");
+
+    smpc::solver_as AS_solver (as_test.wmg->N);
+    smpc::solver_ip IP_solver (ip_test.wmg->N);
+    smpc::solver_as AS_stop_solver (as_stop_test.wmg->N);
+    smpc::solver_ip IP_stop_solver (ip_stop_test.wmg->N);
+
+    iteration_counter as_counter (0);
+    iteration_counter ip_counter (0);
+    iteration_counter as_stop_counter (1);
+    iteration_counter ip_stop_counter (1);
+
+    AS_solver.set_iteration_callback (count_iterations, &as_counter);
+    IP_solver.set_iteration_callback (count_iterations, &ip_counter);
+    AS_stop_solver.set_iteration_callback (count_iterations, &as_stop_counter);
+    IP_stop_solver.set_iteration_callback (count_iterations, &ip_stop_counter);
+
+    const bool enabled = smpc::iteration_callbacks_enabled();
+    bool result = true;
+    unsigned int num_windows = 0;
+
+    for(;;)
+    {
+        //------------------------------------------------------
+        if ((as_test.wmg->formPreviewWindow(*as_test.par) == WMG_HALT)
+                || (ip_test.wmg->formPreviewWindow(*ip_test.par) == WMG_HALT)
+                || (as_stop_test.wmg->formPreviewWindow(*as_stop_test.par) == WMG_HALT)
+                || (ip_stop_test.wmg->formPreviewWindow(*ip_stop_test.par) == WMG_HALT))
+        {
+            break;
+        }
+        ++num_windows;
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        as_counter.reset();
+        ip_counter.reset();
+        as_stop_counter.reset();
+        ip_stop_counter.reset();
+
+        smpc_parameters *par = as_test.par;
+        AS_solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        AS_solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        AS_solver.solve();
+        AS_solver.get_next_state(par->init_state);
+
+        par = ip_test.par;
+        IP_solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        IP_solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        IP_solver.solve();
+        IP_solver.get_next_state(par->init_state);
+
+        par = as_stop_test.par;
+        AS_stop_solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        AS_stop_solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        AS_stop_solver.solve();
+        AS_stop_solver.get_next_state(par->init_state);
+
+        par = ip_stop_test.par;
+        IP_stop_solver.set_parameters (par->T, par->h, par->h0, par->angle, par->zref_x, par->zref_y, par->lb, par->ub);
+        IP_stop_solver.form_init_fp (par->fp_x, par->fp_y, par->init_state, par->X);
+        IP_stop_solver.solve();
+        IP_stop_solver.get_next_state(par->init_state);
+        //------------------------------------------------------
+
+
+        //------------------------------------------------------
+        if (enabled)
+        {
+            // AS: the last iteration does not change the active set,
+            // IP: the last internal iteration of each external iteration
+            // makes no step, the callback is called only after a step, hence
+            // the stopped solver makes no more than one step.
+            result = result
+                && as_counter.consistent
+                && ip_counter.consistent
+                && (as_counter.calls == AS_solver.added_constraints_num + AS_solver.removed_constraints_num + 1)
+                && (ip_counter.calls == IP_solver.int_loop_iterations - IP_solver.ext_loop_iterations)
+                && (as_stop_counter.calls == 1)
+                && (AS_stop_solver.added_constraints_num + AS_stop_solver.removed_constraints_num <= 1)
+                && (ip_stop_counter.calls <= 1)
+                && (IP_stop_solver.int_loop_iterations == IP_stop_solver.ext_loop_iterations);
+        }
+        else
+        {
+            result = result
+                && (as_counter.calls == 0)
+                && (ip_counter.calls == 0)
+                && (as_stop_counter.calls == 0)
+                && (ip_stop_counter.calls == 0);
+        }
+        //------------------------------------------------------
+    }
+
+    cout << "Iteration callbacks are " << (enabled ? "enabled" : "disabled") << endl;
+    cout << "Preview windows: " << num_windows << endl;
+    cout << (result ? "Callbacks are consistent." : "Callbacks are not consistent.") << endl;
+
+    return ((result && (num_windows > 0)) ? 0 : 1);
+}
+///@}
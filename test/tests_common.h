@@ -29,7 +29,7 @@ class test_init_base
                 fs_out_filename = name + "_fs.m";
             }
         }
-        ~test_init_base()
+        virtual ~test_init_base()
         {
             if (!name.empty())
             {
@@ -54,10 +54,10 @@ class test_init_base
 class init_01 : public test_init_base
 {
     public:
-        init_01 (const string & test_name, const bool plot_ds_ = true) : 
+        init_01 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 15) : 
             test_init_base (test_name, plot_ds_)
         {
-            wmg = new WMG (15, 100);
+            wmg = new WMG (N, 100);
             par = new smpc_parameters (wmg->N, 0.261);
 
 
@@ -103,10 +103,10 @@ class init_01 : public test_init_base
 class init_02 : public test_init_base
 {
     public:
-        init_02 (const string & test_name, const bool plot_ds_ = true) : 
+        init_02 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 15) : 
             test_init_base (test_name, plot_ds_)
         {
-            wmg = new WMG (15, 100);
+            wmg = new WMG (N, 100);
             par = new smpc_parameters (wmg->N, 0.261);
 
 
@@ -156,10 +156,10 @@ class init_02 : public test_init_base
 class init_03 : public test_init_base
 {
     public:
-        init_03 (const string & test_name, const bool plot_ds_ = true) : 
+        init_03 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 15) : 
             test_init_base (test_name, plot_ds_)
         {
-            wmg = new WMG (15, 100);
+            wmg = new WMG (N, 100);
             par = new smpc_parameters (wmg->N, 0.261);
 
             // each step is defined relatively to the previous step
@@ -215,10 +215,10 @@ class init_03 : public test_init_base
 class init_04 : public test_init_base
 {
     public:
-        init_04 (const string & test_name, const bool plot_ds_ = true) : 
+        init_04 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 15) : 
             test_init_base (test_name, plot_ds_)
         {
-            wmg = new WMG (15, 100);
+            wmg = new WMG (N, 100);
             par = new smpc_parameters (wmg->N, 0.261);
 
             // each step is defined relatively to the previous step
@@ -265,10 +265,10 @@ class init_04 : public test_init_base
 class init_05 : public test_init_base
 {
     public:
-        init_05 (const string & test_name, const bool plot_ds_ = true) : 
+        init_05 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 15) : 
             test_init_base (test_name, plot_ds_)
         {
-            wmg = new WMG (15, 100);
+            wmg = new WMG (N, 100);
             par = new smpc_parameters (wmg->N, 0.261);
 
 
@@ -326,10 +326,10 @@ class init_05 : public test_init_base
 class init_06 : public test_init_base
 {
     public:
-        init_06 (const string & test_name, const bool plot_ds_ = true) : 
+        init_06 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 15) : 
             test_init_base (test_name, plot_ds_)
         {
-            wmg = new WMG (15, 100);
+            wmg = new WMG (N, 100);
             par = new smpc_parameters (wmg->N, 0.261);
 
 
@@ -387,10 +387,10 @@ class init_06 : public test_init_base
 class init_07 : public test_init_base
 {
     public:
-        init_07 (const string & test_name, const bool plot_ds_ = true) : 
+        init_07 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 40) : 
             test_init_base (test_name, plot_ds_)
         {
-            wmg = new WMG (40, 40, 0.015);
+            wmg = new WMG (N, 40, 0.015);
             par = new smpc_parameters (wmg->N, 0.261);
 
             // each step is defined relatively to the previous step
@@ -444,10 +444,10 @@ class init_07 : public test_init_base
 class init_08 : public test_init_base
 {
     public:
-        init_08 (const string & test_name, const bool plot_ds_ = true) : 
+        init_08 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 25) : 
             test_init_base (test_name, plot_ds_)
         {
-            wmg = new WMG (25, 60, 0.02);
+            wmg = new WMG (N, 60, 0.02);
             par = new smpc_parameters (wmg->N, 0.261);
             int ss_time_ms = 420;
             int ds_time_ms = 60;
@@ -505,11 +505,11 @@ class init_08 : public test_init_base
 class init_09 : public test_init_base
 {
     public:
-        init_09 (const string & test_name, const bool plot_ds_ = true) : 
+        init_09 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 40) : 
             test_init_base (test_name, plot_ds_)
         {
             wmg = new WMG (
-                    40, 
+                    N, 
                     40, 
                     0.015,
                     1.0,
@@ -571,11 +571,11 @@ class init_09 : public test_init_base
 class init_10 : public test_init_base
 {
     public:
-        init_10 (const string & test_name, const bool plot_ds_ = true) : 
+        init_10 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 40) : 
             test_init_base (test_name, plot_ds_)
         {
             int preview_sampling_time_ms = 40;
-            wmg = new WMG (40, preview_sampling_time_ms, 0.02);
+            wmg = new WMG (N, preview_sampling_time_ms, 0.02);
             par = new smpc_parameters (wmg->N, 0.252007);
             int ss_time_ms = 400;
             int ds_time_ms = 40;
@@ -631,11 +631,11 @@ class init_10 : public test_init_base
 class init_11 : public test_init_base
 {
     public:
-        init_11 (const string & test_name, const bool plot_ds_ = true) : 
+        init_11 (const string & test_name, const bool plot_ds_ = true, const unsigned int N = 40) : 
             test_init_base (test_name, plot_ds_)
         {
             int preview_sampling_time_ms = 40;
-            wmg = new WMG (40, preview_sampling_time_ms, 0.02);
+            wmg = new WMG (N, preview_sampling_time_ms, 0.02);
             par = new smpc_parameters (wmg->N, 0.252007);
             int ss_time_ms = 400;
             int ds_time_ms = 40;